@@ -72,9 +72,11 @@
 
 #include <SPI.h>
 #include <Ethernet.h>
+#include <EthernetUdp.h>
 
 #include "arduino_pixel_server.h"
 #include "led_strip/led_strip_neopixel.h"
+#include "storage/storage_eeprom.h"
 
 using namespace arduino_pixel;
 
@@ -84,6 +86,8 @@ using namespace arduino_pixel;
 static byte mac[] = {0x90, 0xA2, 0xDA, 0x0D, 0xAF, 0xF6};
 static IPAddress ip(192, 168, 1, 10);
 const int port = 80;
+const int stream_port = 7777;  // UDP port of the frame stream and the clock
+const bool clock_leader = false;  // Whether to send the group time
 const int num_leds = 112;
 const int strip_pin = 7;
 // ================================================================== end =====
@@ -93,6 +97,7 @@ class ArduinoPixel : public ArduinoPixelServer {
  public:
   ArduinoPixel()
       : strip_neopixel_(num_leds, strip_pin, NEO_GRB + NEO_KHZ800),
+        state_store_(eeprom_),
         server_(port) {}
 
   virtual ~ArduinoPixel() {}
@@ -101,20 +106,30 @@ class ArduinoPixel : public ArduinoPixelServer {
 
   void init() {
     strip_neopixel_.init();
-    init(&strip_neopixel_);
+    eeprom_.init();
+    // Restores the last state
+    init(&strip_neopixel_, &state_store_, &events_, &previews_);
     Ethernet.begin(mac, ip);
     server_.begin();
+    udp_.begin(stream_port);
+    if (clock_leader) leadClock(IPAddress(255, 255, 255, 255), stream_port);
   }
 
   void check() {
     EthernetClient client = server_.available();
     if (client) processRequest(client);
-    strip_neopixel_.colorize();
+    processPacket(udp_);
+    colorize();
   }
 
  private:
   led_strip::LedStripNeoPixel strip_neopixel_;
+  storage::StorageEeprom eeprom_;
+  StateStore state_store_;
   EthernetServer server_;
+  EthernetUDP udp_;
+  EventSource<EthernetClient, 2> events_;  // Subscribers of the state changes
+  FramePreview<EthernetClient, 1> previews_;  // Subscribers of the frames
 };
 
 ArduinoPixel pixel;
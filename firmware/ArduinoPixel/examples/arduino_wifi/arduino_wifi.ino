@@ -73,9 +73,11 @@
 
 #include <SPI.h>
 #include <WiFi.h>
+#include <WiFiUdp.h>
 
 #include "arduino_pixel_server.h"
 #include "led_strip/led_strip_neopixel.h"
+#include "storage/storage_eeprom.h"
 
 using namespace arduino_pixel;
 
@@ -86,6 +88,8 @@ char ssid[] = "<ssid>";
 char pass[] = "<password>";
 static IPAddress ip(192, 168, 1, 10);
 const int port = 80;
+const int stream_port = 7777;  // UDP port of the frame stream and the clock
+const bool clock_leader = false;  // Whether to send the group time
 const int num_leds = 112;
 const int strip_pin = 7;
 // ================================================================== end =====
@@ -95,6 +99,7 @@ class ArduinoPixel : public ArduinoPixelServer {
  public:
   ArduinoPixel()
       : strip_neopixel_(num_leds, strip_pin, NEO_GRB + NEO_KHZ800),
+        state_store_(eeprom_),
         server_(port) {}
 
   virtual ~ArduinoPixel() {}
@@ -103,15 +108,20 @@ class ArduinoPixel : public ArduinoPixelServer {
 
   void init() {
     strip_neopixel_.init();
-    init(&strip_neopixel_);
+    eeprom_.init();
+    // Restores the last state
+    init(&strip_neopixel_, &state_store_, &events_, &previews_);
     wifiConnect();
     server_.begin();
+    udp_.begin(stream_port);
+    if (clock_leader) leadClock(IPAddress(255, 255, 255, 255), stream_port);
   }
 
   void check() {
     WiFiClient client = server_.available();
     if (client) processRequest(client);
-    strip_neopixel_.colorize();
+    processPacket(udp_);
+    colorize();
   }
 
  private:
@@ -142,7 +152,12 @@ class ArduinoPixel : public ArduinoPixelServer {
 #endif
 
   led_strip::LedStripNeoPixel strip_neopixel_;
+  storage::StorageEeprom eeprom_;
+  StateStore state_store_;
   WiFiServer server_;
+  WiFiUDP udp_;
+  EventSource<WiFiClient, 1> events_;  // Subscribers of the state changes
+  FramePreview<WiFiClient, 1> previews_;  // Subscribers of the frames
 };
 
 ArduinoPixel pixel;
@@ -72,9 +72,11 @@
  */
 
 #include <WiFi.h>
+#include <WiFiUdp.h>
 
 #include "arduino_pixel_server.h"
 #include "led_strip/led_strip_esp_ws2812.h"
+#include "storage/storage_eeprom.h"
 
 using namespace arduino_pixel;
 
@@ -87,6 +89,8 @@ static IPAddress ip(192, 168, 1, 10);
 static IPAddress gateway(192, 168, 1, 1);
 static IPAddress subnet(255, 255, 255, 0);
 const int port = 80;
+const int stream_port = 7777;  // UDP port of the frame stream and the clock
+const bool clock_leader = false;  // Whether to send the group time
 const int num_leds = 112;
 const int strip_pin = 15;
 // ================================================================== end =====
@@ -97,6 +101,7 @@ class ArduinoPixel : public ArduinoPixelServer {
  public:
   ArduinoPixel()
       : strip_ws2812_(num_leds, strip_pin, Ws2812::LedType::WS2812B),
+        state_store_(eeprom_),
         server_(port, 1) {}
 
   virtual ~ArduinoPixel() {}
@@ -105,16 +110,21 @@ class ArduinoPixel : public ArduinoPixelServer {
 
   void init() {
     strip_ws2812_.init();
-    init(&strip_ws2812_);
+    eeprom_.init();
+    // Restores the last state
+    init(&strip_ws2812_, &state_store_, &events_, &previews_);
     wifiConnect();
     server_.begin();
+    udp_.begin(stream_port);
+    if (clock_leader) leadClock(IPAddress(255, 255, 255, 255), stream_port);
     Serial.println("Server started\n");
   }
 
   void check() {
     WiFiClient client = server_.available();
     if (client) processRequest(client);
-    strip_ws2812_.colorize();
+    processPacket(udp_);
+    colorize();
   }
 
  private:
@@ -141,8 +151,13 @@ class ArduinoPixel : public ArduinoPixelServer {
     Serial.println(" dBm");
   }
 
-  led_strip::LedStripEspWs2812 strip_ws2812_;
+  led_strip::LedStripEspWs2812<> strip_ws2812_;
+  storage::StorageEeprom eeprom_;
+  StateStore state_store_;
   WiFiServer server_;
+  WiFiUDP udp_;
+  EventSource<WiFiClient, 4> events_;  // Subscribers of the state changes
+  FramePreview<WiFiClient, 2> previews_;  // Subscribers of the frames
 };
 
 ArduinoPixel pixel;
@@ -0,0 +1,123 @@
+/*! \file animation.cpp
+ *  \brief Implementation of the animations that are uploaded to the device.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "animation.h"
+
+namespace arduino_pixel {
+
+Animation::Animation() : data_(buffer_), size_(0), progmem_(false) {}
+
+bool Animation::parseHex(const char *hex, size_t length) {
+  clear();
+  long size = arduino_pixel::parseHex(hex, length, buffer_, kCapacity);
+  if (size < 0) return false;
+  size_ = size;
+  if (validate()) return true;
+  clear();
+  return false;
+}
+
+bool Animation::setData_P(const byte *data, size_t size) {
+  data_ = data;
+  size_ = size;
+  progmem_ = true;
+  if (validate()) return true;
+  clear();
+  return false;
+}
+
+void Animation::clear() {
+  data_ = buffer_;
+  size_ = 0;
+  progmem_ = false;
+}
+
+size_t Animation::decodeFrame(size_t offset, FrameBuffer &frame) const {
+  size_t end = offset + 2 + readWord(offset);
+  int num_leds = frame.getNumLeds();
+  int idx = 0;
+  for (size_t pos = offset + 2; pos < end;) {
+    byte op = read(pos++);
+    int count = (op & 0x3F) + 1;
+    switch (op >> 6) {
+      case 0:  // Skip
+        idx += count;
+        break;
+      case 3:  // Long skip
+        idx += (((op & 0x3F) << 8) | read(pos++)) + 1;
+        break;
+      case 1: {  // Run
+        Color color(read(pos), read(pos + 1), read(pos + 2));
+        pos += 3;
+        for (; count and idx < num_leds; --count) frame.setPixel(idx++, color);
+        idx += count;
+        break;
+      }
+      default:  // Literal
+        for (; count; --count, pos += 3) {
+          if (idx < num_leds)
+            frame.setPixel(idx, Color(read(pos), read(pos + 1), read(pos + 2)));
+          ++idx;
+        }
+    }
+  }
+  return end;
+}
+
+bool Animation::validate() const {
+  if (size_ < kHeaderSize or read(0) != 'A' or read(1) != 'P' or
+      read(2) != 'X' or read(3) != 'A' or read(4) != kVersion or
+      getPeriod() == 0 or getNumFrames() == 0)
+    return false;
+  size_t offset = kHeaderSize;
+  for (uint16_t i = 0; i < getNumFrames(); ++i) {
+    if (offset + 2 > size_) return false;
+    size_t end = offset + 2 + readWord(offset);
+    if (end > size_) return false;
+    for (size_t pos = offset + 2; pos < end;) {
+      byte op = read(pos++);
+      switch (op >> 6) {
+        case 0:
+          break;
+        case 3:
+          ++pos;
+          break;
+        case 1:
+          pos += 3;
+          break;
+        default:
+          pos += 3 * ((op & 0x3F) + 1);
+      }
+      if (pos > end) return false;
+    }
+    offset = end;
+  }
+  return offset == size_;
+}
+
+}  // namespace arduino_pixel
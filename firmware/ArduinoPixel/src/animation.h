@@ -0,0 +1,148 @@
+/*! \file animation.h
+ *  \brief Defines the animations that are uploaded to the device.
+ *  \details The frames are compressed with run lengths and with deltas to the
+ *  previous frame, and are decoded one at a time into the frame buffer.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_ANIMATION_H
+#define ARDUINO_PIXEL_ANIMATION_H
+
+#include "common_types.h"
+#include "frame_buffer.h"
+
+// The size in bytes of the buffer for an uploaded animation.
+#ifndef ARDUINO_PIXEL_ANIMATION_SIZE
+#if defined(__AVR__)
+#define ARDUINO_PIXEL_ANIMATION_SIZE 128
+#else
+#define ARDUINO_PIXEL_ANIMATION_SIZE 8192
+#endif
+#endif
+
+namespace arduino_pixel {
+
+/**
+ * \brief Holds a compressed animation.
+ * \details An animation holds, all values little endian:
+ *   0-3: "APXA"
+ *   4: version
+ *   5: flags (bit 0: loop)
+ *   6-7: the number of LEDs
+ *   8-9: the period of the frames in ms
+ *   10-11: the number of frames
+ *   12-...: the frames
+ * \par
+ * A frame holds its length in bytes (2 bytes), and then a list of ops that
+ * change the previous frame, starting from the first pixel:
+ *   00nnnnnn: skip n + 1 pixels
+ *   11nnnnnn nnnnnnnn: skip n + 1 pixels, up to 16384
+ *   01nnnnnn r g b: n + 1 pixels of the same color
+ *   10nnnnnn r g b ...: n + 1 pixels of different colors
+ * \par
+ * The pixels after the last op are left unchanged, so decoding a frame costs
+ * in proportion to the pixels that change. The first frame has to set all
+ * the pixels, so that the animation can start over from it.
+ * \par
+ * The animation is either copied to a buffer in RAM, or read from flash.
+ * It's validated once, when it's set, so the frames are decoded without
+ * further checks.
+ */
+class Animation {
+ public:
+  static const byte kHeaderSize = 12;
+  static const byte kVersion = 1;
+  static const byte kLoop = 0x01;
+  static const size_t kCapacity = ARDUINO_PIXEL_ANIMATION_SIZE;
+
+  Animation();
+
+  /**
+   * \brief Copies an animation from its hex representation to the buffer.
+   * \param[in] hex the hex digits, two per byte.
+   * \param[in] length the number of digits.
+   * \return False if the animation is invalid or doesn't fit in the buffer,
+   * in which case the previous animation is lost.
+   */
+  bool parseHex(const char *hex, size_t length);
+  /**
+   * \brief Plays an animation from flash.
+   * \param[in] data the animation in flash.
+   * \param[in] size the size of the animation.
+   * \return False if the animation is invalid.
+   */
+  bool setData_P(const byte *data, size_t size);
+  /**
+   * \brief Forgets the animation.
+   */
+  void clear();
+
+  bool isLooping() const { return size_ and (read(5) & kLoop); }
+
+  uint16_t getNumLeds() const { return size_ ? readWord(6) : 0; }
+
+  uint16_t getPeriod() const { return size_ ? readWord(8) : 0; }
+
+  uint16_t getNumFrames() const { return size_ ? readWord(10) : 0; }
+
+  size_t getSize() const { return size_; }
+
+  /**
+   * \brief Gets the offset of the first frame.
+   */
+  size_t getFirstFrame() const { return kHeaderSize; }
+  /**
+   * \brief Applies a frame to the frame buffer.
+   * \param[in] offset the offset of the frame.
+   * \param[out] frame the frame buffer that holds the previous frame.
+   * \return The offset of the next frame.
+   */
+  size_t decodeFrame(size_t offset, FrameBuffer &frame) const;
+
+ private:
+  byte read(size_t idx) const {
+    return progmem_ ? pgm_read_byte(data_ + idx) : data_[idx];
+  }
+
+  uint16_t readWord(size_t idx) const {
+    return read(idx) | ((uint16_t)read(idx + 1) << 8);
+  }
+
+  /**
+   * \brief Checks that the header and every op of every frame are within
+   * the data.
+   */
+  bool validate() const;
+
+  byte buffer_[kCapacity];
+  const byte *data_;
+  size_t size_;
+  bool progmem_;  // Flag that indicates whether the data are in flash
+};
+
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_ANIMATION_H
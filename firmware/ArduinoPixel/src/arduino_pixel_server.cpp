@@ -28,10 +28,27 @@
 
 #include "arduino_pixel_server.h"
 
+#include "response_writer.h"
+
 namespace arduino_pixel {
 
 ArduinoPixelServer::ArduinoPixelServer()
-    : power_(false), strip_(nullptr), mode_(nullptr), mode_off_(nullptr) {}
+    : power_(false),
+      strip_(nullptr),
+      mode_(nullptr),
+      mode_off_(nullptr),
+      state_store_(nullptr),
+      events_(nullptr),
+      previews_(nullptr),
+      sampler_(nullptr),
+      dirty_(false),
+      dirty_time_(0),
+      dirty_frame_time_(0),
+      frame_time_(0),
+      frame_interval_(0),
+      stream_sequence_(0),
+      clock_port_(0),
+      clock_time_(0) {}
 
 ArduinoPixelServer::~ArduinoPixelServer() {
   if (mode_) delete mode_;
@@ -41,37 +58,283 @@ ArduinoPixelServer::~ArduinoPixelServer() {
 void ArduinoPixelServer::processRequest(Client &client) {
   // Print the entire request and send default response
   // while(client.available()) Serial.print((char)client.read());
-  // ResponseData res(200, "OK", false, "");
+  // ResponseData res(200, F("OK"), "");
   // sendResponse(client,res);
   // return;
 
-  RequestData request = parseRequest(client);
-  updateStrip(request);
-  ResponseData response = getResponse(request);
-  sendResponse(client, response);
+  for (byte served = 1;; ++served) {
+    RequestData request = parseRequest(client);
+    if (request.http_method == HttpMethod::GET and
+        request.uri == Uri::EVENTS) {
+      subscribe(client);  // The connection stays open
+      return;
+    }
+    if (request.http_method == HttpMethod::GET and
+        request.uri == Uri::FRAME) {
+      sendFrame(client, request.query);  // Written from the frame buffer
+      return;
+    }
+    ResponseData response = updateStrip(request)
+                                ? getResponse(request)
+                                : ResponseData(400, F("Bad Request"));
+    bool keep_alive =
+        request.keep_alive and served < ARDUINO_PIXEL_KEEPALIVE_REQUESTS;
+    sendResponse(client, response, keep_alive);
+    if (not keep_alive or not waitForRequest(client)) return;
+  }
+}
+
+bool ArduinoPixelServer::waitForRequest(Client &client) {
+  // The timeout is in the time of the network, rather than of the clock
+  unsigned long start = ::millis();
+  while (not client.available()) {
+    if (not client.connected() or
+        ::millis() - start >= ARDUINO_PIXEL_KEEPALIVE_TIMEOUT) {
+      client.stop();
+      return false;
+    }
+    colorize();
+  }
+  return true;
+}
+
+void ArduinoPixelServer::processPacket(UDP &udp) {
+  if (clock_port_ and
+      Clock::millis() - clock_time_ >= ARDUINO_PIXEL_CLOCK_INTERVAL) {
+    byte packet[ClockSync::kPacketSize];
+    clock_sync_.encode(packet, Clock::groupMillis());
+    udp.beginPacket(clock_address_, clock_port_);
+    udp.write(packet, sizeof(packet));
+    udp.endPacket();
+    clock_time_ = Clock::millis();
+  }
+
+  int size = udp.parsePacket();
+  if (size <= 0) return;
+  // Stream and clock packets have headers of the same size
+  byte header[StreamPacket::kHeaderSize];
+  if (size < StreamPacket::kHeaderSize or
+      udp.read(header, sizeof(header)) != sizeof(header)) {
+    udp.flush();
+    return;
+  }
+  if (header[0] == 'A' and header[1] == 'C') {
+    // A leader ignores the clock packets, e.g. its own broadcasts
+    if (not clock_port_ and clock_sync_.process(header, Clock::millis()))
+      clock_sync_.apply();
+    udp.flush();
+    return;
+  }
+  if (not power_ or mode_->getModeType() != Mode::STREAM or
+      header[0] != 'A' or header[1] != 'P' or
+      header[2] != StreamPacket::kVersion) {
+    udp.flush();
+    return;
+  }
+  uint16_t sequence = header[4] | ((uint16_t)header[5] << 8);
+  uint16_t first = header[6] | ((uint16_t)header[7] << 8);
+  uint16_t count = header[8] | ((uint16_t)header[9] << 8);
+  // Sequence numbers wrap around, so compare their distance. A packet far
+  // behind is taken as a restart of the stream, rather than a stale packet
+  int16_t distance = sequence - stream_sequence_;
+  if (distance < 0 and distance > -ARDUINO_PIXEL_STREAM_WINDOW) {
+    udp.flush();
+    return;
+  }
+  stream_sequence_ = sequence;
+
+  FrameBuffer &frame = strip_->getModeFrame();
+  int num_leds = frame.getNumLeds();
+  byte color[3];
+  for (uint16_t i = 0; i < count and first + i < num_leds; ++i) {
+    if (udp.read(color, 3) != 3) break;
+    frame.setPixel(first + i, Color(color[0], color[1], color[2]));
+  }
+  udp.flush();
+  if (header[3] & StreamPacket::kLastPacket) {
+    static_cast<mode::FrameStream *>(mode_)->pushFrame();
+    // The next frame may reuse the sequence number only after it wraps
+    ++stream_sequence_;
+  }
+}
+
+void ArduinoPixelServer::leadClock(const IPAddress &address, uint16_t port) {
+  clock_address_ = address;
+  clock_port_ = port;
+  clock_time_ = Clock::millis() - ARDUINO_PIXEL_CLOCK_INTERVAL;  // Send now
+  clock_sync_.reset();
 }
 
-void ArduinoPixelServer::colorize() { strip_->colorize(); }
+void ArduinoPixelServer::setSampler(SamplerBase *sampler) {
+  sampler_ = sampler;
+}
+
+void ArduinoPixelServer::colorize() {
+  unsigned long start = Clock::micros();
+  bool shown;
+  if (not dirty_) {
+    shown = strip_->colorize();
+  } else if (Clock::millis() - dirty_frame_time_ >=
+             ARDUINO_PIXEL_FRAME_INTERVAL) {
+    shown = strip_->colorize(true);
+    dirty_ = false;
+    dirty_frame_time_ = Clock::millis();
+    publishState();  // Once per rendered state, however many changes led to it
+  } else {
+    shown = false;  // The state is rendered in full on the next frame
+  }
+
+  if (shown) {
+    unsigned long end = Clock::micros();
+    if (stats_.frames) {
+      unsigned long interval = end - frame_time_;
+      stats_.jitter = (interval > frame_interval_) ? interval - frame_interval_
+                                                   : frame_interval_ - interval;
+      stats_.max_jitter = max(stats_.max_jitter, stats_.jitter);
+      frame_interval_ = interval;
+    }
+    frame_time_ = end;
+    ++stats_.frames;
+    stats_.render_time = end - start;
+    stats_.current = strip_->getCurrent();
+    stats_.max_current = max(stats_.max_current, stats_.current);
+    stats_.limit = strip_->getLimit();
+    if (dirty_time_) {
+      stats_.latency = end - dirty_time_;
+      stats_.max_latency = max(stats_.max_latency, stats_.latency);
+      dirty_time_ = 0;
+    }
+  }
+
+  if (state_store_) state_store_->update();
+  if (events_) events_->update(Clock::millis());
+  if (previews_) previews_->update(Clock::millis(), shown, *strip_);
+}
+
+void ArduinoPixelServer::markDirty() {
+  ++stats_.updates;
+  if (dirty_) ++stats_.coalesced;
+  dirty_ = true;
+  dirty_time_ = Clock::micros();
+}
 
-void ArduinoPixelServer::init(led_strip::LedStripBase *strip) {
+void ArduinoPixelServer::init(led_strip::LedStripBase *strip,
+                              StateStore *state_store,
+                              EventSourceBase *events,
+                              FramePreviewBase *previews) {
   strip_ = strip;
-  mode_ = new mode::SingleColor(strip_->getNumLeds());
-  mode_->setColor(Color(128, 128, 128));
+  state_store_ = state_store;
+  events_ = events;
+  previews_ = previews;
   mode_off_ = new mode::SingleColor(strip_->getNumLeds());
   mode_off_->setColor(Color(0, 0, 0));
-  powerOff();
+
+  DeviceState state;
+  state.num_colors = 1;
+  state.colors[0] = Color(128, 128, 128);
+  if (state_store_) state_store_->load(state);  // Overrides the defaults
+  setState(state);
+}
+
+void ArduinoPixelServer::subscribe(Client &client) {
+  if (not events_ or not events_->subscribe(client)) {
+    ResponseData response =
+        events_ ? ResponseData(503, F("Service Unavailable"))
+                : ResponseData(404, F("Not Found"));
+    sendResponse(client, response);
+    return;
+  }
+  ResponseWriter writer(client);
+  writer.printStatus(200, F("OK"));
+  writer.printHeader(F("Content-Type"), F("text/event-stream"));
+  writer.printHeader(F("Cache-Control"), F("no-cache"));
+  writer.endHeaders();
+  writer.print(getStateEvent());
+  if (not writer.send()) client.stop();  // The event source drops it
+}
+
+void ArduinoPixelServer::sendFrame(Client &client, const String &query) {
+  PreviewOptions options;
+  if (not parsePreviewOptions(query, options)) {
+    ResponseData response(400, F("Bad Request"));
+    sendResponse(client, response);
+    return;
+  }
+  if (options.interval) {
+    if (not previews_ or not previews_->subscribe(client, options)) {
+      ResponseData response =
+          previews_ ? ResponseData(503, F("Service Unavailable"))
+                    : ResponseData(404, F("Not Found"));
+      sendResponse(client, response);
+      return;
+    }
+    ResponseWriter writer(client);
+    writer.printStatus(200, F("OK"));
+    writer.printHeader(F("Content-Type"), F("application/octet-stream"));
+    writer.printHeader(F("Cache-Control"), F("no-cache"));
+    writer.endHeaders();  // The frames follow from colorize
+    if (not writer.send()) client.stop();  // The preview drops it
+    return;
+  }
+  size_t length = FramePreviewBase::getLength(*strip_, options);
+  ResponseWriter writer(client);
+  writer.printStatus(200, F("OK"));
+  writer.printHeader(F("Content-Type"), F("application/octet-stream"));
+  if (length) writer.printHeader(F("Content-Length"), length);
+  writer.printHeader(F("Connection"), F("close"));
+  writer.endHeaders();
+  // The frame follows the headers in the same buffer
+  if (FramePreviewBase::write(writer, *strip_, options)) client.flush();
+  client.stop();
+}
+
+bool ArduinoPixelServer::parsePreviewOptions(const String &query,
+                                             PreviewOptions &options) const {
+  long step = 1, encoded = 0, fps = 0;
+  const char *param = query.c_str();
+  while (*param) {
+    size_t key;
+    long *value = nullptr;
+    if ((key = startsWith(param, F("step="))))
+      value = &step;
+    else if ((key = startsWith(param, F("rle="))))
+      value = &encoded;
+    else if ((key = startsWith(param, F("fps="))))
+      value = &fps;
+    if (value) {
+      char *end;
+      *value = strtol(param + key, &end, 10);
+      if (end == param + key or (*end and *end != '&')) return false;
+    }
+    const char *next = strchr(param, '&');
+    if (not next) break;
+    param = next + 1;
+  }
+  if (step < 1 or step > FramePreviewBase::kMaxStep) return false;
+  if (encoded < 0 or encoded > 1) return false;
+  if (fps < 0 or fps > 1000 / ARDUINO_PIXEL_FRAME_INTERVAL) return false;
+  options.step = step;
+  options.encoded = encoded;
+  options.interval = fps ? 1000 / fps : 0;
+  return true;
+}
+
+void ArduinoPixelServer::publishState() {
+  if (not events_ or events_->getNumSubscribers() == 0) return;
+  String event = getStateEvent();  // Serialized once for all subscribers
+  events_->publish(event.c_str(), event.length());
 }
 
 void ArduinoPixelServer::powerOn() {
   power_ = true;
   strip_->setMode(mode_);
-  strip_->colorize(true);
+  markDirty();
 }
 
 void ArduinoPixelServer::powerOff() {
   power_ = false;
   strip_->setMode(mode_off_);
-  strip_->colorize(true);
+  markDirty();
 }
 
 RequestData ArduinoPixelServer::parseRequest(Client &client) const {
@@ -79,14 +342,21 @@ RequestData ArduinoPixelServer::parseRequest(Client &client) const {
   String request_line = getRequestLine(client);
   request.http_method = parseHttpMethod(request_line);
   request.uri = parseUri(request.http_method, request_line);
-  request.data = getRequestData(client);
+  request.query = getQuery(request_line);
+  long length = parseHeaders(client, request);
+  // A request without a length on a kept connection has no data, since the
+  // bytes that follow are the next request
+  if (length < 0 and request.keep_alive) length = 0;
+  request.data = getRequestData(client, length, request.keep_alive);
+  // The next request can't be found after data that are cut short
+  if ((long)request.data.length() != length) request.keep_alive = false;
 
 #ifdef DEBUG
-  Serial.print("HTTP Method: ");
+  Serial.print(F("HTTP Method: "));
   Serial.println(toString(request.http_method));
-  Serial.print("URI: ");
+  Serial.print(F("URI: "));
   Serial.println(toString(request.uri));
-  Serial.print("Data: ");
+  Serial.print(F("Data: "));
   Serial.println(request.data);
   Serial.println();
 #endif
@@ -94,19 +364,10 @@ RequestData ArduinoPixelServer::parseRequest(Client &client) const {
 }
 
 String ArduinoPixelServer::getRequestLine(Client &client) const {
-  String request_line;
-  char req_char;
-  while (client.available()) {
-    if ((req_char = client.read()) == '\r') {
-      client.read();  // Get rid of '\n'
-      break;
-    } else {
-      request_line += req_char;
-    }
-  }
+  String request_line = readLine(client);
 
 #ifdef DEBUG
-  Serial.print("Request Line: ");
+  Serial.print(F("Request Line: "));
   Serial.println(request_line);
 #endif
   return request_line;
@@ -114,10 +375,10 @@ String ArduinoPixelServer::getRequestLine(Client &client) const {
 
 HttpMethod ArduinoPixelServer::parseHttpMethod(
     const String &request_line) const {
-  String method = request_line.substring(0, request_line.indexOf(' '));
-  if (method.equals("GET"))
+  const char *method = request_line.c_str();
+  if (startsWith(method, F("GET ")))
     return HttpMethod::GET;
-  else if (method.equals("PUT"))
+  else if (startsWith(method, F("PUT ")))
     return HttpMethod::PUT;
   else
     return HttpMethod::INVALID;
@@ -125,31 +386,103 @@ HttpMethod ArduinoPixelServer::parseHttpMethod(
 
 Uri ArduinoPixelServer::parseUri(HttpMethod method,
                                  const String &request_line) const {
-  String uri = request_line.substring(request_line.indexOf(' ') + 1,
-                                      request_line.lastIndexOf(' '));
-  if (uri.equals("/"))
+  int start_idx = request_line.indexOf(' ') + 1;
+  if (start_idx == 0) return Uri::INVALID;
+  const char *uri = request_line.c_str() + start_idx;
+  if (startsWith(uri, F("/ ")))
     return Uri::ROOT;
-  else if (uri.startsWith("/strip/status/on"))
+  else if (startsWith(uri, F("/strip/status/on")))
     return Uri::STATUS_ON;
-  else if (uri.startsWith("/strip/status/off"))
+  else if (startsWith(uri, F("/strip/status/off")))
     return Uri::STATUS_OFF;
-  else if (uri.startsWith("/strip/status"))
+  else if (startsWith(uri, F("/strip/stats")))
+    return Uri::STATS;
+  else if (startsWith(uri, F("/strip/clock")))
+    return Uri::CLOCK;
+  else if (startsWith(uri, F("/strip/events")))
+    return Uri::EVENTS;
+  else if (startsWith(uri, F("/strip/animation")))
+    return (method == HttpMethod::GET) ? Uri::ANIMATION_GET
+                                       : Uri::ANIMATION_PUT;
+  else if (startsWith(uri, F("/strip/script")))
+    return (method == HttpMethod::GET) ? Uri::SCRIPT_GET : Uri::SCRIPT_PUT;
+  else if (startsWith(uri, F("/strip/layout")))
+    return (method == HttpMethod::GET) ? Uri::LAYOUT_GET : Uri::LAYOUT_PUT;
+  else if (startsWith(uri, F("/strip/pixels")))
+    return Uri::PIXELS;
+  else if (startsWith(uri, F("/strip/frame")))
+    return Uri::FRAME;
+  else if (startsWith(uri, F("/strip/status")))
     return Uri::STATUS;
-  else if (uri.startsWith("/strip/modes"))
+  else if (startsWith(uri, F("/strip/modes")))
     return Uri::MODES;
-  else if (uri.startsWith("/strip/mode"))
+  else if (startsWith(uri, F("/strip/mode")))
     return (method == HttpMethod::GET) ? Uri::MODE_GET : Uri::MODE_PUT;
-  else if (uri.startsWith("/strip/color"))
+  else if (startsWith(uri, F("/strip/color")))
     return (method == HttpMethod::GET) ? Uri::COLOR_GET : Uri::COLOR_PUT;
   else
     return Uri::INVALID;
 }
 
-String ArduinoPixelServer::getRequestData(Client &client) const {
-  String tmp;
-  while (client.available()) tmp += (char)client.read();
-  int idx = tmp.indexOf("\r\n\r\n");  // The data begin after an empty line
-  return (idx > 0) ? tmp.substring(idx + 4) : String();
+String ArduinoPixelServer::getQuery(const String &request_line) const {
+  int start_idx = request_line.indexOf(' ') + 1;
+  if (start_idx == 0) return String();
+  int end_idx = request_line.indexOf(' ', start_idx);
+  if (end_idx < 0) end_idx = request_line.length();
+  int query_idx = request_line.indexOf('?', start_idx);
+  if (query_idx < 0 or query_idx > end_idx) return String();
+  return request_line.substring(query_idx + 1, end_idx);
+}
+
+String ArduinoPixelServer::readLine(Client &client) const {
+  String line;
+  char c;
+  while (client.available()) {
+    if ((c = client.read()) == '\r') {
+      client.read();  // Get rid of '\n'
+      break;
+    } else {
+      line += c;
+    }
+  }
+  return line;
+}
+
+long ArduinoPixelServer::parseHeaders(Client &client,
+                                      RequestData &request) const {
+  long length = -1;
+  request.keep_alive = false;
+  // The headers end with an empty line, before the data
+  for (String line = readLine(client); line.length();
+       line = readLine(client)) {
+    const char *header = line.c_str();
+    size_t name = startsWithIgnoreCase(header, F("Content-Length:"));
+    if (name) {
+      length = atol(header + name);
+      continue;
+    }
+    name = startsWithIgnoreCase(header, F("Connection:"));
+    if (name) {
+      while (isSpace(header[name])) ++name;
+      request.keep_alive = startsWithIgnoreCase(header + name, F("keep-alive"));
+    }
+  }
+  return length;
+}
+
+String ArduinoPixelServer::getRequestData(Client &client, long length,
+                                          bool wait) const {
+  String data;
+  unsigned long start = ::millis();
+  while (length < 0 or (long)data.length() < length) {
+    if (client.available()) {
+      data += (char)client.read();
+    } else if (not wait or not client.connected() or
+               ::millis() - start >= ARDUINO_PIXEL_KEEPALIVE_TIMEOUT) {
+      break;
+    }
+  }
+  return data;
 }
 
 ResponseData ArduinoPixelServer::getResponse(RequestData &request) const {
@@ -159,72 +492,107 @@ ResponseData ArduinoPixelServer::getResponse(RequestData &request) const {
     case HttpMethod::PUT:
       return getPutResponse(request);
     default:
-      return ResponseData(404, "Not Found", false, "");
+      return ResponseData(404, F("Not Found"));
   }
 }
 
 ResponseData ArduinoPixelServer::getGetResponse(RequestData &request) const {
   switch (request.uri) {
     case Uri::ROOT:
-      return ResponseData(200, "OK", false, "Hello from Arduino Server");
+      return ResponseData(200, F("OK"), F("Hello from Arduino Server"));
     case Uri::STATUS:
-      return ResponseData(200, "OK", false, power_ ? "ON" : "OFF");
+      return ResponseData(200, F("OK"), power_ ? F("ON") : F("OFF"));
     case Uri::MODES:
-      return ResponseData(200, "OK", false, getModes());
+      return ResponseData(200, F("OK"), getModes());
     case Uri::MODE_GET:
-      return ResponseData(200, "OK", false, mode_->getMode());
+      return ResponseData(200, F("OK"), mode_->getMode());
     case Uri::COLOR_GET:
-      return ResponseData(200, "OK", false, getColor());
+      return ResponseData(200, F("OK"), getColor());
+    case Uri::STATS:
+      return ResponseData(200, F("OK"), getStats());
+    case Uri::CLOCK:
+      return ResponseData(200, F("OK"), getClock());
+    case Uri::ANIMATION_GET:
+      return ResponseData(200, F("OK"), getAnimation());
+    case Uri::SCRIPT_GET:
+      return ResponseData(200, F("OK"), getScript());
+    case Uri::LAYOUT_GET:
+      return ResponseData(200, F("OK"), getLayout());
     default:
-      return ResponseData(404, "Not Found", false, "");
+      return ResponseData(404, F("Not Found"));
   }
 }
 
 ResponseData ArduinoPixelServer::getPutResponse(RequestData &request) const {
   switch (request.uri) {
     case Uri::STATUS_ON:
-      return ResponseData(200, "OK", false, "");
+      return ResponseData(200, F("OK"));
     case Uri::STATUS_OFF:
-      return ResponseData(200, "OK", false, "");
+      return ResponseData(200, F("OK"));
     case Uri::MODE_PUT:
-      return ResponseData(200, "OK", false, "");
+      return ResponseData(200, F("OK"));
     case Uri::COLOR_PUT:
-      return ResponseData(200, "OK", true, "");
+      return ResponseData(200, F("OK"));
+    case Uri::STATS:
+      return ResponseData(200, F("OK"));
+    case Uri::ANIMATION_PUT:
+      return ResponseData(200, F("OK"));
+    case Uri::SCRIPT_PUT:
+      return ResponseData(200, F("OK"));
+    case Uri::LAYOUT_PUT:
+      return ResponseData(200, F("OK"));
+    case Uri::PIXELS:
+      return ResponseData(200, F("OK"));
     default:
-      return ResponseData(404, "Not Found", false, "");
+      return ResponseData(404, F("Not Found"));
   }
 }
 
-void ArduinoPixelServer::sendResponse(Client &client,
-                                      ResponseData &response) const {
+void ArduinoPixelServer::sendResponse(Client &client, ResponseData &response,
+                                      bool keep_alive) const {
+  size_t length =
+      response.data_P ? strlen_P(reinterpret_cast<PGM_P>(response.data_P))
+                      : response.data.length();
+
 #ifdef DEBUG
-  Serial.print("HTTP/1.1 ");
+  Serial.print(F("HTTP/1.1 "));
   Serial.print(response.status_code);
-  Serial.print(" ");
+  Serial.print(' ');
   Serial.println(response.status_msg);
-  Serial.println("Content-type:text/plain");
-  if (!response.keep_alive) Serial.println("Connection: close");
+  Serial.println(F("Content-Type: text/plain"));
+  Serial.print(F("Content-Length: "));
+  Serial.println(length);
+  Serial.print(F("Connection: "));
+  Serial.println(keep_alive ? F("keep-alive") : F("close"));
   Serial.println();
-  if (response.data.length()) {
+  if (response.data_P) {
+    Serial.println(response.data_P);
+    Serial.println();
+  } else if (response.data.length()) {
     Serial.println(response.data);
     Serial.println();
   }
-  Serial.println("==========");
+  Serial.println(F("=========="));
   Serial.println();
 #endif
 
-  client.print("HTTP/1.1 ");
-  client.print(response.status_code);
-  client.print(" ");
-  client.println(response.status_msg);
-  client.println("Content-type:text/plain");
-  if (!response.keep_alive) client.println("Connection: close");
-  if (response.data.length()) {
-    client.println();
-    client.print(response.data);
-  }
-  client.println();
-  delay(1);
+  ResponseWriter writer(client);
+  writer.printStatus(response.status_code, response.status_msg);
+  writer.printHeader(F("Content-Type"), F("text/plain"));
+  writer.printHeader(F("Content-Length"), length);
+  writer.printHeader(F("Connection"),
+                     keep_alive ? F("keep-alive") : F("close"));
+  writer.endHeaders();
+  if (response.data_P)
+    writer.print(response.data_P);  // Streamed straight from flash
+  else
+    writer.print(response.data);
+  // Waits until the response is sent, before closing, unless the client has
+  // already failed to take it
+  if (writer.send()) {
+    client.flush();
+    if (keep_alive) return;
+  }
   client.stop();
 }
 
@@ -235,26 +603,181 @@ String ArduinoPixelServer::getModes() const {
     case Mode::SINGLE_COLOR:
       modes += toString(Mode::SINGLE_COLOR);
     case Mode::SCANNER:
-      modes += ",";
+      modes += ',';
       modes += toString(Mode::SCANNER);
     case Mode::RAINBOW:
-      modes += ",";
+      modes += ',';
       modes += toString(Mode::RAINBOW);
     case Mode::RAINBOW_CYCLE:
-      modes += ",";
+      modes += ',';
       modes += toString(Mode::RAINBOW_CYCLE);
+    case Mode::GRADIENT:
+      modes += ',';
+      modes += toString(Mode::GRADIENT);
+    case Mode::GRADIENT_SCROLL:
+      modes += ',';
+      modes += toString(Mode::GRADIENT_SCROLL);
+    case Mode::STREAM:
+      modes += ',';
+      modes += toString(Mode::STREAM);
+    case Mode::PLAYBACK:
+      modes += ',';
+      modes += toString(Mode::PLAYBACK);
+    case Mode::SCRIPT:
+      modes += ',';
+      modes += toString(Mode::SCRIPT);
+    case Mode::CANVAS:
+      modes += ',';
+      modes += toString(Mode::CANVAS);
+    case Mode::NOISE:
+      modes += ',';
+      modes += toString(Mode::NOISE);
+    case Mode::FIRE:
+      modes += ',';
+      modes += toString(Mode::FIRE);
+    case Mode::TWINKLE:
+      modes += ',';
+      modes += toString(Mode::TWINKLE);
+    case Mode::SPECTRUM:
+      modes += ',';
+      modes += toString(Mode::SPECTRUM);
   }
   return modes;
 }
 
+String ArduinoPixelServer::getStats() const {
+  String json(F("{\"updates\":"));
+  json += stats_.updates;
+  json += F(",\"coalesced\":");
+  json += stats_.coalesced;
+  json += F(",\"frames\":");
+  json += stats_.frames;
+  json += F(",\"latency\":");
+  json += stats_.latency;
+  json += F(",\"max_latency\":");
+  json += stats_.max_latency;
+  json += F(",\"render_time\":");
+  json += stats_.render_time;
+  json += F(",\"jitter\":");
+  json += stats_.jitter;
+  json += F(",\"max_jitter\":");
+  json += stats_.max_jitter;
+  json += F(",\"current\":");
+  json += stats_.current;
+  json += F(",\"max_current\":");
+  json += stats_.max_current;
+  json += F(",\"limit\":");
+  json += stats_.limit;
+  json += '}';
+  return json;
+}
+
+String ArduinoPixelServer::getClock() const {
+  unsigned long local = Clock::millis();
+  unsigned long group = Clock::toGroupTime(local);
+  String json(F("{\"time\":"));
+  json += group;
+  json += F(",\"offset\":");
+  json += (long)(group - local);
+  json += F(",\"leader\":");
+  json += clock_port_ ? F("true") : F("false");
+  json += F(",\"synced\":");
+  json += clock_sync_.isSynced() ? F("true") : F("false");
+  json += F(",\"drift\":");
+  json += clock_sync_.getDrift();
+  json += F(",\"skew\":");
+  json += clock_sync_.getSkew();
+  json += F(",\"syncs\":");
+  json += clock_sync_.getSyncs();
+  json += '}';
+  return json;
+}
+
+String ArduinoPixelServer::getStateEvent() const {
+  DeviceState state = getState();
+  String event(F("event: state\ndata: {\"power\":"));
+  event += state.power ? F("true") : F("false");
+  event += F(",\"mode\":\"");
+  event += toString(state.mode);
+  event += F("\",\"period\":");
+  event += state.period;
+  event += F(",\"brightness\":");
+  event += state.brightness;
+  event += F(",\"colors\":[");
+  for (byte i = 0; i < state.num_colors; ++i) {
+    if (i) event += ',';
+    event += F("{\"r\":");
+    event += state.colors[i].red;
+    event += F(",\"g\":");
+    event += state.colors[i].green;
+    event += F(",\"b\":");
+    event += state.colors[i].blue;
+    event += '}';
+  }
+  event += F("]}\n\n");
+  return event;
+}
+
+String ArduinoPixelServer::getAnimation() const {
+  String json(F("{\"size\":"));
+  json += animation_.getSize();
+  json += F(",\"capacity\":");
+  json += Animation::kCapacity;
+  json += F(",\"leds\":");
+  json += animation_.getNumLeds();
+  json += F(",\"frames\":");
+  json += animation_.getNumFrames();
+  json += F(",\"period\":");
+  json += animation_.getPeriod();
+  json += F(",\"loop\":");
+  json += animation_.isLooping() ? F("true") : F("false");
+  json += '}';
+  return json;
+}
+
+String ArduinoPixelServer::getScript() const {
+  String json(F("{\"size\":"));
+  json += program_.getSize();
+  json += F(",\"capacity\":");
+  json += Program::kCapacity;
+  json += F(",\"period\":");
+  json += program_.getPeriod();
+  json += F(",\"animated\":");
+  json += program_.isAnimated() ? F("true") : F("false");
+  json += '}';
+  return json;
+}
+
+String ArduinoPixelServer::getLayout() const {
+  led_strip::MatrixLayout layout = strip_->getLayout();
+  String json(F("{\"width\":"));
+  json += layout.width;
+  json += F(",\"height\":");
+  json += layout.height;
+  json += F(",\"serpentine\":");
+  json += layout.serpentine ? F("true") : F("false");
+  json += F(",\"rotation\":");
+  json += layout.rotation;
+  json += F(",\"map\":");
+  json += layout.custom ? F("true") : F("false");
+  json += '}';
+  return json;
+}
+
 String ArduinoPixelServer::getColor() const {
   const Color &color = mode_->getColor();
-  return "{\"r\":" + String(color.red) + ",\"g\":" + String(color.green) +
-         ",\"b\":" + String(color.blue) + "}";
+  String json(F("{\"r\":"));
+  json += color.red;
+  json += F(",\"g\":");
+  json += color.green;
+  json += F(",\"b\":");
+  json += color.blue;
+  json += '}';
+  return json;
 }
 
-void ArduinoPixelServer::updateStrip(const RequestData &request) {
-  if (request.http_method == HttpMethod::GET) return;
+bool ArduinoPixelServer::updateStrip(const RequestData &request) {
+  if (request.http_method == HttpMethod::GET) return true;
   switch (request.uri) {
     case Uri::STATUS_ON:  // Turn the LED strip on
       powerOn();
@@ -263,57 +786,348 @@ void ArduinoPixelServer::updateStrip(const RequestData &request) {
       powerOff();
       break;
     case Uri::MODE_PUT:  // Update mode
-      updateMode(request.data);
-      strip_->colorize(true);
+      if (not updateMode(request.data)) return false;
+      markDirty();
       break;
     case Uri::COLOR_PUT:  // Update the LED strip color
-      updateColor(request.data);
-      strip_->colorize(true);
+      if (not updateColor(request.data)) return false;
+      markDirty();
       break;
+    case Uri::ANIMATION_PUT: {  // Replace the animation
+      bool valid = updateAnimation(request.data);
+      markDirty();  // A failed upload has cleared the previous animation
+      return valid;
+    }
+    case Uri::SCRIPT_PUT: {  // Replace the program
+      bool valid = updateScript(request.data);
+      markDirty();  // A failed upload has cleared the previous program
+      return valid;
+    }
+    case Uri::LAYOUT_PUT:  // Lay the LEDs out, which reorders every pixel
+      if (not updateLayout(request.data)) return false;
+      markDirty();
+      return true;
+    case Uri::PIXELS:  // Set parts of the canvas
+      return updatePixels(request.data);
+    case Uri::STATS:  // Reset the statistics
+      stats_ = FrameStats();
+      return true;
+    default:
+      return true;
   }
+  if (state_store_) state_store_->save(getState());
+  return true;
 }
 
-void ArduinoPixelServer::updateMode(const String &data) {
-  mode::ModeBase *mode;
-  if (data.indexOf("SINGLE_COLOR") > 0) {
-    mode = new mode::SingleColor(strip_->getNumLeds());
-  } else if (data.indexOf("SCANNER") > 0) {
-    unsigned long period = data.substring(data.lastIndexOf(' ') + 1).toInt();
-    if (period == 0) period = 100ul;
-    mode = new mode::Scanner(strip_->getNumLeds(), period);
-  } else if (data.indexOf("RAINBOW_CYCLE") > 0) {
-    unsigned long period = data.substring(data.lastIndexOf(' ') + 1).toInt();
-    if (period == 0) period = 10ul;
-    mode = new mode::RainbowCycle(strip_->getNumLeds(), period);
-  } else if (data.indexOf("RAINBOW") > 0) {
-    unsigned long period = data.substring(data.lastIndexOf(' ') + 1).toInt();
-    if (period == 0) period = 10ul;
-    mode = new mode::Rainbow(strip_->getNumLeds(), period);
-  } else {
-    return;
-  }
+bool ArduinoPixelServer::updateMode(const String &data) {
+  Mode type;
+  if (indexOf(data, toString(Mode::SINGLE_COLOR)) > 0)
+    type = Mode::SINGLE_COLOR;
+  else if (indexOf(data, toString(Mode::SCANNER)) > 0)
+    type = Mode::SCANNER;
+  else if (indexOf(data, toString(Mode::RAINBOW_CYCLE)) > 0)
+    type = Mode::RAINBOW_CYCLE;
+  else if (indexOf(data, toString(Mode::RAINBOW)) > 0)
+    type = Mode::RAINBOW;
+  else if (indexOf(data, toString(Mode::GRADIENT_SCROLL)) > 0)
+    type = Mode::GRADIENT_SCROLL;
+  else if (indexOf(data, toString(Mode::GRADIENT)) > 0)
+    type = Mode::GRADIENT;
+  else if (indexOf(data, toString(Mode::STREAM)) > 0)
+    type = Mode::STREAM;
+  else if (indexOf(data, toString(Mode::PLAYBACK)) > 0)
+    type = Mode::PLAYBACK;
+  else if (indexOf(data, toString(Mode::SCRIPT)) > 0)
+    type = Mode::SCRIPT;
+  else if (indexOf(data, toString(Mode::CANVAS)) > 0)
+    type = Mode::CANVAS;
+  else if (indexOf(data, toString(Mode::NOISE)) > 0)
+    type = Mode::NOISE;
+  else if (indexOf(data, toString(Mode::FIRE)) > 0)
+    type = Mode::FIRE;
+  else if (indexOf(data, toString(Mode::TWINKLE)) > 0)
+    type = Mode::TWINKLE;
+  else if (indexOf(data, toString(Mode::SPECTRUM)) > 0)
+    type = Mode::SPECTRUM;
+  else
+    return false;
+  unsigned long period = data.substring(data.lastIndexOf(' ') + 1).toInt();
 
+  mode::ModeBase *mode = createMode(type, period);
+  if (not mode) return false;  // E.g. SPECTRUM without a sampler
   mode->setColor(mode_->getColor());
-  mode->init();
+  replaceMode(mode);
+  return true;
+}
+
+mode::ModeBase *ArduinoPixelServer::createMode(Mode type,
+                                               unsigned long period) const {
+  int num_leds = strip_->getNumLeds();
+  switch (type) {
+    case Mode::SINGLE_COLOR:
+      return new mode::SingleColor(num_leds);
+    case Mode::SCANNER:
+      return new mode::Scanner(num_leds, period ? period : 100ul);
+    case Mode::RAINBOW:
+      return new mode::Rainbow(num_leds, period ? period : 10ul);
+    case Mode::RAINBOW_CYCLE:
+      return new mode::RainbowCycle(num_leds, period ? period : 10ul);
+    case Mode::GRADIENT:
+      return new mode::Gradient(num_leds);
+    case Mode::GRADIENT_SCROLL:
+      return new mode::GradientScroll(num_leds, period ? period : 50ul);
+    case Mode::STREAM:
+      return new mode::FrameStream(num_leds);
+    case Mode::PLAYBACK:
+      return new mode::Playback(num_leds, animation_, period);
+    case Mode::SCRIPT:
+      return new mode::Script(num_leds, program_, period);
+    case Mode::CANVAS: {
+      mode::Canvas *canvas = new mode::Canvas(num_leds);
+      if (canvas and canvas->isValid()) return canvas;
+      delete canvas;
+      return nullptr;
+    }
+    case Mode::NOISE:
+      return new mode::Noise(num_leds, period ? period : 20ul);
+    case Mode::FIRE:
+      return new mode::Fire(num_leds, period ? period : 15ul);
+    case Mode::TWINKLE:
+      return new mode::Twinkle(num_leds, period ? period : 20ul);
+    case Mode::SPECTRUM:
+      if (not sampler_) return nullptr;
+      return new mode::Spectrum(num_leds, *sampler_, period ? period : 20ul);
+    default:
+      return nullptr;
+  }
+}
+
+void ArduinoPixelServer::replaceMode(mode::ModeBase *mode) {
   if (mode_) delete mode_;
+  ScratchArena::reset();  // The old mode has released its scratch memory
+  mode->init();
   mode_ = mode;
   if (power_) strip_->setMode(mode_);
 }
 
-void ArduinoPixelServer::updateColor(const String &json) {
-  if (json.length() == 0) return;
-  byte idx = 0;
-  byte color[3];
-  for (byte i = 0; i < 3; ++i) {
-    while (json[idx++] != ':')
-      ;
-    byte start_idx = idx;
-    while (json[idx] != ',' && json[idx] != '}') idx++;
-    byte end_idx = idx;
-    String color_str = json.substring(start_idx, end_idx);
-    color[i] = (byte)color_str.toInt();
-  }
-  mode_->setColor(Color(color[0], color[1], color[2]));
+bool ArduinoPixelServer::updateAnimation(const String &data) {
+  // The command line client sends the data as the form field "arg"
+  size_t start = startsWith(data.c_str(), F("arg="));
+  size_t end = data.length();
+  while (end > start and isSpace(data[end - 1])) --end;
+  bool valid = animation_.parseHex(data.c_str() + start, end - start);
+  // The mode may hold a position in the previous animation
+  if (mode_->getModeType() == Mode::PLAYBACK) mode_->init();
+  return valid;
+}
+
+bool ArduinoPixelServer::updateScript(const String &data) {
+  // The command line client sends the data as the form field "arg"
+  size_t start = startsWith(data.c_str(), F("arg="));
+  size_t end = data.length();
+  while (end > start and isSpace(data[end - 1])) --end;
+  bool valid = program_.parseHex(data.c_str() + start, end - start);
+  return valid;
+}
+
+bool ArduinoPixelServer::updateLayout(const String &json) {
+  // The command line client sends the data as the form field "arg"
+  size_t start = startsWith(json.c_str(), F("arg="));
+  const char *text = json.c_str() + start;
+  JsonToken tokens[ARDUINO_PIXEL_JSON_TOKENS];
+  JsonTokenizer tokenizer(text, json.length() - start, tokens,
+                          ARDUINO_PIXEL_JSON_TOKENS);
+  if (tokenizer.tokenize() < 0 or tokens[0].type != JsonType::OBJECT)
+    return false;
+
+  long width;
+  if (not tokenizer.toInteger(tokenizer.find(0, F("width")), 1, 0xFFFF, width))
+    return false;
+  int token = tokenizer.find(0, F("map"));
+  if (token >= 0) {
+    if (tokens[token].type != JsonType::STRING) return false;
+    return updateMap(text + tokens[token].start,
+                     tokens[token].end - tokens[token].start, width);
+  }
+  long height = 1, rotation = 0;
+  bool serpentine = false;
+  token = tokenizer.find(0, F("height"));
+  if (token >= 0 and not tokenizer.toInteger(token, 1, 0xFFFF, height))
+    return false;
+  token = tokenizer.find(0, F("rotation"));
+  if (token >= 0 and not tokenizer.toInteger(token, 0, 270, rotation))
+    return false;
+  token = tokenizer.find(0, F("serpentine"));
+  if (token >= 0 and not tokenizer.toBoolean(token, serpentine)) return false;
+  return strip_->setMatrix(width, height, serpentine, rotation);
+}
+
+bool ArduinoPixelServer::updateMap(const char *hex, size_t length,
+                                   int width) {
+  int num_leds = strip_->getNumLeds();
+  if (length != 4ul * num_leds) return false;
+  uint16_t *index_map = new uint16_t[num_leds];
+  bool valid = index_map != nullptr;
+  for (int idx = 0; valid and idx < num_leds; ++idx) {
+    byte entry[2];
+    valid = parseHex(hex + 4 * idx, 4, entry, 2) == 2;
+    index_map[idx] = entry[0] | ((uint16_t)entry[1] << 8);
+  }
+  valid = valid and strip_->setMap(index_map, width);
+  delete[] index_map;
+  return valid;
+}
+
+bool ArduinoPixelServer::updatePixels(const String &data) {
+  // The command line client sends the data as the form field "arg"
+  size_t start = startsWith(data.c_str(), F("arg="));
+  size_t end = data.length();
+  while (end > start and isSpace(data[end - 1])) --end;
+  const char *text = data.c_str() + start;
+  // Validate everything before anything is applied
+  if (not parsePixels(text, end - start, nullptr)) return false;
+  if (mode_->getModeType() != Mode::CANVAS) {
+    mode::ModeBase *mode = createMode(Mode::CANVAS, 0);
+    if (not mode) return false;  // The heap can not hold the pixels
+    mode->setColor(mode_->getColor());
+    replaceMode(mode);
+    markDirty();  // The new canvas is rendered in full
+    if (state_store_) state_store_->save(getState());
+  }
+  return parsePixels(text, end - start, static_cast<mode::Canvas *>(mode_));
+}
+
+bool ArduinoPixelServer::parsePixels(const char *text, size_t length,
+                                     mode::Canvas *canvas) const {
+  long num_leds = strip_->getNumLeds();
+  if (length and text[0] == '[') {
+    JsonToken tokens[ARDUINO_PIXEL_JSON_TOKENS];
+    JsonTokenizer tokenizer(text, length, tokens, ARDUINO_PIXEL_JSON_TOKENS);
+    if (tokenizer.tokenize() < 0 or tokens[0].type != JsonType::ARRAY or
+        tokens[0].next == 1)
+      return false;
+    for (byte i = 1; i < tokens[0].next; i = tokens[i].next) {
+      // [index, r, g, b] or [first, count, r, g, b]
+      byte size = 0;
+      long values[5];
+      if (tokens[i].type != JsonType::ARRAY) return false;
+      for (byte j = i + 1; j < tokens[i].next; j = tokens[j].next) {
+        if (size == 5 or not tokenizer.toInteger(j, 0, 0xFFFF, values[size]))
+          return false;
+        ++size;
+      }
+      if (size < 4) return false;
+      long first = values[0], count = (size == 5) ? values[1] : 1;
+      const long *rgb = values + size - 3;
+      if (count == 0 or first + count > num_leds or rgb[0] > 255 or
+          rgb[1] > 255 or rgb[2] > 255)
+        return false;
+      if (canvas)
+        canvas->setPixels(first, count, Color(rgb[0], rgb[1], rgb[2]));
+    }
+    return true;
+  }
+  // Entries of 7 bytes in hex: first, count (2 bytes each, little endian),
+  // and r, g, b
+  if (length == 0 or length % 14) return false;
+  for (size_t offset = 0; offset < length; offset += 14) {
+    byte entry[7];
+    if (parseHex(text + offset, 14, entry, 7) < 0) return false;
+    long first = entry[0] | ((uint16_t)entry[1] << 8);
+    long count = entry[2] | ((uint16_t)entry[3] << 8);
+    if (count == 0 or first + count > num_leds) return false;
+    if (canvas)
+      canvas->setPixels(first, count, Color(entry[4], entry[5], entry[6]));
+  }
+  return true;
+}
+
+bool ArduinoPixelServer::updateColor(const String &json) {
+  // The command line client sends the data as the form field "arg"
+  size_t start = startsWith(json.c_str(), F("arg="));
+  JsonToken tokens[ARDUINO_PIXEL_JSON_TOKENS];
+  JsonTokenizer tokenizer(json.c_str() + start, json.length() - start, tokens,
+                          ARDUINO_PIXEL_JSON_TOKENS);
+  if (tokenizer.tokenize() < 0 or tokens[0].type != JsonType::OBJECT)
+    return false;
+
+  // Validate everything before anything is applied
+  Color colors[DeviceState::kMaxColors];
+  byte num_colors = 0;
+  int token = tokenizer.find(0, F("colors"));
+  if (token >= 0) {
+    if (tokens[token].type != JsonType::ARRAY) return false;
+    for (byte i = token + 1; i < tokens[token].next; i = tokens[i].next) {
+      if (num_colors == DeviceState::kMaxColors) return false;
+      if (not parseColor(tokenizer, i, colors[num_colors++])) return false;
+    }
+  } else if (tokenizer.find(0, F("r")) >= 0) {
+    if (not parseColor(tokenizer, 0, colors[num_colors++])) return false;
+  }
+  long period = -1;
+  token = tokenizer.find(0, F("period"));
+  if (token >= 0 and not tokenizer.toInteger(token, 0, 0xFFFF, period))
+    return false;
+  long brightness = -1;
+  token = tokenizer.find(0, F("brightness"));
+  if (token >= 0 and not tokenizer.toInteger(token, 0, 255, brightness))
+    return false;
+  if (num_colors == 0 and period < 0 and brightness < 0) return false;
+
+  // A period means nothing to a mode without one, and rebuilding it would
+  // lose its state, e.g. the pixels of a canvas
+  if (not hasPeriod(mode_->getModeType())) period = -1;
+
+  if (period >= 0 and (unsigned long)period != mode_->getPeriod()) {
+    mode::ModeBase *mode = createMode(mode_->getModeType(), period);
+    if (not mode) return false;
+    mode->setNumColors(mode_->getNumColors());
+    for (int i = 0; i < mode_->getNumColors(); ++i)
+      mode->setColor(mode_->getColor(i), i);
+    replaceMode(mode);
+  }
+  if (num_colors) mode_->setNumColors(num_colors);
+  for (int i = 0; i < min((int)num_colors, mode_->getNumColors()); ++i)
+    mode_->setColor(colors[i], i);
+  if (brightness >= 0) strip_->setBrightness(brightness);
+  return true;
+}
+
+bool ArduinoPixelServer::parseColor(const JsonTokenizer &tokenizer,
+                                    byte object, Color &color) const {
+  long red, green, blue;
+  if (not tokenizer.toInteger(tokenizer.find(object, F("r")), 0, 255, red) or
+      not tokenizer.toInteger(tokenizer.find(object, F("g")), 0, 255, green) or
+      not tokenizer.toInteger(tokenizer.find(object, F("b")), 0, 255, blue))
+    return false;
+  color = Color(red, green, blue);
+  return true;
+}
+
+DeviceState ArduinoPixelServer::getState() const {
+  DeviceState state;
+  state.power = power_;
+  state.mode = mode_->getModeType();
+  state.period = mode_->getPeriod();
+  state.brightness = strip_->getBrightness();
+  state.num_colors = min(mode_->getNumColors(), (int)DeviceState::kMaxColors);
+  for (byte i = 0; i < state.num_colors; ++i)
+    state.colors[i] = mode_->getColor(i);
+  return state;
+}
+
+void ArduinoPixelServer::setState(const DeviceState &state) {
+  mode::ModeBase *mode = createMode(state.mode, state.period);
+  if (not mode) mode = createMode(Mode::SINGLE_COLOR, 0);
+  mode->setNumColors(state.num_colors);
+  for (byte i = 0; i < state.num_colors; ++i)
+    mode->setColor(state.colors[i], i);
+  replaceMode(mode);
+  strip_->setBrightness(state.brightness);
+  if (state.power)
+    powerOn();
+  else
+    powerOff();
 }
 
 }  // namespace arduino_pixel
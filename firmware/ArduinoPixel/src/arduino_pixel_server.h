@@ -30,14 +30,56 @@
 #define ARDUINO_PIXEL_ARDUINO_PIXEL_SERVER_H
 
 #include <Client.h>
+#include <Udp.h>
 
 // #define DEBUG
 
+#include "clock.h"
+#include "animation.h"
+#include "clock_sync.h"
 #include "common_types.h"
+#include "event_source.h"
+#include "frame_preview.h"
+#include "json_tokenizer.h"
+#include "program.h"
+#include "sampler.h"
 #include "server_types.h"
+#include "scratch_arena.h"
+#include "state_store.h"
 #include "led_strip/led_strip_base.h"
 #include "modes.h"
 
+// The minimum time in ms between two frames that apply state changes. The
+// changes that arrive within a frame are coalesced, and only the latest
+// state is rendered.
+#ifndef ARDUINO_PIXEL_FRAME_INTERVAL
+#define ARDUINO_PIXEL_FRAME_INTERVAL 20
+#endif
+
+// The number of frames a streamed packet may lag behind the latest frame
+// before it's taken as the start of a new stream.
+#ifndef ARDUINO_PIXEL_STREAM_WINDOW
+#define ARDUINO_PIXEL_STREAM_WINDOW 32
+#endif
+
+// The time in ms that a connection, which the client asked to keep alive,
+// stays open after a response, waiting for the next request. The frames are
+// rendered meanwhile, but the packets wait.
+#ifndef ARDUINO_PIXEL_KEEPALIVE_TIMEOUT
+#define ARDUINO_PIXEL_KEEPALIVE_TIMEOUT 100
+#endif
+
+// The maximum number of requests on a connection that is kept alive, after
+// which it's closed, so that a client can't hold the server.
+#ifndef ARDUINO_PIXEL_KEEPALIVE_REQUESTS
+#define ARDUINO_PIXEL_KEEPALIVE_REQUESTS 32
+#endif
+
+// The time in ms between two clock packets of a leader.
+#ifndef ARDUINO_PIXEL_CLOCK_INTERVAL
+#define ARDUINO_PIXEL_CLOCK_INTERVAL 1000
+#endif
+
 namespace arduino_pixel {
 
 class ArduinoPixelServer {
@@ -47,21 +89,99 @@ class ArduinoPixelServer {
   /**
    * \brief Handles an http request.
    * \details Retrieves the http request, parses it, updates the LED strip as
-   * necessary, and responds to the client.
+   * necessary, and responds to the client. The connection is closed after
+   * the response, unless the request has a "Connection: keep-alive" header.
+   * Then the requests that follow on it are handled too, as long as they
+   * arrive within ARDUINO_PIXEL_KEEPALIVE_TIMEOUT ms, up to
+   * ARDUINO_PIXEL_KEEPALIVE_REQUESTS requests.
    * \param[in] client client that has the http request.
    */
   virtual void processRequest(Client &client);
+  /**
+   * \brief Handles a packet of the frame stream or of the group clock.
+   * \details The pixels are written to the LED strip while the STREAM mode
+   * is active, and the strip is updated when a frame is complete. Clock
+   * packets synchronize the group time, unless the device is the leader, in
+   * which case it sends them instead. Stale and invalid packets are dropped.
+   * \param[in] udp socket that may have received a packet.
+   */
+  virtual void processPacket(UDP &udp);
+  /**
+   * \brief Makes the device the leader of the group time.
+   * \details processPacket then sends the group time every
+   * ARDUINO_PIXEL_CLOCK_INTERVAL ms.
+   * \param[in] address destination of the clock packets, e.g. the broadcast
+   *                    address of the network.
+   * \param[in] port UDP port of the followers.
+   */
+  void leadClock(const IPAddress &address, uint16_t port);
+  /**
+   * \brief Sets the source of the audio samples of the SPECTRUM mode.
+   * \details Without a sampler, the SPECTRUM mode is rejected. Call it before
+   * init, so that a saved SPECTRUM mode can be restored.
+   * \param[in] sampler the sampler, e.g. a SamplerAnalog on a microphone.
+   */
+  void setSampler(SamplerBase *sampler);
   /**
    * \brief Updates the colors on the LED strip.
+   * \details Renders the latest state, if it has changed and a frame interval
+   * has passed since the last such render. Otherwise, lets the active mode
+   * animate.
    */
   virtual void colorize();
 
  protected:
   /**
    * \brief Initializes the pointer to the controlled LED strip.
+   * \details If a state store is given, the last saved state is restored,
+   * and every change of the state is saved from then on. If an event source
+   * is given, clients can subscribe to the changes of the state, and if a
+   * frame preview is given, to the frames.
    * \param[in] strip LED strip instance.
+   * \param[in] state_store store of the device state.
+   * \param[in] events subscribers of the state changes.
+   * \param[in] previews subscribers of the frames.
+   */
+  void init(led_strip::LedStripBase *strip, StateStore *state_store = nullptr,
+            EventSourceBase *events = nullptr,
+            FramePreviewBase *previews = nullptr);
+  /**
+   * \brief Marks the state as changed.
+   * \details The state is rendered on the next frame. Until then, any
+   * further changes are coalesced.
+   */
+  void markDirty();
+  /**
+   * \brief Subscribes a client to the changes of the state.
+   * \details The connection stays open, and receives a server-sent event
+   * with the current state, and then one every time a changed state is
+   * rendered.
+   * \param[in] client client that requested the events.
+   */
+  void subscribe(Client &client);
+  /**
+   * \brief Sends the current state to the subscribers.
+   */
+  void publishState();
+  /**
+   * \brief Sends the current frame of the strip.
+   * \details Without an fps parameter, the response is a single frame, and
+   * the connection is closed. With it, the connection stays open, and
+   * receives a frame at most fps times per second, whenever the frame
+   * changes.
+   * \param[in] client client that requested the frame.
+   * \param[in] query the parameters of the request, e.g. step=2&rle=1&fps=5.
+   */
+  void sendFrame(Client &client, const String &query);
+  /**
+   * \brief Parses the parameters of a frame request.
+   * \details Unknown parameters are ignored.
+   * \param[in] query the parameters, e.g. step=2&rle=1&fps=5.
+   * \param[out] options the options of the preview.
+   * \return False if a value is invalid or out of range, true otherwise.
    */
-  void init(led_strip::LedStripBase *strip);
+  bool parsePreviewOptions(const String &query,
+                           PreviewOptions &options) const;
   /**
    * \brief Powers the LED strip on.
    */
@@ -74,7 +194,9 @@ class ArduinoPixelServer {
   /**
    * \brief Parses an http request.
    * \details Retrieves the http request and extracts the http method, the uri,
-   * and the request data.
+   * the headers, and the request data. With a Content-Length, only the data
+   * of the request are read, so a request that follows on the connection is
+   * left for the next call.
    * \param[in] client client that has the http request.
    */
   RequestData parseRequest(Client &client) const;
@@ -84,6 +206,19 @@ class ArduinoPixelServer {
    * \return The request line.
    */
   String getRequestLine(Client &client) const;
+  /**
+   * \brief Reads a line, without its "\r\n".
+   * \param[in] client client that has the http request.
+   * \return The line, or an empty string at the end of the headers.
+   */
+  String readLine(Client &client) const;
+  /**
+   * \brief Extracts the headers that the server uses.
+   * \param[in] client client that has the http request.
+   * \param[out] request the request, whose keep_alive is set.
+   * \return The Content-Length, or -1 if there is none.
+   */
+  long parseHeaders(Client &client, RequestData &request) const;
   /**
    * \brief Parses a http method.
    * \param[in] request_line a request line.
@@ -97,12 +232,30 @@ class ArduinoPixelServer {
    * \return The uri.
    */
   Uri parseUri(HttpMethod method, const String &request_line) const;
+  /**
+   * \brief Extracts the parameters of the uri.
+   * \param[in] request_line a request line.
+   * \return The parameters after the '?' of the uri, or an empty string.
+   */
+  String getQuery(const String &request_line) const;
   /**
    * \brief Extracts the request data.
    * \param[in] client client that has the http request.
+   * \param[in] length the Content-Length, or -1 to take all the bytes that
+   *                   have arrived.
+   * \param[in] wait whether to wait for the bytes that haven't arrived yet,
+   *                 for up to ARDUINO_PIXEL_KEEPALIVE_TIMEOUT ms.
    * \return The request data.
    */
-  String getRequestData(Client &client) const;
+  String getRequestData(Client &client, long length, bool wait) const;
+  /**
+   * \brief Waits for the next request on a connection that is kept alive.
+   * \details The frames are rendered while waiting. The connection is closed
+   * if no request arrives within ARDUINO_PIXEL_KEEPALIVE_TIMEOUT ms.
+   * \param[in] client client of the connection.
+   * \return True if a request has arrived.
+   */
+  bool waitForRequest(Client &client);
 
   /**
    * \brief Constructs the response based on a request.
@@ -126,14 +279,47 @@ class ArduinoPixelServer {
    * \brief Sends a response to a client.
    * \param[in] client client that made the http request.
    * \param[in] response the response.
+   * \param[in] keep_alive whether to keep the connection open.
    */
-  void sendResponse(Client &client, ResponseData &response) const;
+  void sendResponse(Client &client, ResponseData &response,
+                    bool keep_alive = false) const;
 
   /**
    * \brief Gets a sequence of the available modes.
    * \return A comma separated list of the available modes.
    */
   String getModes() const;
+  /**
+   * \brief Gets the frame statistics.
+   * \return A json representation of the statistics.
+   */
+  String getStats() const;
+  /**
+   * \brief Retrieves the state of the group clock.
+   * \return A json representation of the group clock.
+   */
+  String getClock() const;
+  /**
+   * \brief Serializes the current state as a server-sent event.
+   * \return The event, i.e. an "event: state" line, and a "data:" line with
+   * a json representation of the state.
+   */
+  String getStateEvent() const;
+  /**
+   * \brief Retrieves a description of the animation.
+   * \return A json representation of the animation.
+   */
+  String getAnimation() const;
+  /**
+   * \brief Retrieves a description of the program.
+   * \return A json representation of the program.
+   */
+  String getScript() const;
+  /**
+   * \brief Retrieves the layout of the LEDs.
+   * \return A json representation of the layout.
+   */
+  String getLayout() const;
   /**
    * \brief Retrieves the base color of the active mode.
    * \return A json representation of the active color.
@@ -142,18 +328,114 @@ class ArduinoPixelServer {
   /**
    * \brief Updates the LED strip based on a request.
    * \param[in] request a http request.
+   * \return False if the request data are invalid, true otherwise.
    */
-  void updateStrip(const RequestData &request);
+  bool updateStrip(const RequestData &request);
   /**
    * \brief Updates the mode and the LED strip.
-   * \param[in]
+   * \param[in] data the name of the mode and, optionally, its period.
+   * \return False if there is no valid mode in the data, true otherwise.
+   */
+  bool updateMode(const String &data);
+  /**
+   * \brief Creates a mode.
+   * \param[in] type the type of the mode.
+   * \param[in] period the period of the mode in ms. With 0, the default
+   * period of the mode is used.
+   * \return The mode, or nullptr if the type is invalid or unavailable, or
+   * the memory for the mode could not be allocated.
+   */
+  mode::ModeBase *createMode(Mode type, unsigned long period) const;
+  /**
+   * \brief Replaces the active mode.
+   * \param[in] mode the new mode. The server takes ownership of it.
+   */
+  void replaceMode(mode::ModeBase *mode);
+  /**
+   * \brief Parses the requested colors and parameters and updates the LED
+   * strip.
+   * \details The data are either a color, e.g. {"r":48,"g":254,"b":176}, or
+   * an object with any of the members "colors", an array of colors for the
+   * colors of the mode in order, "period", the period of the mode in ms, and
+   * "brightness", in [0, 255]. Nothing is updated unless all of them are
+   * valid.
+   * \param[in] json the data in json format.
+   * \return False if the data are invalid, true otherwise.
+   */
+  bool updateColor(const String &json);
+  /**
+   * \brief Replaces the animation of the PLAYBACK mode.
+   * \param[in] data the animation in hex, two digits per byte.
+   * \return False if the animation is invalid or too large, true otherwise.
+   */
+  bool updateAnimation(const String &data);
+  /**
+   * \brief Replaces the program of the SCRIPT mode.
+   * \param[in] data the program in hex, two digits per byte.
+   * \return False if the program is invalid or too large, true otherwise.
    */
-  void updateMode(const String &mode);
+  bool updateScript(const String &data);
   /**
-   * \brief Parses the requested color and updates the LED strip.
-   * \param[in] json the color in json format.
+   * \brief Lays the LEDs out as a matrix.
+   * \details The data are an object with the members "width", the number of
+   * LEDs in a row, and either "height", "serpentine", and "rotation", e.g.
+   * {"width":16,"height":16,"serpentine":true,"rotation":90}, or "map", the
+   * index on the strip of every pixel of the image in hex, 4 digits per
+   * index, little endian.
+   * \param[in] json the data in json format.
+   * \return False if the data are invalid or don't match the number of LEDs,
+   * true otherwise.
    */
-  void updateColor(const String &json);
+  bool updateLayout(const String &json);
+  /**
+   * \brief Lays the LEDs out with a map.
+   * \param[in] hex the index on the strip of every pixel in hex.
+   * \param[in] length the number of digits.
+   * \param[in] width the number of pixels in a row of the image.
+   * \return False if the map is invalid, true otherwise.
+   */
+  bool updateMap(const char *hex, size_t length, int width);
+  /**
+   * \brief Sets parts of the canvas, and switches to the CANVAS mode.
+   * \details The data are either a json array of entries, each [index, r,
+   * g, b] or [first, count, r, g, b], e.g. [[3,255,0,0],[10,5,0,0,255]], or
+   * entries of 7 bytes in hex: the first pixel and the number of pixels (2
+   * bytes each, little endian), and r, g, b. Nothing is set unless all the
+   * entries are valid.
+   * \param[in] data the entries.
+   * \return False if the data are invalid, or the heap can not hold the
+   * canvas, true otherwise.
+   */
+  bool updatePixels(const String &data);
+  /**
+   * \brief Parses the entries of a request to /strip/pixels.
+   * \param[in] text the entries.
+   * \param[in] length the length of the text.
+   * \param[out] canvas the canvas to set, or nullptr to only validate.
+   * \return False if an entry is invalid or out of the strip.
+   */
+  bool parsePixels(const char *text, size_t length,
+                   mode::Canvas *canvas) const;
+  /**
+   * \brief Parses a color, e.g. {"r":48,"g":254,"b":176}.
+   * \param[in] tokenizer the tokenizer of the request data.
+   * \param[in] object the index of the object token.
+   * \param[out] color the color.
+   * \return False if the color is invalid, true otherwise.
+   */
+  bool parseColor(const JsonTokenizer &tokenizer, byte object,
+                  Color &color) const;
+
+  /**
+   * \brief Gets the current state of the device.
+   * \return The state.
+   */
+  DeviceState getState() const;
+  /**
+   * \brief Restores a state of the device.
+   * \param[in] state the state.
+   */
+  void setState(const DeviceState &state);
 
   boolean power_;  // Flag that indicates whether the LED strip is on or off
 
@@ -161,6 +443,28 @@ class ArduinoPixelServer {
 
   mode::ModeBase *mode_;  // Active mode
   mode::SingleColor *mode_off_;  // Mode that turns off the LED strip
+
+  StateStore *state_store_;
+  EventSourceBase *events_;
+  FramePreviewBase *previews_;
+  SamplerBase *sampler_;  // The audio input of the SPECTRUM mode
+
+  boolean dirty_;  // Flag that indicates whether the state has to be rendered
+  unsigned long dirty_time_;  // Time in us of the latest state change
+  unsigned long dirty_frame_time_;  // Time in ms of the latest state render
+  unsigned long frame_time_;  // Time in us of the latest frame
+  unsigned long frame_interval_;  // Time in us between the last two frames
+  FrameStats stats_;
+
+  uint16_t stream_sequence_;  // The sequence number of the latest frame
+
+  Animation animation_;  // The animation of the PLAYBACK mode
+  Program program_;  // The program of the SCRIPT mode
+
+  ClockSync clock_sync_;
+  IPAddress clock_address_;  // Destination of the clock packets of a leader
+  uint16_t clock_port_;  // Port of the followers, 0 if not the leader
+  unsigned long clock_time_;  // Time in ms of the latest clock packet sent
 };
 
 }  // namespace arduino_pixel
@@ -0,0 +1,55 @@
+/*! \file clock.cpp
+ *  \brief Implements the clock of the library.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "clock.h"
+
+namespace arduino_pixel {
+
+bool Clock::virtual_ = false;
+unsigned long Clock::time_ = 0;
+unsigned long Clock::reference_ = 0;
+unsigned long Clock::base_ = 0;
+long Clock::drift_ = 0;
+
+void Clock::setTime(unsigned long time) {
+  time_ = time;
+  virtual_ = true;
+}
+
+void Clock::advance(unsigned long ms) { time_ += ms; }
+
+void Clock::useSystemTime() { virtual_ = false; }
+
+void Clock::setGroupTime(unsigned long local, unsigned long group,
+                         long drift) {
+  reference_ = local;
+  base_ = group;
+  drift_ = drift;
+}
+
+}  // namespace arduino_pixel
@@ -0,0 +1,122 @@
+/*! \file clock.h
+ *  \brief Defines the clock of the library.
+ *  \details The clock follows the system time, or a virtual time that is set
+ *  explicitly, e.g. for a deterministic simulation of the modes.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_CLOCK_H
+#define ARDUINO_PIXEL_CLOCK_H
+
+#include "common_types.h"
+
+namespace arduino_pixel {
+
+/**
+ * \brief Provides the time to the modes and the server.
+ * \details By default, the time is the system time. After setTime, the
+ * clock keeps a virtual time that only moves with setTime and advance. The
+ * modes then produce the same frames on every run, no matter how fast they
+ * are executed.
+ * \par
+ * On top of the local time, the clock keeps a group time that is shared by
+ * a number of devices. The modes derive their phase from the group time, so
+ * devices that are synchronized, e.g. with ClockSync, show one continuous
+ * effect. The group time is the local time until it's set.
+ */
+class Clock {
+ public:
+  /**
+   * \brief Gets the time in ms.
+   */
+  static unsigned long millis() { return virtual_ ? time_ : ::millis(); }
+  /**
+   * \brief Gets the time in us.
+   */
+  static unsigned long micros() {
+    return virtual_ ? time_ * 1000ul : ::micros();
+  }
+  /**
+   * \brief Switches to the virtual time.
+   * \param[in] time the time in ms.
+   */
+  static void setTime(unsigned long time);
+  /**
+   * \brief Moves the virtual time forward.
+   * \param[in] ms the time in ms.
+   */
+  static void advance(unsigned long ms);
+  /**
+   * \brief Switches back to the system time.
+   */
+  static void useSystemTime();
+  /**
+   * \brief Gets the group time in ms.
+   */
+  static unsigned long groupMillis() { return toGroupTime(millis()); }
+  /**
+   * \brief Converts a local time to the group time.
+   * \param[in] local the local time in ms.
+   * \return The group time in ms.
+   */
+  static unsigned long toGroupTime(unsigned long local) {
+    return extrapolate(local, reference_, base_, drift_);
+  }
+  /**
+   * \brief Sets the relation of the group time to the local time.
+   * \param[in] local a local time in ms.
+   * \param[in] group the group time at the local time.
+   * \param[in] drift the rate of the group time relative to the local time,
+   *                  in units of 2^-20 (about 1 ppm).
+   */
+  static void setGroupTime(unsigned long local, unsigned long group,
+                           long drift = 0);
+  /**
+   * \brief Converts a local time to a group time with a linear model.
+   * \param[in] local the local time in ms.
+   * \param[in] reference a local time in ms.
+   * \param[in] base the group time at the reference.
+   * \param[in] drift the rate of the group time relative to the local time,
+   *                  in units of 2^-20.
+   * \return The group time in ms.
+   */
+  static unsigned long extrapolate(unsigned long local, unsigned long reference,
+                                   unsigned long base, long drift) {
+    long elapsed = (long)(local - reference);
+    return base + elapsed + (long)(((int64_t)elapsed * drift) >> 20);
+  }
+
+ private:
+  static bool virtual_;
+  static unsigned long time_;
+  static unsigned long reference_;  // Local time at the base of the group time
+  static unsigned long base_;       // Group time at the reference
+  static long drift_;  // Rate of the group time in units of 2^-20
+};
+
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_CLOCK_H
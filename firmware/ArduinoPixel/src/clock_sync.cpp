@@ -0,0 +1,99 @@
+/*! \file clock_sync.cpp
+ *  \brief Implementation of the synchronization of the group time.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "clock_sync.h"
+
+namespace arduino_pixel {
+
+ClockSync::ClockSync() : sequence_(0) { reset(); }
+
+void ClockSync::reset() {
+  synced_ = false;
+  reference_ = 0;
+  base_ = 0;
+  drift_ = 0;
+  samples_ = 0;
+  best_error_ = 0;
+  best_local_ = 0;
+  skew_ = 0;
+  syncs_ = 0;
+}
+
+bool ClockSync::process(const byte *packet, unsigned long local) {
+  if (packet[0] != 'A' or packet[1] != 'C' or packet[2] != kVersion)
+    return false;
+  unsigned long group = (unsigned long)packet[6] |
+                        ((unsigned long)packet[7] << 8) |
+                        ((unsigned long)packet[8] << 16) |
+                        ((unsigned long)packet[9] << 24);
+  if (not synced_) {
+    reference_ = local;
+    base_ = group;
+    synced_ = true;
+    ++syncs_;
+    return true;
+  }
+
+  long error = (long)(group - toGroupTime(local));
+  if (samples_ == 0 or error > best_error_) {
+    best_error_ = error;
+    best_local_ = local;
+  }
+  if (++samples_ < kWindow) return false;
+  samples_ = 0;
+  skew_ = best_error_;
+  ++syncs_;
+
+  unsigned long best_group = toGroupTime(best_local_) + best_error_;
+  if (best_error_ > kStepThreshold or best_error_ < -kStepThreshold) {
+    drift_ = 0;  // The leader has changed, so start over
+  } else {
+    // A quarter of the rate error, in units of 2^-20, keeps the drift steady
+    // against the jitter of the network
+    long elapsed = (long)(best_local_ - reference_);
+    if (elapsed > 0)
+      drift_ = constrain(drift_ + best_error_ * (1L << 18) / elapsed,
+                         -kMaxDrift, kMaxDrift);
+  }
+  reference_ = best_local_;
+  base_ = best_group;
+  return true;
+}
+
+void ClockSync::encode(byte *packet, unsigned long group) {
+  packet[0] = 'A';
+  packet[1] = 'C';
+  packet[2] = kVersion;
+  packet[3] = 0;
+  packet[4] = sequence_ & 0xFF;
+  packet[5] = sequence_ >> 8;
+  for (byte i = 0; i < 4; ++i) packet[6 + i] = (group >> (8 * i)) & 0xFF;
+  ++sequence_;
+}
+
+}  // namespace arduino_pixel
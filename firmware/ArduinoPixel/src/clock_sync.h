@@ -0,0 +1,123 @@
+/*! \file clock_sync.h
+ *  \brief Defines a synchronization of the group time among devices.
+ *  \details A leader broadcasts its group time, and the followers estimate the
+ *  offset and the drift of their clock to it.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_CLOCK_SYNC_H
+#define ARDUINO_PIXEL_CLOCK_SYNC_H
+
+#include "clock.h"
+
+namespace arduino_pixel {
+
+/**
+ * \brief Estimates the group time from the packets of a leader.
+ * \details A clock packet holds, all values little endian:
+ *   0-1: "AC"
+ *   2: version
+ *   3: flags (unused)
+ *   4-5: the sequence number of the packet
+ *   6-9: the group time of the leader in ms
+ * \par
+ * A packet is delayed by the network, but never arrives early. So, of every
+ * kWindow packets, the one that shows the group time furthest ahead of the
+ * estimate is the least delayed, and its error corrects the estimate. The
+ * offset is corrected in full, and the drift by a quarter of the error over
+ * the time since the last correction. An error over kStepThreshold, e.g. from a
+ * new leader, resets the estimate.
+ */
+class ClockSync {
+ public:
+  static const byte kPacketSize = 10;
+  static const byte kVersion = 1;
+  static const byte kWindow = 4;  // The number of packets per correction
+  static const long kStepThreshold = 100;  // ms
+  static const long kMaxDrift = 10486;  // 1% in units of 2^-20
+
+  ClockSync();
+
+  /**
+   * \brief Forgets the estimate.
+   */
+  void reset();
+  /**
+   * \brief Takes a packet of the leader into account.
+   * \param[in] packet a clock packet of kPacketSize bytes.
+   * \param[in] local the local time in ms at the arrival of the packet.
+   * \return Whether the estimate changed.
+   */
+  bool process(const byte *packet, unsigned long local);
+  /**
+   * \brief Writes a clock packet, for a leader.
+   * \param[out] packet buffer of kPacketSize bytes.
+   * \param[in] group the group time in ms.
+   */
+  void encode(byte *packet, unsigned long group);
+  /**
+   * \brief Applies the estimate to the Clock.
+   */
+  void apply() const { Clock::setGroupTime(reference_, base_, drift_); }
+  /**
+   * \brief Converts a local time to the estimated group time.
+   * \param[in] local the local time in ms.
+   * \return The group time in ms.
+   */
+  unsigned long toGroupTime(unsigned long local) const {
+    return Clock::extrapolate(local, reference_, base_, drift_);
+  }
+
+  bool isSynced() const { return synced_; }
+
+  /**
+   * \brief Gets the drift of the local clock in ppm.
+   */
+  long getDrift() const { return drift_ * 15625 / 16384; }  // 10^6 / 2^20
+
+  /**
+   * \brief Gets the error of the estimate at the latest correction in ms.
+   */
+  long getSkew() const { return skew_; }
+
+  unsigned long getSyncs() const { return syncs_; }
+
+ private:
+  bool synced_;
+  uint16_t sequence_;        // Sequence number of the next packet to send
+  unsigned long reference_;  // Local time at the base of the estimate
+  unsigned long base_;       // Group time at the reference
+  long drift_;               // Rate of the group time in units of 2^-20
+  byte samples_;             // Number of packets in the current window
+  long best_error_;          // Largest error in the current window
+  unsigned long best_local_;  // Local time of the packet with that error
+  long skew_;
+  unsigned long syncs_;  // Number of corrections
+};
+
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_CLOCK_SYNC_H
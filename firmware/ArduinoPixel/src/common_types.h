@@ -43,21 +43,68 @@ enum class Mode : byte {
   SINGLE_COLOR,
   SCANNER,
   RAINBOW,
-  RAINBOW_CYCLE
+  RAINBOW_CYCLE,
+  GRADIENT,
+  GRADIENT_SCROLL,
+  STREAM,
+  PLAYBACK,
+  SCRIPT,
+  CANVAS,
+  NOISE,
+  FIRE,
+  TWINKLE,
+  SPECTRUM
 };
 
-inline String toString(Mode mode) {
+inline const __FlashStringHelper *toString(Mode mode) {
   switch (mode) {
     case Mode::SINGLE_COLOR:
-      return String("SINGLE_COLOR");
+      return F("SINGLE_COLOR");
     case Mode::SCANNER:
-      return String("SCANNER");
+      return F("SCANNER");
     case Mode::RAINBOW:
-      return String("RAINBOW");
+      return F("RAINBOW");
     case Mode::RAINBOW_CYCLE:
-      return String("RAINBOW_CYCLE");
+      return F("RAINBOW_CYCLE");
+    case Mode::GRADIENT:
+      return F("GRADIENT");
+    case Mode::GRADIENT_SCROLL:
+      return F("GRADIENT_SCROLL");
+    case Mode::STREAM:
+      return F("STREAM");
+    case Mode::PLAYBACK:
+      return F("PLAYBACK");
+    case Mode::SCRIPT:
+      return F("SCRIPT");
+    case Mode::CANVAS:
+      return F("CANVAS");
+    case Mode::NOISE:
+      return F("NOISE");
+    case Mode::FIRE:
+      return F("FIRE");
+    case Mode::TWINKLE:
+      return F("TWINKLE");
+    case Mode::SPECTRUM:
+      return F("SPECTRUM");
     default:
-      return String("INVALID");
+      return F("INVALID");
+  }
+}
+
+/**
+ * \brief Tells whether a mode is animated with a period.
+ * \details A static or externally driven mode renders on demand, so
+ * rebuilding it for a period would only throw away its pixels.
+ */
+inline bool hasPeriod(Mode mode) {
+  switch (mode) {
+    case Mode::SINGLE_COLOR:
+    case Mode::GRADIENT:
+    case Mode::STREAM:
+    case Mode::CANVAS:
+      return false;
+    default:
+      return true;
   }
 }
 
@@ -77,6 +124,34 @@ struct Color {
   byte blue;
 };
 
+/**
+ * \brief Decodes hex digits to bytes.
+ * \param[in] hex the hex digits, two per byte.
+ * \param[in] length the number of digits.
+ * \param[out] data the bytes.
+ * \param[in] capacity the maximum number of bytes.
+ * \return The number of bytes, or -1 if the digits are invalid or the bytes
+ * don't fit.
+ */
+inline long parseHex(const char *hex, size_t length, byte *data,
+                     size_t capacity) {
+  if (length % 2 or length / 2 > capacity) return -1;
+  for (size_t i = 0; i < length; ++i) {
+    char c = hex[i];
+    byte value;
+    if (c >= '0' and c <= '9')
+      value = c - '0';
+    else if (c >= 'a' and c <= 'f')
+      value = c - 'a' + 10;
+    else if (c >= 'A' and c <= 'F')
+      value = c - 'A' + 10;
+    else
+      return -1;
+    data[i / 2] = (i % 2) ? (data[i / 2] | value) : (value << 4);
+  }
+  return length / 2;
+}
+
 }  // namespace arduino_pixel
 
 #endif  // ARDUINO_PIXEL_COMMON_TYPES_H
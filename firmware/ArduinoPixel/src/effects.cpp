@@ -0,0 +1,113 @@
+/*! \file effects.cpp
+ *  \brief Implements integer kernels for procedural effects.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "effects.h"
+
+namespace arduino_pixel {
+
+namespace {
+
+// A permutation of [0, 255], which hashes the integer points to values
+const byte kPermutation[256] PROGMEM = {
+    236, 142,   8,  71,  24, 193,  26,  42,  73, 206, 103, 234,
+    127, 150, 244,  80,  72, 121, 110, 171, 168,   0, 184, 109,
+     89,  88, 228,  76, 246,   6, 148,  22, 177,  58,  84, 211,
+    238, 252, 248, 169,  50, 157,   7, 227, 251,  18,   4,  85,
+     51, 108,   2,   3,  30, 120, 231, 213, 178, 196, 132, 188,
+     46,  67,  60,  11,  41,  66,  63, 115, 249, 229,  32, 104,
+     55, 176, 210,  98, 163,  23,  28, 253, 161,  25,  69, 232,
+    175, 102,  45, 255, 183,  75,  12, 145, 200,  54, 170,  47,
+    152, 254, 242, 239, 223,  21, 216, 126,  81, 173, 164,  34,
+    112, 137,  93,  95,  33, 160, 111,   5,  40,  15,  14,  10,
+    245, 118, 224, 204, 116, 146,  86, 162, 154,  78,  48, 189,
+    237,  65, 144, 190, 124, 138,  96, 243, 119, 123, 165, 143,
+    230, 191, 215,  94, 186, 195,  43, 225,  91,  37, 212, 105,
+    155,   9,  44, 149, 147, 250,  97,  64,  31,  39,  83,  57,
+     79, 135, 159,  19, 122, 182, 220, 198, 107,  92, 222, 139,
+     52, 106, 247, 209, 207, 140, 114, 240, 156,  13,  38, 158,
+    241, 221, 166,  16,  74, 179,  90, 235, 129, 125, 181, 199,
+    174, 201,  56, 192,  77, 205,  27, 151, 141,  99, 128, 167,
+    208, 133, 180,  59,  70,  35,  49, 219,  36, 194, 203, 233,
+     68, 218,  20, 197,   1,  62, 172, 134, 185, 100, 153, 226,
+     61,  29, 214, 136, 117, 131, 217,  17, 187,  53, 130,  82,
+    202,  87, 113, 101};
+
+// The smoothstep 3t^2 - 2t^3 for t in [0, 1) in 1/256
+const byte kEase[256] PROGMEM = {
+      0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,   1,
+      2,   2,   2,   3,   3,   3,   4,   4,   4,   5,   5,   6,
+      6,   7,   7,   8,   9,   9,  10,  10,  11,  12,  12,  13,
+     14,  14,  15,  16,  17,  18,  18,  19,  20,  21,  22,  23,
+     24,  25,  25,  26,  27,  28,  29,  30,  31,  32,  33,  35,
+     36,  37,  38,  39,  40,  41,  42,  43,  45,  46,  47,  48,
+     49,  51,  52,  53,  54,  56,  57,  58,  59,  61,  62,  63,
+     65,  66,  67,  69,  70,  71,  73,  74,  75,  77,  78,  80,
+     81,  82,  84,  85,  87,  88,  90,  91,  92,  94,  95,  97,
+     98, 100, 101, 103, 104, 106, 107, 109, 110, 112, 113, 115,
+    116, 118, 119, 121, 122, 124, 125, 127, 128, 129, 131, 132,
+    134, 135, 137, 138, 140, 141, 143, 144, 146, 147, 149, 150,
+    152, 153, 155, 156, 158, 159, 161, 162, 164, 165, 166, 168,
+    169, 171, 172, 174, 175, 176, 178, 179, 181, 182, 183, 185,
+    186, 187, 189, 190, 191, 193, 194, 195, 197, 198, 199, 200,
+    202, 203, 204, 205, 207, 208, 209, 210, 211, 213, 214, 215,
+    216, 217, 218, 219, 220, 221, 223, 224, 225, 226, 227, 228,
+    229, 230, 231, 231, 232, 233, 234, 235, 236, 237, 238, 238,
+    239, 240, 241, 242, 242, 243, 244, 244, 245, 246, 246, 247,
+    247, 248, 249, 249, 250, 250, 251, 251, 252, 252, 252, 253,
+    253, 253, 254, 254, 254, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255};
+
+inline byte permute(byte i) { return pgm_read_byte(kPermutation + i); }
+
+inline byte ease(byte t) { return pgm_read_byte(kEase + t); }
+
+}  // namespace
+
+byte noise8(uint16_t x) {
+  byte i = x >> 8;
+  return lerp8(permute(i), permute(i + 1), ease(x & 255));
+}
+
+byte noise8(uint16_t x, uint16_t y) {
+  byte i = x >> 8, j = y >> 8;
+  byte a = permute(i) + j, b = permute(i + 1) + j;
+  byte tx = ease(x & 255);
+  byte top = lerp8(permute(a), permute(b), tx);
+  byte bottom = lerp8(permute(a + 1), permute(b + 1), tx);
+  return lerp8(top, bottom, ease(y & 255));
+}
+
+Color heatColor(byte heat) {
+  byte t = scale8(heat, 191);  // Three thirds of 64
+  byte ramp = (t & 63) << 2;
+  if (t & 128) return Color(255, 255, ramp);
+  if (t & 64) return Color(255, ramp, 0);
+  return Color(ramp, 0, 0);
+}
+
+}  // namespace arduino_pixel
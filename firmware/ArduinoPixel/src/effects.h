@@ -0,0 +1,186 @@
+/*! \file effects.h
+ *  \brief Defines integer kernels for procedural effects.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_EFFECTS_H
+#define ARDUINO_PIXEL_EFFECTS_H
+
+#include "common_types.h"
+
+namespace arduino_pixel {
+
+/**
+ * \brief Generates pseudorandom bytes.
+ * \details A 16-bit linear congruential generator, whose two bytes are
+ * added for the output, so a number costs a 16-bit multiply and an add.
+ * A generator that is seeded with the same value produces the same numbers.
+ */
+class Random8 {
+ public:
+  explicit Random8(uint16_t seed = 1) : state_(seed) {}
+
+  void seed(uint16_t seed) { state_ = seed; }
+  /**
+   * \brief Gets the next number.
+   * \return A number in [0, 255].
+   */
+  byte next() {
+    state_ = state_ * 2053 + 13849;
+    return (byte)(state_ + (state_ >> 8));
+  }
+  /**
+   * \brief Gets the next number below a limit.
+   * \param[in] limit the limit.
+   * \return A number in [0, limit).
+   */
+  byte next(byte limit) { return ((uint16_t)next() * limit) >> 8; }
+  /**
+   * \brief Gets the next number in a range.
+   * \param[in] low the lower bound.
+   * \param[in] high the upper bound.
+   * \return A number in [low, high).
+   */
+  byte next(byte low, byte high) { return low + next(high - low); }
+  /**
+   * \brief Gets the next 16-bit number.
+   * \return A number in [0, 65535].
+   */
+  uint16_t next16() {
+    state_ = state_ * 2053 + 13849;
+    return state_;
+  }
+
+ private:
+  uint16_t state_;
+};
+
+/**
+ * \brief Scales a value by a fraction.
+ * \param[in] value the value.
+ * \param[in] scale the fraction in 1/256, where 255 keeps the value.
+ * \return The scaled value.
+ */
+inline byte scale8(byte value, byte scale) {
+  return ((uint16_t)value * (1 + scale)) >> 8;
+}
+
+/**
+ * \brief Adds two values, saturating at 255.
+ */
+inline byte qadd8(byte a, byte b) {
+  uint16_t sum = a + b;
+  return sum > 255 ? 255 : sum;
+}
+
+/**
+ * \brief Subtracts two values, saturating at 0.
+ */
+inline byte qsub8(byte a, byte b) { return a > b ? a - b : 0; }
+
+/**
+ * \brief Interpolates between two values.
+ * \param[in] a the value at 0.
+ * \param[in] b the value at 256.
+ * \param[in] t the position in 1/256.
+ * \return The value at the position.
+ */
+inline byte lerp8(byte a, byte b, byte t) {
+  return (b >= a) ? a + (((uint16_t)(b - a) * t) >> 8)
+                  : a - (((uint16_t)(a - b) * t) >> 8);
+}
+
+/**
+ * \brief Interpolates between two colors.
+ * \param[in] a the color at 0.
+ * \param[in] b the color at 256.
+ * \param[in] t the position in 1/256.
+ * \return The color at the position.
+ */
+inline Color lerpColor(const Color &a, const Color &b, byte t) {
+  return Color(lerp8(a.red, b.red, t), lerp8(a.green, b.green, t),
+               lerp8(a.blue, b.blue, t));
+}
+
+/**
+ * \brief Scales the channels of a color by a fraction.
+ * \param[in] color the color.
+ * \param[in] scale the fraction in 1/256, where 255 keeps the color.
+ * \return The scaled color.
+ */
+inline Color scaleColor(const Color &color, byte scale) {
+  return Color(scale8(color.red, scale), scale8(color.green, scale),
+               scale8(color.blue, scale));
+}
+
+/**
+ * \brief Gets the color at a position of a gradient.
+ * \details The colors are evenly spaced from 0 to 255. A single color is
+ * scaled by the position instead.
+ * \param[in] colors the colors of the gradient.
+ * \param[in] num_colors the number of colors, at least 1.
+ * \param[in] position the position.
+ * \return The color.
+ */
+inline Color gradientColor(const Color *colors, byte num_colors,
+                           byte position) {
+  if (num_colors == 1) return scaleColor(colors[0], position);
+  // The position in 1/256 of the distance between two colors
+  uint16_t t = (uint16_t)position * (num_colors - 1);
+  byte first = t >> 8;
+  return lerpColor(colors[first], colors[first + 1], t & 255);
+}
+
+/**
+ * \brief Gets the value noise at a point of a line.
+ * \details The values at the integer points are random, and the points in
+ * between are interpolated with a smoothstep, which is read from a table.
+ * A value costs 3 table reads and a multiply.
+ * \param[in] x the point in 8.8 fixed point, i.e. 256 per integer point.
+ * \return A value in [0, 255], which repeats every 256 integer points.
+ */
+byte noise8(uint16_t x);
+
+/**
+ * \brief Gets the value noise at a point of a plane.
+ * \details A value costs 8 table reads and 3 multiplies.
+ * \param[in] x the column in 8.8 fixed point.
+ * \param[in] y the row in 8.8 fixed point.
+ * \return A value in [0, 255].
+ */
+byte noise8(uint16_t x, uint16_t y);
+
+/**
+ * \brief Gets the color of a heat.
+ * \details The colors go from black through red and yellow to white.
+ * \param[in] heat the heat.
+ * \return The color.
+ */
+Color heatColor(byte heat);
+
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_EFFECTS_H
@@ -0,0 +1,133 @@
+/*! \file event_source.h
+ *  \brief Defines the subscribers of the server-sent events.
+ *  \details The state changes are pushed to the subscribers over connections
+ *  that stay open, instead of the clients polling for them.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_EVENT_SOURCE_H
+#define ARDUINO_PIXEL_EVENT_SOURCE_H
+
+#include <Client.h>
+
+#include "common_types.h"
+
+// The time in ms between two keepalive comments to the subscribers. Writing
+// to a connection is what detects that it's closed.
+#ifndef ARDUINO_PIXEL_EVENT_KEEPALIVE
+#define ARDUINO_PIXEL_EVENT_KEEPALIVE 15000
+#endif
+
+namespace arduino_pixel {
+
+/**
+ * \brief Interface of the subscribers of the server-sent events.
+ */
+class EventSourceBase {
+ public:
+  virtual ~EventSourceBase() {}
+  /**
+   * \brief Keeps the connection of a client open for the events.
+   * \param[in] client client that requested the events.
+   * \return False if all slots are taken, true otherwise.
+   */
+  virtual bool subscribe(Client &client) = 0;
+  /**
+   * \brief Sends an event to all subscribers.
+   * \details A subscriber that has disconnected, or that can't take the
+   * entire event, is dropped, so a stalled connection doesn't hold the
+   * strip back.
+   * \param[in] data the serialized event.
+   * \param[in] length the length of the event.
+   */
+  virtual void publish(const char *data, size_t length) = 0;
+  /**
+   * \brief Sends a keepalive comment, if it's due.
+   * \param[in] time the time in ms.
+   */
+  virtual void update(unsigned long time) = 0;
+
+  virtual byte getNumSubscribers() const = 0;
+};
+
+/**
+ * \brief Keeps up to N subscribers of the server-sent events.
+ * \details The connections are kept by value, so ClientT must be the type
+ * of the clients that are passed to ArduinoPixelServer::processRequest, e.g.
+ * WiFiClient or EthernetClient.
+ */
+template <typename ClientT, byte N>
+class EventSource : public EventSourceBase {
+ public:
+  EventSource() : write_time_(0) {
+    for (byte i = 0; i < N; ++i) active_[i] = false;
+  }
+
+  virtual ~EventSource() {}
+
+  virtual bool subscribe(Client &client) override {
+    for (byte i = 0; i < N; ++i) {
+      if (active_[i] and clients_[i].connected()) continue;
+      if (active_[i]) clients_[i].stop();
+      clients_[i] = static_cast<ClientT &>(client);
+      active_[i] = true;
+      return true;
+    }
+    return false;
+  }
+
+  virtual void publish(const char *data, size_t length) override {
+    for (byte i = 0; i < N; ++i) {
+      if (not active_[i]) continue;
+      if (not clients_[i].connected() or
+          clients_[i].write((const uint8_t *)data, length) != length) {
+        clients_[i].stop();
+        active_[i] = false;
+      }
+    }
+  }
+
+  virtual void update(unsigned long time) override {
+    if (time - write_time_ < ARDUINO_PIXEL_EVENT_KEEPALIVE) return;
+    publish(":\n\n", 3);
+    write_time_ = time;
+  }
+
+  virtual byte getNumSubscribers() const override {
+    byte count = 0;
+    for (byte i = 0; i < N; ++i) count += active_[i];
+    return count;
+  }
+
+ private:
+  ClientT clients_[N];
+  bool active_[N];
+  unsigned long write_time_;  // Time in ms of the latest keepalive
+};
+
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_EVENT_SOURCE_H
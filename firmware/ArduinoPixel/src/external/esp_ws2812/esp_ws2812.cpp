@@ -35,20 +35,45 @@
 TimingParams params;
 xSemaphoreHandle ws2812_sem = NULL;
 uint8_t *ws2812_buffer = NULL;
+uint8_t *ws2812_palette = NULL;  // Wire ordered colors of an indexed buffer
+uint8_t ws2812_palette_bits = 0;
+uint8_t ws2812_channels = 3;
 
 extern RmtPulsePair ws2812_bitval_to_rmt_map[2];
 extern uint16_t ws2812_pos, ws2812_len, ws2812_half;
 
 static intr_handle_t rmt_intr_handle = NULL;
 
-Ws2812::Ws2812(int num_leds, int pin, LedType type)
-    : num_leds_(num_leds), pin_(pin), type_(type) {}
-
-Ws2812::~Ws2812() { delete[] ws2812_buffer; }
+Ws2812::Ws2812(int num_leds, int pin, LedType type, uint8_t channels,
+               uint8_t palette_bits)
+    : num_leds_(num_leds),
+      pin_(pin),
+      type_(type),
+      channels_(channels),
+      palette_bits_((palette_bits == 4 || palette_bits == 8) ? palette_bits
+                                                             : 0),
+      pixels_(NULL),
+      palette_(NULL) {}
+
+Ws2812::~Ws2812() {
+  delete[] ws2812_buffer;
+  delete[] ws2812_palette;
+}
 
 int Ws2812::init() {
-  ws2812_len = (3 * num_leds_) * sizeof(uint8_t);
-  ws2812_buffer = new uint8_t[ws2812_len];
+  // The length of the stream on the wire. An indexed buffer is expanded
+  // through the palette while the RMT block is filled
+  ws2812_len = (channels_ * num_leds_) * sizeof(uint8_t);
+  ws2812_channels = channels_;
+  ws2812_palette_bits = palette_bits_;
+  if (palette_bits_) {
+    ws2812_buffer = new uint8_t[(num_leds_ * palette_bits_ + 7) / 8]();
+    ws2812_palette = new uint8_t[channels_ * paletteSize()]();
+  } else {
+    ws2812_buffer = new uint8_t[ws2812_len]();
+  }
+  pixels_ = ws2812_buffer;
+  palette_ = ws2812_palette;
 #ifdef DEBUG_WS2812_DRIVER
   debug_buffer = (char *)calloc(debug_buffer_size, sizeof(char));
 #endif
@@ -109,13 +134,19 @@ int Ws2812::init() {
   return 0;
 }
 
-void Ws2812::setPixelColor(uint16_t i, uint8_t red, uint8_t green,
-                           uint8_t blue) {
-  // Color order is mapped from RGB to GRB for WS2812
-  uint16_t offset = 3 * i;
-  ws2812_buffer[offset + 0] = green;
-  ws2812_buffer[offset + 1] = red;
-  ws2812_buffer[offset + 2] = blue;
+void Ws2812::setPixelIndex(uint16_t i, uint8_t entry) {
+  if (palette_bits_ == 8) {
+    ws2812_buffer[i] = entry;
+  } else {  // Two pixels per byte, the even one in the low nibble
+    uint8_t shift = (i & 1) << 2;
+    uint8_t &pair = ws2812_buffer[i >> 1];
+    pair = (pair & ~(0x0F << shift)) | ((entry & 0x0F) << shift);
+  }
+}
+
+uint8_t Ws2812::getPixelIndex(uint16_t i) const {
+  if (palette_bits_ == 8) return ws2812_buffer[i];
+  return (ws2812_buffer[i >> 1] >> ((i & 1) << 2)) & 0x0F;
 }
 
 void Ws2812::show() {
@@ -34,26 +34,60 @@
 
 #include "external/esp_ws2812/esp_ws2812_rmt.h"
 
+// The pixels are bytes in the order on the wire. The caller encodes the colors,
+// e.g. with a PixelEncoder, so the driver doesn't depend on the format.
 class Ws2812 {
  public:
   enum class LedType : uint8_t { NONE, WS2812, WS2812B, SK6812, WS2813 };
 
-  Ws2812(int num_leds, int pin, LedType type);
+  /**
+   * \param[in] num_leds number of LEDs.
+   * \param[in] pin data pin.
+   * \param[in] type LED type.
+   * \param[in] channels bytes per pixel on the wire, e.g. 4 for SK6812 RGBW
+   * LEDs.
+   * \param[in] palette_bits bits per pixel of an indexed buffer (4 or 8). With
+   * 0, the buffer stores the color of every pixel.
+   */
+  Ws2812(int num_leds, int pin, LedType type, uint8_t channels = 3,
+         uint8_t palette_bits = 0);
 
   ~Ws2812();
   
   int init();
-  
-  void setPixelColor(uint16_t i, uint8_t red, uint8_t green, uint8_t blue);
+
+  void setPixelIndex(uint16_t i, uint8_t entry);
+
+  uint8_t getPixelIndex(uint16_t i) const;
 
   void show();
 
   int numPixels() const { return num_leds_; }
 
+  int paletteSize() const { return palette_bits_ ? 1 << palette_bits_ : 0; }
+
+  uint8_t getChannels() const { return channels_; }
+
+  // The pixels, or the indices of an indexed buffer
+  uint8_t *getPixels() const { return pixels_; }
+
+  // The colors of the palette, channels bytes each
+  uint8_t *getPalette() const { return palette_; }
+
+  // The size of a pixel in the buffer, or 0 if pixels share bytes
+  int getBytesPerPixel() const {
+    if (palette_bits_) return palette_bits_ / 8;
+    return channels_;
+  }
+
  private:
   int num_leds_;
   int pin_;
   LedType type_;
+  uint8_t channels_;
+  uint8_t palette_bits_;
+  uint8_t *pixels_;
+  uint8_t *palette_;
 };
 
 #endif  // ESP32
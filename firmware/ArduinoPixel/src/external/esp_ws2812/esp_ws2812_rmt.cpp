@@ -49,9 +49,26 @@ uint16_t ws2812_pos, ws2812_len, ws2812_half;
 extern TimingParams params;
 extern xSemaphoreHandle ws2812_sem;
 extern uint8_t *ws2812_buffer;
+extern uint8_t *ws2812_palette;
+extern uint8_t ws2812_palette_bits;
+extern uint8_t ws2812_channels;
 
 static uint16_t ws2812_buf_is_dirty;
 
+// Gets a byte of the stream on the wire. The pixels of an indexed buffer are
+// expanded through the palette on the fly
+static inline uint8_t getWireByte(uint16_t pos) {
+  if (!ws2812_palette_bits) return ws2812_buffer[pos];
+  uint16_t pixel = pos / ws2812_channels;
+  uint8_t channel = pos - ws2812_channels * pixel;
+  uint8_t entry;
+  if (ws2812_palette_bits == 8)
+    entry = ws2812_buffer[pixel];
+  else
+    entry = (ws2812_buffer[pixel >> 1] >> ((pixel & 1) << 2)) & 0x0F;
+  return ws2812_palette[ws2812_channels * entry + channel];
+}
+
 void initRMTChannel(int rmtChannel) {
   RMT.apb_conf.fifo_mask = 1;  // Enable memory access, instead of FIFO mode
   RMT.apb_conf.mem_tx_wrap_en = 1;  // Wrap around when hitting end of buffer
@@ -92,7 +109,7 @@ void copyToRmtBlock_half() {
 
   uint16_t i;
   for (i = 0; i < len; ++i) {
-    uint16_t byteval = ws2812_buffer[i + ws2812_pos];
+    uint16_t byteval = getWireByte(i + ws2812_pos);
 
 #ifdef DEBUG_WS2812_DRIVER
     snprintf(debug_buffer, debug_buffer_size, "%s%d(", debug_buffer, byteval);
@@ -0,0 +1,405 @@
+/*! \file frame_buffer.h
+ *  \brief Defines the frame buffer that the modes render into.
+ *  \details The LED strip owns the only copy of the pixels. Modes write the
+ *  pixels of each frame directly into it, so no mode keeps a copy of its own.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_FRAME_BUFFER_H
+#define ARDUINO_PIXEL_FRAME_BUFFER_H
+
+#include "common_types.h"
+
+namespace arduino_pixel {
+
+class FrameBuffer {
+ public:
+  virtual ~FrameBuffer() { delete[] loads_; }
+  /**
+   * \brief Gets the number of pixels in the frame.
+   * \return The number of pixels.
+   */
+  virtual int getNumLeds() const = 0;
+  /**
+   * \brief Gets the width of the frame.
+   * \details The pixels are indexed in rows, i.e. the pixel (x, y) has the
+   * index y * width + x. A strip that isn't laid out as a matrix is a single
+   * row.
+   * \return The number of pixels in a row.
+   */
+  int getWidth() const { return width_ ? width_ : getNumLeds(); }
+  /**
+   * \brief Gets the height of the frame.
+   * \return The number of rows.
+   */
+  int getHeight() const { return width_ ? getNumLeds() / width_ : 1; }
+  /**
+   * \brief Gets the color of a pixel.
+   * \param[in] idx the index of the pixel.
+   * \return The color of the pixel, as it's sent to the strip, i.e. scaled by
+   * the brightness.
+   */
+  Color getPixel(int idx) const { return readPixel(physical(idx)); }
+  /**
+   * \brief Gets the color of a pixel of the matrix.
+   * \param[in] x the column of the pixel.
+   * \param[in] y the row of the pixel.
+   * \return The color of the pixel.
+   */
+  Color getPixel(int x, int y) const { return getPixel(y * getWidth() + x); }
+  /**
+   * \brief Sets the color of a pixel.
+   * \param[in] idx the index of the pixel.
+   * \param[in] color the color of the pixel.
+   */
+  void setPixel(int idx, const Color &color) {
+    Color scaled = scale(color);
+    if (metered_) meter(idx, scaled);
+    writePixel(physical(idx), scaled);
+  }
+  /**
+   * \brief Sets the color of a pixel of the matrix.
+   * \param[in] x the column of the pixel.
+   * \param[in] y the row of the pixel.
+   * \param[in] color the color of the pixel.
+   */
+  void setPixel(int x, int y, const Color &color) {
+    setPixel(y * getWidth() + x, color);
+  }
+  /**
+   * \brief Sets the color of a range of pixels.
+   * \param[in] color the color of the pixels.
+   * \param[in] first the index of the first pixel.
+   * \param[in] count the number of pixels. A negative value fills the frame
+   * up to its end.
+   */
+  void fill(const Color &color, int first = 0, int count = -1) {
+    int last = (count < 0) ? getNumLeds() : first + count;
+    Color scaled = scale(color);
+    for (int idx = first; idx < last; ++idx) {
+      if (metered_) meter(idx, scaled);
+      writePixel(physical(idx), scaled);
+    }
+  }
+  /**
+   * \brief Rotates the pixels along the frame.
+   * \details The pixels that move past the end of the frame reappear at its
+   * beginning. Modes that move a precomputed image can rotate it instead of
+   * redrawing it.
+   * \param[in] count the number of positions that every pixel moves towards
+   * the end of the frame. A negative value moves the pixels towards the
+   * beginning.
+   */
+  void rotate(int count) {
+    int num_leds = getNumLeds();
+    if (num_leds == 0) return;
+    count %= num_leds;
+    if (count < 0) count += num_leds;
+    if (count == 0) return;
+    if (index_map_)
+      FrameBuffer::rotatePixels(count);  // The storage isn't in pixel order
+    else
+      rotatePixels(count);
+    if (loads_) rotateBytes(loads_, num_leds, count);
+  }
+  /**
+   * \brief Sets the brightness.
+   * \details The colors are scaled as they're written, so the brightness
+   * applies to the pixels that are set from then on.
+   * \param[in] brightness the brightness in [0, 255].
+   */
+  void setBrightness(byte brightness) {
+    brightness_ = brightness;
+    updateFactor();
+  }
+  /**
+   * \brief Gets the brightness.
+   * \return The brightness.
+   */
+  byte getBrightness() const { return brightness_; }
+  /**
+   * \brief Gets the load of the frame.
+   * \details The load is the sum of the mean of the red, green, and blue of
+   * every pixel, as it's sent to the strip, i.e. 255 for a white pixel. It's
+   * kept only while the frame buffer is metered.
+   * \return The load, or 0 if the frame buffer isn't metered.
+   */
+  uint32_t getLoad() {
+    if (stale_) countLoad();
+    return load_;
+  }
+  /**
+   * \brief Gets the limit that scales the colors on top of the brightness.
+   * \return The limit in [0, 255], 255 if the colors aren't limited.
+   */
+  byte getLimit() const { return limit_; }
+
+  /**
+   * \brief Gets the number of colors in the palette.
+   * \details A frame buffer with a palette stores an index to the palette
+   * for every pixel, instead of the color itself. Modes that use only a few
+   * colors may opt in by drawing palette indices with setPixelIndex, and
+   * change all pixels of a color at once with setPaletteColor. The colors
+   * that are drawn with setPixel are quantized to the palette.
+   * \return The number of colors, or 0 if the frame buffer stores colors.
+   */
+  virtual int getPaletteSize() const { return 0; }
+  /**
+   * \brief Sets a color in the palette.
+   * \param[in] entry the index of the color in the palette.
+   * \param[in] color the color.
+   */
+  void setPaletteColor(int entry, const Color &color) {
+    writePaletteColor(entry, scale(color));
+    stale_ = metered_;
+  }
+  /**
+   * \brief Sets the palette index of a pixel.
+   * \param[in] idx the index of the pixel.
+   * \param[in] entry the index of the color in the palette.
+   */
+  void setPixelIndex(int idx, byte entry) {
+    writePixelIndex(physical(idx), entry);
+    stale_ = metered_;
+  }
+  /**
+   * \brief Restores the default palette.
+   * \note The strip calls this before a mode redraws the entire frame, so
+   * modes that don't opt in to the palette are quantized consistently.
+   */
+  virtual void resetPalette() {}
+
+ protected:
+  FrameBuffer()
+      : brightness_(255),
+        limit_(255),
+        factor_(256),
+        metered_(false),
+        palette_(false),
+        stale_(false),
+        loads_(nullptr),
+        load_(0),
+        index_map_(nullptr),
+        width_(0) {}
+
+  /**
+   * \brief Starts or stops metering the load of the frame.
+   * \details The load of every pixel is kept in a byte, and a metered write
+   * replaces the load of its pixel in the sum, so the load stays up to date
+   * at the cost of a few operations per write, instead of a pass over the
+   * frame. The pixels of a frame buffer with a palette change with the
+   * palette, so its load is counted again on the frames that change instead.
+   * \param[in] metered flag to indicate whether to keep the load.
+   * \return False if there is no memory for the loads of the pixels.
+   */
+  bool setMetered(bool metered) {
+    delete[] loads_;
+    loads_ = nullptr;
+    metered_ = false;
+    palette_ = metered and getPaletteSize();
+    load_ = 0;
+    stale_ = false;
+    if (not metered) return true;
+    if (not palette_) {
+      int num_leds = getNumLeds();
+      loads_ = new byte[num_leds];
+      if (not loads_) return false;
+      memset(loads_, 0, num_leds);
+    }
+    metered_ = true;
+    stale_ = true;  // Counted when it's needed, e.g. after the strip starts
+    return true;
+  }
+  /**
+   * \brief Sets the limit that scales the colors on top of the brightness.
+   * \details Like the brightness, the limit applies to the pixels that are
+   * set from then on.
+   * \param[in] limit the limit in [0, 255].
+   */
+  void setLimit(byte limit) {
+    limit_ = limit;
+    updateFactor();
+  }
+  /**
+   * \brief Scales the pixels of the frame in place.
+   * \param[in] ratio the ratio in 1/256, e.g. 128 halves the colors.
+   */
+  void scalePixels(uint16_t ratio) {
+    int num_leds = getNumLeds();
+    for (int idx = 0; idx < num_leds; ++idx) {
+      int storage = physical(idx);
+      Color color = readPixel(storage);
+      writePixel(storage, Color(scaleChannel(color.red, ratio),
+                                scaleChannel(color.green, ratio),
+                                scaleChannel(color.blue, ratio)));
+    }
+    stale_ = metered_;
+  }
+
+  /**
+   * \brief Sets the order of the pixels in the underlying storage.
+   * \param[in] index_map the index in the storage of every pixel, or nullptr
+   * if the pixels are stored in order. The caller keeps ownership of it.
+   * \param[in] width the number of pixels in a row, or 0 for a single row.
+   */
+  void setIndexMap(const uint16_t *index_map, int width) {
+    index_map_ = index_map;
+    width_ = width;
+    stale_ = metered_;  // The loads are kept in the order of the pixels
+  }
+
+  /**
+   * \brief Reads a pixel from the underlying storage.
+   * \param[in] idx the index of the pixel.
+   * \return The color of the pixel.
+   */
+  virtual Color readPixel(int idx) const = 0;
+  /**
+   * \brief Writes a pixel to the underlying storage.
+   * \param[in] idx the index of the pixel.
+   * \param[in] color the color of the pixel.
+   */
+  virtual void writePixel(int idx, const Color &color) = 0;
+  /**
+   * \brief Rotates the pixels in the underlying storage.
+   * \details The pixels are moved as stored, i.e. without being scaled
+   * again. The default implementation reverses the entire frame and
+   * then each of its two parts. Override it to move the storage in bulk.
+   * \param[in] count the number of positions in (0, number of pixels).
+   */
+  virtual void rotatePixels(int count) {
+    int num_leds = getNumLeds();
+    reversePixels(0, num_leds);
+    reversePixels(0, count);
+    reversePixels(count, num_leds);
+  }
+  /**
+   * \brief Rotates a byte array towards its end.
+   * \details Drivers can use it to rotate their buffer in bulk.
+   * \param[in] data the array.
+   * \param[in] length the length of the array.
+   * \param[in] count the number of positions in [0, length].
+   */
+  static void rotateBytes(byte *data, size_t length, size_t count) {
+    reverseBytes(data, data + length);
+    reverseBytes(data, data + count);
+    reverseBytes(data + count, data + length);
+  }
+  /**
+   * \brief Writes a color to the palette.
+   * \param[in] entry the index of the color in the palette.
+   * \param[in] color the color.
+   */
+  virtual void writePaletteColor(int entry, const Color &color) {}
+  /**
+   * \brief Writes a palette index to the underlying storage.
+   * \param[in] idx the index of the pixel.
+   * \param[in] entry the index of the color in the palette.
+   */
+  virtual void writePixelIndex(int idx, byte entry) {}
+
+ private:
+  static void reverseBytes(byte *first, byte *last) {
+    for (--last; first < last; ++first, --last) {
+      byte value = *first;
+      *first = *last;
+      *last = value;
+    }
+  }
+
+  int physical(int idx) const { return index_map_ ? index_map_[idx] : idx; }
+
+  void reversePixels(int first, int last) {
+    for (--last; first < last; ++first, --last) {
+      Color color = readPixel(physical(first));
+      writePixel(physical(first), readPixel(physical(last)));
+      writePixel(physical(last), color);
+    }
+  }
+
+  static byte scaleChannel(byte value, uint16_t ratio) {
+    uint32_t scaled = ((uint32_t)value * ratio) >> 8;
+    return scaled > 255 ? 255 : scaled;
+  }
+
+  /**
+   * \brief Gets the mean of the channels of a color, rounded up.
+   */
+  static byte loadOf(const Color &color) {
+    return ((color.red + color.green + color.blue) * 85u + 255) >> 8;
+  }
+
+  /**
+   * \brief Replaces the load of a pixel with the load of its new color.
+   */
+  void meter(int idx, const Color &color) {
+    if (palette_) {  // The color is quantized to the palette
+      stale_ = true;
+      return;
+    }
+    byte load = loadOf(color);
+    load_ += load;
+    load_ -= loads_[idx];
+    loads_[idx] = load;
+  }
+
+  void countLoad() {
+    int num_leds = getNumLeds();
+    load_ = 0;
+    for (int idx = 0; idx < num_leds; ++idx) {
+      byte load = loadOf(readPixel(physical(idx)));
+      if (loads_) loads_[idx] = load;
+      load_ += load;
+    }
+    stale_ = false;
+  }
+
+  void updateFactor() {
+    factor_ = ((uint16_t)(brightness_ + 1) * (limit_ + 1)) >> 8;
+    if (factor_ == 0) factor_ = 1;
+  }
+
+  Color scale(const Color &color) const {
+    if (factor_ == 256) return color;
+    return Color((color.red * factor_) >> 8, (color.green * factor_) >> 8,
+                 (color.blue * factor_) >> 8);
+  }
+
+  byte brightness_;
+  byte limit_;       // Scales the colors on top of the brightness
+  uint16_t factor_;  // The scale of the colors in 1/256
+  bool metered_;     // Whether the load is kept
+  bool palette_;     // Whether the load is counted again on every change
+  bool stale_;       // Whether the load has to be counted again
+  byte *loads_;      // The load of every pixel, unless there is a palette
+  uint32_t load_;    // The sum of the loads of all pixels
+  const uint16_t *index_map_;  // The index in the storage of every pixel
+  int width_;  // The number of pixels in a row, 0 for a single row
+};
+
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_FRAME_BUFFER_H
@@ -0,0 +1,89 @@
+/*! \file frame_interpolator.cpp
+ *  \brief Implements the output stage that blends the frames of a mode.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "frame_interpolator.h"
+
+#include "effects.h"
+
+namespace arduino_pixel {
+
+FrameInterpolator::FrameInterpolator(int num_leds)
+    : num_leds_(num_leds),
+      prev_(new byte[3 * num_leds]),
+      next_(new byte[3 * num_leds]),
+      captured_(false) {
+  if (prev_) memset(prev_, 0, 3 * num_leds_);
+  if (next_) memset(next_, 0, 3 * num_leds_);
+}
+
+FrameInterpolator::~FrameInterpolator() {
+  delete[] prev_;
+  delete[] next_;
+}
+
+void FrameInterpolator::snap() {
+  memcpy(prev_, next_, 3 * num_leds_);
+  captured_ = false;
+}
+
+void FrameInterpolator::blend(FrameBuffer &frame, uint16_t fraction,
+                              bool all) const {
+  const byte *prev = prev_;
+  const byte *next = next_;
+  for (int idx = 0; idx < num_leds_; ++idx, prev += 3, next += 3) {
+    if (not all and prev[0] == next[0] and prev[1] == next[1] and
+        prev[2] == next[2])
+      continue;  // Shown already, since the previous step
+    Color to(next[0], next[1], next[2]);
+    if (fraction < 256) {
+      Color from(prev[0], prev[1], prev[2]);
+      to = lerpColor(from, to, fraction);
+    }
+    frame.setPixel(idx, to);
+  }
+}
+
+Color FrameInterpolator::readPixel(int idx) const {
+  const byte *pixel = next_ + 3 * idx;
+  return Color(pixel[0], pixel[1], pixel[2]);
+}
+
+void FrameInterpolator::writePixel(int idx, const Color &color) {
+  capture();
+  byte *pixel = next_ + 3 * idx;
+  pixel[0] = color.red;
+  pixel[1] = color.green;
+  pixel[2] = color.blue;
+}
+
+void FrameInterpolator::rotatePixels(int count) {
+  capture();
+  rotateBytes(next_, 3 * num_leds_, 3 * count);
+}
+
+}  // namespace arduino_pixel
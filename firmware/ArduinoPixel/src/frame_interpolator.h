@@ -0,0 +1,120 @@
+/*! \file frame_interpolator.h
+ *  \brief Defines an output stage that blends the frames of a mode.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_FRAME_INTERPOLATOR_H
+#define ARDUINO_PIXEL_FRAME_INTERPOLATOR_H
+
+#include "common_types.h"
+#include "frame_buffer.h"
+
+namespace arduino_pixel {
+
+/**
+ * \brief Keeps the previous and the next frame of a mode, and blends them.
+ * \details The mode draws the next frame on the interpolator, instead of
+ * the strip. The first write after a step copies the next frame to the
+ * previous one, so a step costs a copy of the frame, whatever the mode
+ * writes. The strip then shows the blend of the two frames as the step
+ * progresses, e.g. a pixel that moves to its neighbor fades from one to the
+ * other, which places it between them. The frames take 6 bytes per pixel.
+ */
+class FrameInterpolator : public FrameBuffer {
+ public:
+  /**
+   * \param[in] num_leds number of pixels.
+   */
+  FrameInterpolator(int num_leds);
+
+  virtual ~FrameInterpolator();
+
+  /**
+   * \brief Checks whether there was memory for the frames.
+   */
+  bool isValid() const { return prev_ and next_; }
+
+  virtual int getNumLeds() const override { return num_leds_; }
+
+  /**
+   * \brief Sets the number of pixels in a row, to follow the strip.
+   * \param[in] width the width of the frame, or 0 for a single row.
+   */
+  void setWidth(int width) {
+    if (width == getWidth()) return;
+    setIndexMap(nullptr, width);
+  }
+  /**
+   * \brief Completes a step of the mode.
+   * \return True if the next frame has changed since the previous step.
+   */
+  bool commit() {
+    bool changed = captured_;
+    captured_ = false;
+    return changed;
+  }
+  /**
+   * \brief Makes the previous frame the same as the next one.
+   * \details A frame that is drawn in full, e.g. of a new state, is shown
+   * at once, rather than blended.
+   */
+  void snap();
+  /**
+   * \brief Writes the blend of the frames on a frame buffer.
+   * \param[in] frame the frame buffer, e.g. of the strip.
+   * \param[in] fraction the progress of the step in 1/256, from 0, the
+   * previous frame, to 256, the next frame.
+   * \param[in] all flag to indicate whether to write all pixels, instead of
+   * only those that differ between the frames.
+   */
+  void blend(FrameBuffer &frame, uint16_t fraction, bool all) const;
+
+ protected:
+  virtual Color readPixel(int idx) const override;
+
+  virtual void writePixel(int idx, const Color &color) override;
+
+  virtual void rotatePixels(int count) override;
+
+ private:
+  /**
+   * \brief Copies the next frame to the previous one, before it changes.
+   */
+  void capture() {
+    if (captured_) return;
+    memcpy(prev_, next_, 3 * num_leds_);
+    captured_ = true;
+  }
+
+  const int num_leds_;
+  byte *prev_;  // The r, g, b of every pixel of the previous frame
+  byte *next_;  // The r, g, b of every pixel of the next frame
+  bool captured_;  // Whether the next frame has changed since the step
+};
+
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_FRAME_INTERPOLATOR_H
@@ -0,0 +1,118 @@
+/*! \file frame_preview.cpp
+ *  \brief Implements the preview of the frames for remote clients.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "frame_preview.h"
+
+namespace arduino_pixel {
+
+namespace {
+
+void writeColor(ResponseWriter &out, const Color &color) {
+  out.write(color.red);
+  out.write(color.green);
+  out.write(color.blue);
+}
+
+}  // namespace
+
+size_t FramePreviewBase::getLength(const FrameBuffer &frame,
+                                   const PreviewOptions &options) {
+  if (options.encoded) return 0;
+  int height = frame.getHeight();
+  int step_y = (height > 1) ? options.step : 1;
+  size_t width = (frame.getWidth() + options.step - 1) / options.step;
+  return kHeaderSize + 3 * width * ((height + step_y - 1) / step_y);
+}
+
+bool FramePreviewBase::write(ResponseWriter &out, const FrameBuffer &frame,
+                             const PreviewOptions &options) {
+  int width = frame.getWidth();
+  int height = frame.getHeight();
+  int step = options.step;
+  int step_y = (height > 1) ? step : 1;
+  int frame_width = (width + step - 1) / step;
+  int frame_height = (height + step_y - 1) / step_y;
+
+  out.write('A');
+  out.write('F');
+  out.write(kVersion);
+  out.write(options.encoded ? kEncoded : 0);
+  out.write(frame_width & 0xFF);
+  out.write(frame_width >> 8);
+  out.write(frame_height & 0xFF);
+  out.write(frame_height >> 8);
+
+  Color run;
+  int run_length = 0;
+  for (int y = 0; y < height; y += step_y) {
+    int rows = min(step_y, height - y);
+    for (int x = 0; x < width; x += step) {
+      Color color;
+      if (step == 1) {
+        color = frame.getPixel(x, y);
+      } else {
+        int cols = min(step, width - x);
+        uint16_t red = 0, green = 0, blue = 0;  // At most 16 x 16 x 255
+        for (int dy = 0; dy < rows; ++dy) {
+          for (int dx = 0; dx < cols; ++dx) {
+            Color pixel = frame.getPixel(x + dx, y + dy);
+            red += pixel.red;
+            green += pixel.green;
+            blue += pixel.blue;
+          }
+        }
+        uint16_t count = rows * cols;
+        color = Color((red + count / 2) / count, (green + count / 2) / count,
+                      (blue + count / 2) / count);
+      }
+      if (not options.encoded) {
+        writeColor(out, color);
+        continue;
+      }
+      if (run_length and run_length < 256 and color.red == run.red and
+          color.green == run.green and color.blue == run.blue) {
+        ++run_length;
+        continue;
+      }
+      if (run_length) {
+        out.write(run_length - 1);
+        writeColor(out, run);
+      }
+      run = color;
+      run_length = 1;
+    }
+    if (out.failed()) return false;  // Don't read the rest for nothing
+  }
+  if (run_length) {
+    out.write(run_length - 1);
+    writeColor(out, run);
+  }
+  return out.send();
+}
+
+}  // namespace arduino_pixel
@@ -0,0 +1,191 @@
+/*! \file frame_preview.h
+ *  \brief Defines the preview of the frames for remote clients.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_FRAME_PREVIEW_H
+#define ARDUINO_PIXEL_FRAME_PREVIEW_H
+
+#include <Client.h>
+
+#include "common_types.h"
+#include "event_source.h"
+#include "frame_buffer.h"
+#include "response_writer.h"
+
+namespace arduino_pixel {
+
+/**
+ * \brief Holds the options of a preview.
+ */
+struct PreviewOptions {
+  PreviewOptions() : step(1), encoded(false), interval(0) {}
+  byte step;  // Every block of step x step pixels is averaged to one pixel
+  bool encoded;  // Whether the pixels are run-length encoded
+  unsigned int interval;  // Time in ms between two frames, 0 for a snapshot
+};
+
+/**
+ * \brief Interface of the subscribers of the frame previews.
+ * \details A frame is an 8-byte header and the pixels in rows. All values
+ * are little endian.
+ *   0-1: "AF"
+ *   2: version
+ *   3: flags (bit 0: the pixels are run-length encoded)
+ *   4-5: the width of the frame
+ *   6-7: the height of the frame
+ *   8-...: r, g, b of every pixel, or runs of pixels of the same color, each
+ *          the number of pixels minus 1 and r, g, b
+ * A pixel of the frame is the average of a block of step x step pixels of
+ * the frame buffer, or of step pixels, if the strip is a single row. The
+ * colors are the ones sent to the strip, i.e. scaled by the brightness.
+ */
+class FramePreviewBase {
+ public:
+  static const byte kVersion = 1;
+  static const byte kHeaderSize = 8;
+  static const byte kEncoded = 0x01;
+  static const byte kMaxStep = 16;
+
+  virtual ~FramePreviewBase() {}
+  /**
+   * \brief Keeps the connection of a client open for the frames.
+   * \param[in] client client that requested the frames.
+   * \param[in] options the options of the preview.
+   * \return False if all slots are taken, true otherwise.
+   */
+  virtual bool subscribe(Client &client, const PreviewOptions &options) = 0;
+  /**
+   * \brief Sends the frame to the subscribers that are due for one.
+   * \details A subscriber gets a frame when its interval has passed and the
+   * frame has changed since its last one, or when a keepalive is due. A
+   * subscriber that has disconnected, or that can't take the entire frame,
+   * is dropped.
+   * \param[in] time the time in ms.
+   * \param[in] changed whether a frame was sent to the strip since the last
+   * call.
+   * \param[in] frame the frame buffer of the strip.
+   */
+  virtual void update(unsigned long time, bool changed,
+                      const FrameBuffer &frame) = 0;
+
+  virtual byte getNumSubscribers() const = 0;
+
+  /**
+   * \brief Gets the length of a frame that isn't encoded.
+   * \param[in] frame the frame buffer.
+   * \param[in] options the options of the preview.
+   * \return The length in bytes, or 0 if the frame is encoded, since then
+   * the length depends on the pixels.
+   */
+  static size_t getLength(const FrameBuffer &frame,
+                          const PreviewOptions &options);
+  /**
+   * \brief Writes a frame, and sends it.
+   * \details The pixels are read from the frame buffer as they are written
+   * to the buffer of the writer, after anything that's already in it, e.g.
+   * the headers of the response.
+   * \param[in] out the writer of the client.
+   * \param[in] frame the frame buffer.
+   * \param[in] options the options of the preview.
+   * \return False if the client didn't take the entire frame.
+   */
+  static bool write(ResponseWriter &out, const FrameBuffer &frame,
+                    const PreviewOptions &options);
+};
+
+/**
+ * \brief Keeps up to N subscribers of the frame previews.
+ * \details The connections are kept by value, so ClientT must be the type
+ * of the clients that are passed to ArduinoPixelServer::processRequest, e.g.
+ * WiFiClient or EthernetClient.
+ */
+template <typename ClientT, byte N>
+class FramePreview : public FramePreviewBase {
+ public:
+  FramePreview() {
+    for (byte i = 0; i < N; ++i) active_[i] = false;
+  }
+
+  virtual ~FramePreview() {}
+
+  virtual bool subscribe(Client &client,
+                         const PreviewOptions &options) override {
+    for (byte i = 0; i < N; ++i) {
+      if (active_[i] and clients_[i].connected()) continue;
+      if (active_[i]) clients_[i].stop();
+      clients_[i] = static_cast<ClientT &>(client);
+      options_[i] = options;
+      active_[i] = true;
+      written_[i] = false;  // The first frame is sent on the next update
+      changed_[i] = true;
+      return true;
+    }
+    return false;
+  }
+
+  virtual void update(unsigned long time, bool changed,
+                      const FrameBuffer &frame) override {
+    for (byte i = 0; i < N; ++i) {
+      if (not active_[i]) continue;
+      changed_[i] = changed_[i] or changed;
+      if (written_[i]) {
+        unsigned long elapsed = time - times_[i];
+        if (elapsed < options_[i].interval) continue;
+        if (not changed_[i] and elapsed < ARDUINO_PIXEL_EVENT_KEEPALIVE)
+          continue;
+      }
+      ResponseWriter writer(clients_[i]);
+      if (not clients_[i].connected() or
+          not write(writer, frame, options_[i])) {
+        clients_[i].stop();
+        active_[i] = false;
+        continue;
+      }
+      times_[i] = time;
+      written_[i] = true;
+      changed_[i] = false;
+    }
+  }
+
+  virtual byte getNumSubscribers() const override {
+    byte count = 0;
+    for (byte i = 0; i < N; ++i) count += active_[i];
+    return count;
+  }
+
+ private:
+  ClientT clients_[N];
+  PreviewOptions options_[N];
+  unsigned long times_[N];  // Time in ms of the latest frame to a subscriber
+  bool active_[N];
+  bool written_[N];  // Whether a subscriber has got a frame
+  bool changed_[N];  // Whether the frame has changed since the latest one
+};
+
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_FRAME_PREVIEW_H
@@ -0,0 +1,257 @@
+/*! \file json_tokenizer.cpp
+ *  \brief Implements the bounded JSON tokenizer.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "json_tokenizer.h"
+
+namespace arduino_pixel {
+
+JsonTokenizer::JsonTokenizer(const char *json, uint16_t length,
+                             JsonToken *tokens, byte max_tokens)
+    : json_(json),
+      length_(length),
+      pos_(0),
+      tokens_(tokens),
+      max_tokens_(max_tokens),
+      num_tokens_(0) {}
+
+int JsonTokenizer::tokenize() {
+  pos_ = 0;
+  num_tokens_ = 0;
+  skipWhitespace();
+  if (not parseValue(0)) return -1;
+  skipWhitespace();
+  return atEnd() ? num_tokens_ : -1;  // Nothing may follow the value
+}
+
+int JsonTokenizer::find(byte object, const __FlashStringHelper *key) const {
+  if (object >= num_tokens_ or tokens_[object].type != JsonType::OBJECT)
+    return -1;
+  // Keys and values alternate, and each value may span several tokens
+  for (byte i = object + 1; i < tokens_[object].next; i = tokens_[i + 1].next)
+    if (equals(i, key)) return i + 1;
+  return -1;
+}
+
+bool JsonTokenizer::equals(int token, const __FlashStringHelper *str) const {
+  if (token < 0 or token >= num_tokens_) return false;
+  const JsonToken &t = tokens_[token];
+  if (t.type != JsonType::STRING) return false;
+  PGM_P str_P = reinterpret_cast<PGM_P>(str);
+  // The token excludes the quotes
+  size_t length = t.end - t.start;
+  return strlen_P(str_P) == length and
+         strncmp_P(json_ + t.start, str_P, length) == 0;
+}
+
+bool JsonTokenizer::toInteger(int token, long min, long max,
+                              long &value) const {
+  if (token < 0 or token >= num_tokens_) return false;
+  const JsonToken &t = tokens_[token];
+  if (t.type != JsonType::NUMBER) return false;
+  uint16_t i = t.start;
+  bool negative = json_[i] == '-';
+  if (negative) ++i;
+  long result = 0;
+  for (; i < t.end; ++i) {
+    if (json_[i] < '0' or json_[i] > '9') return false;  // Fraction, exponent
+    result = 10 * result + (json_[i] - '0');
+    if (result > max and result > -min) return false;  // Avoids the overflow
+  }
+  if (negative) result = -result;
+  if (result < min or result > max) return false;
+  value = result;
+  return true;
+}
+
+bool JsonTokenizer::toBoolean(int token, bool &value) const {
+  if (token < 0 or token >= num_tokens_) return false;
+  const JsonToken &t = tokens_[token];
+  // The literal has been validated, so its first character tells it apart
+  if (t.type != JsonType::LITERAL or json_[t.start] == 'n') return false;
+  value = json_[t.start] == 't';
+  return true;
+}
+
+bool JsonTokenizer::parseValue(byte depth) {
+  if (atEnd()) return false;
+  switch (json_[pos_]) {
+    case '{':
+      return parseObject(depth);
+    case '[':
+      return parseArray(depth);
+    case '"':
+      return parseString();
+    case 't':
+    case 'f':
+    case 'n':
+      return parseLiteral();
+    default:
+      return parseNumber();
+  }
+}
+
+bool JsonTokenizer::parseObject(byte depth) {
+  if (depth >= kMaxDepth) return false;
+  int token = addToken(JsonType::OBJECT);
+  if (token < 0) return false;
+  ++pos_;  // '{'
+  skipWhitespace();
+  if (not consume('}')) {
+    do {
+      skipWhitespace();
+      if (atEnd() or json_[pos_] != '"' or not parseString()) return false;
+      skipWhitespace();
+      if (not consume(':')) return false;
+      skipWhitespace();
+      if (not parseValue(depth + 1)) return false;
+      skipWhitespace();
+    } while (consume(','));
+    if (not consume('}')) return false;
+  }
+  tokens_[token].end = pos_;
+  tokens_[token].next = num_tokens_;
+  return true;
+}
+
+bool JsonTokenizer::parseArray(byte depth) {
+  if (depth >= kMaxDepth) return false;
+  int token = addToken(JsonType::ARRAY);
+  if (token < 0) return false;
+  ++pos_;  // '['
+  skipWhitespace();
+  if (not consume(']')) {
+    do {
+      skipWhitespace();
+      if (not parseValue(depth + 1)) return false;
+      skipWhitespace();
+    } while (consume(','));
+    if (not consume(']')) return false;
+  }
+  tokens_[token].end = pos_;
+  tokens_[token].next = num_tokens_;
+  return true;
+}
+
+bool JsonTokenizer::parseString() {
+  ++pos_;  // '"'
+  int token = addToken(JsonType::STRING);
+  if (token < 0) return false;
+  while (not atEnd()) {
+    char c = json_[pos_];
+    if (c == '"') {
+      tokens_[token].end = pos_++;
+      return true;
+    }
+    if ((byte)c < 0x20) return false;  // Control characters must be escaped
+    if (c == '\\' and not parseEscape()) return false;
+    ++pos_;
+  }
+  return false;  // Unterminated
+}
+
+bool JsonTokenizer::parseEscape() {
+  if (++pos_ >= length_) return false;  // '\\'
+  switch (json_[pos_]) {
+    case '"':
+    case '\\':
+    case '/':
+    case 'b':
+    case 'f':
+    case 'n':
+    case 'r':
+    case 't':
+      return true;
+    case 'u':
+      for (byte i = 0; i < 4; ++i)
+        if (++pos_ >= length_ or not isHexadecimalDigit(json_[pos_]))
+          return false;
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool JsonTokenizer::parseNumber() {
+  int token = addToken(JsonType::NUMBER);
+  if (token < 0) return false;
+  consume('-');
+  uint16_t digits = pos_;
+  while (not atEnd() and isDigit(json_[pos_])) ++pos_;
+  if (pos_ == digits) return false;
+  if (consume('.')) {
+    digits = pos_;
+    while (not atEnd() and isDigit(json_[pos_])) ++pos_;
+    if (pos_ == digits) return false;
+  }
+  if (consume('e') or consume('E')) {
+    if (not consume('+')) consume('-');
+    digits = pos_;
+    while (not atEnd() and isDigit(json_[pos_])) ++pos_;
+    if (pos_ == digits) return false;
+  }
+  tokens_[token].end = pos_;
+  return true;
+}
+
+bool JsonTokenizer::parseLiteral() {
+  int token = addToken(JsonType::LITERAL);
+  if (token < 0) return false;
+  const char *literal = json_[pos_] == 't'   ? PSTR("true")
+                        : json_[pos_] == 'f' ? PSTR("false")
+                                             : PSTR("null");
+  size_t length = strlen_P(literal);
+  if ((size_t)(length_ - pos_) < length or strncmp_P(json_ + pos_, literal, length))
+    return false;
+  pos_ += length;
+  tokens_[token].end = pos_;
+  return true;
+}
+
+int JsonTokenizer::addToken(JsonType type) {
+  if (num_tokens_ >= max_tokens_) return -1;
+  JsonToken &token = tokens_[num_tokens_];
+  token.type = type;
+  token.start = pos_;
+  token.end = pos_;
+  token.next = ++num_tokens_;  // Containers update it when they close
+  return num_tokens_ - 1;
+}
+
+void JsonTokenizer::skipWhitespace() {
+  while (not atEnd() and (json_[pos_] == ' ' or json_[pos_] == '\t' or
+                          json_[pos_] == '\n' or json_[pos_] == '\r'))
+    ++pos_;
+}
+
+bool JsonTokenizer::consume(char c) {
+  if (atEnd() or json_[pos_] != c) return false;
+  ++pos_;
+  return true;
+}
+
+}  // namespace arduino_pixel
@@ -0,0 +1,148 @@
+/*! \file json_tokenizer.h
+ *  \brief Defines a bounded JSON tokenizer.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_JSON_TOKENIZER_H
+#define ARDUINO_PIXEL_JSON_TOKENIZER_H
+
+#include "common_types.h"
+
+// The maximum number of tokens in a request body. Every value, key, object,
+// and array takes a token, e.g. {"r":48,"g":254,"b":176} takes 7 tokens.
+#ifndef ARDUINO_PIXEL_JSON_TOKENS
+#if defined(__AVR__)
+#define ARDUINO_PIXEL_JSON_TOKENS 24
+#else
+#define ARDUINO_PIXEL_JSON_TOKENS 64
+#endif
+#endif
+
+namespace arduino_pixel {
+
+enum class JsonType : byte { OBJECT, ARRAY, STRING, NUMBER, LITERAL };
+
+/**
+ * \brief Holds the location of a value in the json text.
+ */
+struct JsonToken {
+  JsonType type;
+  byte next;       // The index of the token after the value and its children
+  uint16_t start;  // The offset of the first character
+  uint16_t end;    // The offset past the last character
+};
+
+/**
+ * \brief Splits a json text into tokens.
+ * \details The tokens refer to the text, which is neither copied nor
+ * modified, and are stored in an array that the caller provides. The text
+ * is validated as it's tokenized. The tokenizer gives up on the first error,
+ * and never reads past the given length, nests deeper than kMaxDepth, or
+ * writes more tokens than the array holds.
+ * \note The tokens of an object alternate between keys and values.
+ */
+class JsonTokenizer {
+ public:
+  static const byte kMaxDepth = 4;
+
+  /**
+   * \param[in] json the json text.
+   * \param[in] length the length of the text.
+   * \param[out] tokens the array of the tokens.
+   * \param[in] max_tokens the size of the array.
+   */
+  JsonTokenizer(const char *json, uint16_t length, JsonToken *tokens,
+                byte max_tokens);
+  /**
+   * \brief Tokenizes the text.
+   * \return The number of tokens, or -1 if the text isn't valid json or
+   * exceeds the limits.
+   */
+  int tokenize();
+  /**
+   * \brief Finds a member of an object.
+   * \param[in] object the index of the object token.
+   * \param[in] key the key of the member.
+   * \return The index of the value token, or -1 if there is no such member.
+   */
+  int find(byte object, const __FlashStringHelper *key) const;
+  /**
+   * \brief Compares a string token with a string in flash.
+   * \param[in] token the index of the token.
+   * \param[in] str a string in flash.
+   * \return True if the token is a string equal to str.
+   */
+  bool equals(int token, const __FlashStringHelper *str) const;
+  /**
+   * \brief Converts a number token to an integer in a range.
+   * \param[in] token the index of the token. An invalid index, e.g. the -1
+   * of a member that isn't found, fails the conversion.
+   * \param[in] min the minimum value.
+   * \param[in] max the maximum value.
+   * \param[out] value the value.
+   * \return False if the token isn't an integer in [min, max].
+   */
+  bool toInteger(int token, long min, long max, long &value) const;
+  /**
+   * \brief Converts a literal token to a boolean.
+   * \param[in] token the index of the token.
+   * \param[out] value the value.
+   * \return False if the token isn't true or false.
+   */
+  bool toBoolean(int token, bool &value) const;
+
+ private:
+  bool parseValue(byte depth);
+  bool parseObject(byte depth);
+  bool parseArray(byte depth);
+  bool parseString();
+  /**
+   * \brief Validates the escape sequence at the current position.
+   * \note The position is left on the last character of the sequence.
+   */
+  bool parseEscape();
+  bool parseNumber();
+  bool parseLiteral();
+  /**
+   * \brief Appends a token that starts at the current position.
+   * \return The index of the token, or -1 if the array is full.
+   */
+  int addToken(JsonType type);
+  void skipWhitespace();
+  bool consume(char c);
+  bool atEnd() const { return pos_ >= length_; }
+
+  const char *json_;
+  uint16_t length_;
+  uint16_t pos_;
+  JsonToken *tokens_;
+  byte max_tokens_;
+  byte num_tokens_;
+};
+
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_JSON_TOKENIZER_H
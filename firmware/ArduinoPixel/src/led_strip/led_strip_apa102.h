@@ -0,0 +1,166 @@
+/*! \file led_strip_apa102.h
+ *  \brief Interface for the clocked APA102 and SK9822 LEDs over hardware SPI.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_LED_STRIP_LED_STRIP_APA102_H
+#define ARDUINO_PIXEL_LED_STRIP_LED_STRIP_APA102_H
+
+#include <SPI.h>
+
+#include "led_strip/led_strip_base.h"
+#include "pixel_format.h"
+
+namespace arduino_pixel {
+namespace led_strip {
+
+/**
+ * \brief LED strip with a clock and a data line, e.g. APA102 and SK9822.
+ * \details The strip keeps the whole stream on the wire in a single buffer,
+ * i.e. the start frame, a 4-byte frame per LED, and the end frame. The pixels
+ * are encoded into the buffer as they're set, and show sends the buffer with
+ * a single SPI transfer.
+ * \tparam F order of the color channels. Both APA102 and SK9822 take BGR.
+ */
+template <PixelFormat F = PixelFormat::BGR>
+class LedStripApa102 : public LedStripBase {
+ public:
+  typedef typename PixelFormatEncoder<F>::type Encoder;
+  static_assert(Encoder::kChannels == 3, "APA102 LEDs have no white LED");
+
+  static const byte kMaxBrightness = 31;
+
+  /**
+   * \param[in] num_leds number of LEDs.
+   * \param[in] clock SPI clock frequency in Hz.
+   * \param[in] spi SPI bus the strip is connected to.
+   */
+  LedStripApa102(const int &num_leds, uint32_t clock = 8000000,
+                 SPIClass &spi = SPI)
+      : length_(kStartFrameSize + (size_t)kLedFrameSize * num_leds +
+                getEndFrameSize(num_leds)),
+        buffer_(new byte[length_]()),
+        settings_(clock, MSBFIRST, SPI_MODE0),
+        spi_(spi) {
+    // Without memory for the buffer, the strip has no LEDs, as a NeoPixel
+    // strip, and sends nothing
+    num_leds_ = buffer_ ? num_leds : 0;
+    if (not buffer_) length_ = 0;
+    setGlobalBrightness(kMaxBrightness);
+  }
+
+  virtual ~LedStripApa102() { delete[] buffer_; }
+
+  virtual void init() override {
+    spi_.begin();
+    show();
+  }
+
+  virtual void show() override {
+    if (not buffer_) return;
+    spi_.beginTransaction(settings_);
+#if defined(ESP32) || defined(ESP8266)
+    spi_.writeBytes(buffer_, length_);
+#else
+    // The bulk transfer on AVR overwrites the buffer with the received bytes
+    for (size_t i = 0; i < length_; ++i) spi_.transfer(buffer_[i]);
+#endif
+    spi_.endTransaction();
+  }
+
+  virtual int getNumLeds() const override { return num_leds_; }
+
+  /**
+   * \brief Checks whether there was memory for the buffer.
+   * \details Otherwise, the strip has no LEDs.
+   */
+  bool isValid() const { return buffer_ != nullptr; }
+
+  /**
+   * \brief Sets the 5-bit brightness field of the LEDs.
+   * \details The LEDs dim by modulating the current of the color LEDs, so
+   * the colors keep their 8-bit resolution.
+   * \param[in] brightness brightness in [0, 31].
+   */
+  void setGlobalBrightness(byte brightness) {
+    if (brightness > kMaxBrightness) brightness = kMaxBrightness;
+    brightness_ = brightness;
+    byte header = 0xE0 | brightness;
+    for (int idx = 0; idx < num_leds_; ++idx) getLedFrame(idx)[0] = header;
+  }
+
+  /**
+   * \brief Gets the 5-bit brightness field of the LEDs.
+   */
+  byte getGlobalBrightness() const { return brightness_; }
+
+ protected:
+  virtual Color readPixel(int idx) const override {
+    Color color;
+    Encoder::decode(getLedFrame(idx) + 1, color.red, color.green, color.blue);
+    return color;
+  }
+
+  virtual void writePixel(int idx, const Color &color) override {
+    Encoder::encode(getLedFrame(idx) + 1, color.red, color.green, color.blue);
+  }
+
+  virtual void rotatePixels(int count) override {
+    // The header of every LED frame holds the same brightness
+    rotateBytes(getLedFrame(0), kLedFrameSize * num_leds_,
+                kLedFrameSize * count);
+  }
+
+ private:
+  static const byte kStartFrameSize = 4;
+  static const byte kLedFrameSize = 4;
+
+  /**
+   * \brief Gets the size of the end frame.
+   * \details The data is delayed by half a clock cycle on every LED, so the
+   * last LED needs another num_leds / 2 clock edges. SK9822 latches the
+   * colors on a zero frame of 32 bits.
+   */
+  static uint16_t getEndFrameSize(int num_leds) {
+    return 4 + (num_leds + 15) / 16;
+  }
+
+  byte *getLedFrame(int idx) const {
+    return buffer_ + kStartFrameSize + kLedFrameSize * idx;
+  }
+
+  int num_leds_;
+  size_t length_;  // The bytes of the stream
+  byte *buffer_;
+  SPISettings settings_;
+  SPIClass &spi_;
+  byte brightness_;
+};
+
+}  // namespace led_strip
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_LED_STRIP_LED_STRIP_APA102_H
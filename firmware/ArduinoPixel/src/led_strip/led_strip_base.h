@@ -31,13 +31,32 @@
 
 #include "mode/mode_base.h"
 #include "common_types.h"
+#include "frame_buffer.h"
+#include "frame_interpolator.h"
 
 namespace arduino_pixel {
 namespace led_strip {
 
-class LedStripBase {
+/**
+ * \brief Describes how the LEDs of a matrix are wired.
+ * \details The strip starts at the top left corner of the panel, and runs
+ * along its rows. The image that the modes draw is rotated clockwise on the
+ * panel.
+ */
+struct MatrixLayout {
+  uint16_t width;    // The number of LEDs in a row of the panel
+  uint16_t height;   // The number of rows of the panel
+  bool serpentine;   // Every other row runs from right to left
+  uint16_t rotation;  // 0, 90, 180, or 270 degrees
+  bool custom;  // The LEDs follow a map instead, and the rest is unused
+};
+
+class LedStripBase : public FrameBuffer {
  public:
-  virtual ~LedStripBase() {}
+  virtual ~LedStripBase() {
+    delete[] layout_map_;
+    delete interpolator_;
+  }
   /**
    * \brief Initializes the LED strip.
    * \note Use to initialize any member variables when appropriate.
@@ -49,24 +68,312 @@ class LedStripBase {
    * \param[in] mode a mode instance.
    */
   void setMode(mode::ModeBase *mode) { mode_ = mode; }
+  /**
+   * \brief Lays the LEDs out as a matrix.
+   * \details The index of every pixel on the strip is computed once, so
+   * that the modes draw the rows of the image in order, and every pixel costs
+   * a table lookup as it's written. A single row that isn't serpentine nor
+   * rotated needs no table.
+   * \param[in] width the number of LEDs in a row of the panel.
+   * \param[in] height the number of rows of the panel.
+   * \param[in] serpentine flag to indicate whether every other row runs from
+   * right to left.
+   * \param[in] rotation the clockwise rotation of the image in degrees, one
+   * of 0, 90, 180, and 270.
+   * \return False if the panel doesn't have as many LEDs as the strip, or the
+   * rotation is invalid, in which case the layout is left unchanged.
+   */
+  bool setMatrix(int width, int height, bool serpentine = false,
+                 int rotation = 0) {
+    int num_leds = getNumLeds();
+    if (width <= 0 or height <= 0 or (long)width * height != num_leds or
+        rotation % 90 or rotation < 0 or rotation > 270)
+      return false;
+    if (height == 1 and rotation == 0 and not serpentine) {
+      clearLayout();
+      return true;
+    }
+    if (not allocateLayout()) return false;
+    // The image is height x width when it's rotated by 90 or 270
+    int image_width = (rotation % 180) ? height : width;
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        int idx = y * width + ((serpentine and (y & 1)) ? width - 1 - x : x);
+        int u, v;  // The column and row of the pixel on the image
+        switch (rotation) {
+          case 90: u = y; v = width - 1 - x; break;
+          case 180: u = width - 1 - x; v = height - 1 - y; break;
+          case 270: u = height - 1 - y; v = x; break;
+          default: u = x; v = y;
+        }
+        layout_map_[v * image_width + u] = idx;
+      }
+    }
+    layout_ = {(uint16_t)width, (uint16_t)height, serpentine,
+               (uint16_t)rotation, false};
+    setIndexMap(layout_map_, image_width);
+    return true;
+  }
+  /**
+   * \brief Lays the LEDs out with a map.
+   * \param[in] index_map the index on the strip of every pixel of the image.
+   * The map is copied.
+   * \param[in] width the number of pixels in a row of the image.
+   * \return False if the map has an index out of range, or the width doesn't
+   * divide the number of LEDs, in which case the layout is left unchanged.
+   */
+  bool setMap(const uint16_t *index_map, int width) {
+    int num_leds = getNumLeds();
+    if (width <= 0 or num_leds % width) return false;
+    for (int idx = 0; idx < num_leds; ++idx)
+      if (index_map[idx] >= num_leds) return false;
+    if (not allocateLayout()) return false;
+    for (int idx = 0; idx < num_leds; ++idx) layout_map_[idx] = index_map[idx];
+    layout_ = {(uint16_t)width, (uint16_t)(num_leds / width), false, 0, true};
+    setIndexMap(layout_map_, width);
+    return true;
+  }
+  /**
+   * \brief Restores the LEDs to a single row in the order of the strip.
+   */
+  void clearLayout() {
+    setIndexMap(nullptr, 0);
+    delete[] layout_map_;
+    layout_map_ = nullptr;
+  }
+  /**
+   * \brief Gets the layout of the LEDs.
+   * \return The layout, or a single row if there is no table.
+   */
+  MatrixLayout getLayout() const {
+    if (layout_map_) return layout_;
+    return {(uint16_t)getNumLeds(), 1, false, 0, false};
+  }
+
+  /**
+   * \brief Limits the current that the LEDs draw.
+   * \details The current is estimated from the load of the frame, which is
+   * kept up to date as the pixels are written. A frame that would draw more
+   * than the budget is scaled down before it's sent, and the next frames are
+   * drawn with the same scale, which is raised again when they draw less.
+   * \param[in] milliamps the budget in mA, e.g. the current of the supply
+   * less the idle current of the LEDs, about 1 mA each. With 0, the current
+   * isn't limited.
+   * \param[in] channel_milliamps the current of a color channel at 255, e.g.
+   * 20 mA on WS2812.
+   * \return False if the current of a channel is 0, in which case the limit
+   * is left unchanged, or if there is no memory for the load of the pixels,
+   * a byte each, in which case the current isn't limited.
+   */
+  bool setPowerLimit(unsigned long milliamps, byte channel_milliamps = 20) {
+    if (channel_milliamps == 0) return false;
+    channel_milliamps_ = channel_milliamps;
+    // A white pixel, 3 channels, has a load of 255
+    budget_ = milliamps * 85 / channel_milliamps;
+    bool metered = setMetered(milliamps != 0);
+    if (not metered) budget_ = 0;
+    if (not budget_ and getLimit() != 255) applyLimit(256, false);
+    return metered;
+  }
+  /**
+   * \brief Gets the estimated current of the frame.
+   * \return The current in mA, or 0 if it isn't limited.
+   */
+  unsigned long getCurrent() {
+    return getLoad() * channel_milliamps_ / 85;
+  }
+
+  /**
+   * \brief Blends the frames of the modes at a steady rate.
+   * \details The modes draw on an interpolator, which keeps their previous
+   * and next frames, and the strip shows the blend of the two every interval
+   * ms, from the previous frame at the start of a step of the mode to the
+   * next one at its end, i.e. after the period of the mode. So a mode with a
+   * long period, e.g. a slow SCANNER, moves smoothly, without drawing more
+   * frames, and a frame is shown a period after it's drawn. Modes without a
+   * period, and frames that are drawn in full, e.g. of a new state, are
+   * shown at once.
+   * \param[in] interval the interval of the blended frames in ms, e.g. 20.
+   * With 0, the frames of the modes are shown as they're drawn.
+   * \return False if there is no memory for the frames, 6 bytes per LED, in
+   * which case the frames aren't blended.
+   */
+  bool setInterpolation(unsigned long interval) {
+    delete interpolator_;
+    interpolator_ = nullptr;
+    interval_ = interval;
+    fraction_ = 256;
+    restart_ = true;  // The mode draws its frame in full on the interpolator
+    if (not interval) return true;
+    interpolator_ = new FrameInterpolator(getNumLeds());
+    if (interpolator_ and interpolator_->isValid()) return true;
+    delete interpolator_;
+    interpolator_ = nullptr;
+    return false;
+  }
+  /**
+   * \brief Gets the frame buffer that the modes draw on.
+   * \return The interpolator, if the frames are blended, or the strip.
+   */
+  FrameBuffer &getModeFrame() {
+    if (interpolator_) return *interpolator_;
+    return *this;
+  }
 
   /**
    * \brief Updates the LED strip.
-   * \details Gets the colors from the mode and updates the LED strip.
-   * \param[in] force Force updating the strip.
+   * \details Lets the mode draw on the frame buffer and updates the LED strip.
+   * \param[in] force Force updating the strip. The mode redraws the entire
+   * frame.
+   * \return True if a frame was sent to the LED strip, false otherwise.
    */
-  virtual void colorize(bool force = false) = 0;
+  virtual bool colorize(bool force = false) {
+    if (interpolator_) {
+      if (not interpolate(force)) return false;
+    } else if (force) {
+      resetPalette();
+      mode_->render(*this);
+    } else if (not mode_->update(*this)) {
+      return false;
+    }
+    if (budget_) limitPower(force);
+    show();
+    return true;
+  }
   /**
-   * \brief Gets the number of LEDs on the strip.
-   * \return The number of LEDs.
+   * \brief Sends the frame buffer to the LED strip.
    */
-  virtual int getNumLeds() const = 0;
+  virtual void show() = 0;
 
  protected:
-  LedStripBase() {}
-  LedStripBase(mode::ModeBase *mode) : mode_(mode) {}
+  LedStripBase() : LedStripBase(nullptr) {}
+  LedStripBase(mode::ModeBase *mode)
+      : mode_(mode),
+        layout_map_(nullptr),
+        budget_(0),
+        channel_milliamps_(20),
+        interpolator_(nullptr),
+        interval_(0),
+        step_time_(0),
+        refresh_time_(0),
+        fraction_(256),
+        restart_(false),
+        all_(false) {}
 
   mode::ModeBase *mode_;
+
+ private:
+  /**
+   * \brief Lets the mode draw on the interpolator, and blends its frames.
+   * \param[in] force flag to indicate whether the mode redraws the entire
+   * frame.
+   * \return True if a frame is ready for the strip.
+   */
+  bool interpolate(bool force) {
+    FrameInterpolator &frame = *interpolator_;
+    frame.setWidth(getWidth());
+    unsigned long now = Clock::millis();
+    if (force or restart_) {
+      resetPalette();
+      mode_->render(frame);
+      frame.snap();
+      fraction_ = 256;
+      restart_ = false;
+      frame.blend(*this, fraction_, true);
+      refresh_time_ = now;
+      return true;
+    }
+    if (mode_->update(frame) and frame.commit()) {
+      // The pixels that the cut short blend left behind are written too
+      all_ = fraction_ < 256;
+      fraction_ = 0;
+      step_time_ = now;
+    }
+    if (fraction_ == 256 or now - refresh_time_ < interval_) return false;
+    refresh_time_ = now;
+    unsigned long period = mode_->getPeriod();
+    unsigned long elapsed = now - step_time_;
+    fraction_ = (elapsed < period) ? elapsed * 256 / period : 256;
+    frame.blend(*this, fraction_, all_);
+    all_ = false;
+    return true;
+  }
+
+  /**
+   * \brief Draws the entire frame again.
+   */
+  void redraw() {
+    if (interpolator_) {
+      interpolator_->blend(*this, fraction_, true);
+      return;
+    }
+    resetPalette();
+    mode_->render(*this);
+  }
+
+  /**
+   * \brief Scales the frame to the budget.
+   * \details The scale is lowered at once when the frame is over the budget,
+   * and raised when the frame could be 1/4 brighter, to a little under the
+   * budget, so a frame near the budget doesn't change the scale every time.
+   * \param[in] rendered flag to indicate whether the frame was just drawn in
+   * full.
+   */
+  void limitPower(bool rendered) {
+    uint32_t load = getLoad();
+    uint16_t factor = getLimit() + 1;
+    // The scale that spends the budget, from the load per step of the scale
+    uint32_t target = budget_ / (load / factor + 1);
+    if (load > budget_) {
+      applyLimit(target ? target : 1, rendered);
+    } else if (factor < 256 and target > factor + factor / 4) {
+      uint32_t raised = target - target / 8;
+      applyLimit(raised < 256 ? raised : 256, rendered);
+    }
+  }
+
+  /**
+   * \brief Changes the scale of the colors, and of the frame.
+   * \details A frame that was just drawn, or whose pixels are palette
+   * indices, is drawn again, and any other is scaled in place, so the
+   * frames that modes don't redraw, e.g. those of STREAM, aren't lost.
+   * \param[in] factor the new scale in 1/256, in [1, 256].
+   * \param[in] rendered flag to indicate whether the frame was just drawn in
+   * full.
+   */
+  void applyLimit(uint16_t factor, bool rendered) {
+    uint16_t previous = getLimit() + 1;
+    if (factor == previous) return;
+    setLimit(factor - 1);
+    if (mode_ and (rendered or getPaletteSize())) {
+      redraw();
+    } else {
+      uint32_t ratio = (uint32_t)factor * 256 / previous;
+      scalePixels(ratio < 65535 ? ratio : 65535);
+    }
+  }
+
+  /**
+   * \brief Allocates the table of the layout, if there is none.
+   * \return False if there is no memory for it.
+   */
+  bool allocateLayout() {
+    if (layout_map_) return true;
+    layout_map_ = new uint16_t[getNumLeds()];
+    return layout_map_ != nullptr;
+  }
+
+  uint16_t *layout_map_;  // The index on the strip of every pixel, if any
+  MatrixLayout layout_;  // The layout of the table
+  uint32_t budget_;  // The limit of the load, 0 if there is none
+  byte channel_milliamps_;  // The current of a channel at 255
+  FrameInterpolator *interpolator_;  // The frames of the mode, if blended
+  unsigned long interval_;      // The interval of the blended frames
+  unsigned long step_time_;     // The time of the latest step of the mode
+  unsigned long refresh_time_;  // The time of the latest blended frame
+  uint16_t fraction_;  // The progress of the step in 1/256
+  bool restart_;  // Whether the mode has to draw its frame in full
+  bool all_;      // Whether the next blend writes all pixels
 };
 
 }  // namespace mode
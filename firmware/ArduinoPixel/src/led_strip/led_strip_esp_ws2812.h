@@ -32,30 +32,136 @@
 
 #include "external/esp_ws2812/esp_ws2812.h"
 #include "led_strip/led_strip_base.h"
+#include "pixel_format.h"
 
 namespace arduino_pixel {
 namespace led_strip {
 
+/**
+ * \brief LED strip of WS2812 and similar LEDs on the RMT of an ESP32.
+ * \details The colors are encoded to the order on the wire as they're set,
+ * by the encoder of the format, whose channel offsets are constants.
+ * \tparam F number and order of the color channels, e.g. GRBW for SK6812
+ * RGBW LEDs.
+ */
+template <PixelFormat F = PixelFormat::GRB>
 class LedStripEspWs2812 : public LedStripBase {
  public:
-  LedStripEspWs2812(const int &num_leds, const int &pin, Ws2812::LedType type)
-      : strip_(num_leds, pin, type) {}
+  typedef typename PixelFormatEncoder<F>::type Encoder;
 
-  virtual void init() override { strip_.init(); }
+  /**
+   * \param[in] num_leds number of LEDs.
+   * \param[in] pin data pin.
+   * \param[in] type LED type.
+   * \param[in] palette_bits bits per pixel (4 or 8) of an indexed frame
+   * buffer. With 0, the frame buffer stores the color of every pixel.
+   */
+  LedStripEspWs2812(const int &num_leds, const int &pin, Ws2812::LedType type,
+                    uint8_t palette_bits = 0)
+      : strip_(num_leds, pin, type, Encoder::kChannels, palette_bits),
+        default_palette_(false) {}
 
-  virtual void colorize(bool force = false) override {
-    if (not mode_->update() and not force) return;
-    for (uint16_t idx = 0; idx < strip_.numPixels(); ++idx) {
-      const Color &color = mode_->getPixel(idx);
-      strip_.setPixelColor(idx, color.red, color.green, color.blue);
-    }
-    strip_.show();
+  virtual void init() override {
+    strip_.init();
+    resetPalette();
   }
 
-  virtual int getNumLeds() const { return strip_.numPixels(); }
+  virtual void show() override { strip_.show(); }
+
+  virtual int getNumLeds() const override { return strip_.numPixels(); }
+
+  virtual int getPaletteSize() const override { return strip_.paletteSize(); }
+
+  virtual void resetPalette() override {
+    int size = strip_.paletteSize();
+    if (size == 256) {
+      // RGB332: 3 bits for red, 3 bits for green, 2 bits for blue
+      for (int entry = 0; entry < 256; ++entry)
+        writePaletteColor(entry, Color((entry >> 5) * 255 / 7,
+                                       ((entry >> 2) & 7) * 255 / 7,
+                                       (entry & 3) * 255 / 3));
+    } else if (size == 16) {
+      // The 8 colors of the RGB cube at half and full intensity
+      for (int entry = 0; entry < 16; ++entry) {
+        byte level = (entry & 8) ? 255 : 128;
+        writePaletteColor(entry, Color((entry & 1) ? level : 0,
+                                       (entry & 2) ? level : 0,
+                                       (entry & 4) ? level : 0));
+      }
+    }
+    default_palette_ = true;
+  }
 
  protected:
+  virtual Color readPixel(int idx) const override {
+    const byte *pixel =
+        strip_.paletteSize()
+            ? strip_.getPalette() + kChannels * strip_.getPixelIndex(idx)
+            : strip_.getPixels() + kChannels * idx;
+    Color color;
+    Encoder::decode(pixel, color.red, color.green, color.blue);
+    return color;
+  }
+
+  virtual void writePixel(int idx, const Color &color) override {
+    if (strip_.paletteSize()) {
+      strip_.setPixelIndex(idx, findPaletteEntry(color));
+      return;
+    }
+    Encoder::encode(strip_.getPixels() + kChannels * idx, color.red,
+                    color.green, color.blue);
+  }
+
+  virtual void rotatePixels(int count) override {
+    byte *pixels = strip_.getPixels();
+    int bytes_per_pixel = strip_.getBytesPerPixel();
+    if (bytes_per_pixel == 0) {  // Pixels share bytes in a 4-bit buffer
+      LedStripBase::rotatePixels(count);
+      return;
+    }
+    rotateBytes(pixels, bytes_per_pixel * strip_.numPixels(),
+                bytes_per_pixel * count);
+  }
+
+  virtual void writePaletteColor(int entry, const Color &color) override {
+    if (entry >= strip_.paletteSize()) return;
+    Encoder::encode(strip_.getPalette() + kChannels * entry, color.red,
+                    color.green, color.blue);
+    default_palette_ = false;
+  }
+
+  virtual void writePixelIndex(int idx, byte entry) override {
+    strip_.setPixelIndex(idx, entry);
+  }
+
+ private:
+  static const byte kChannels = Encoder::kChannels;
+
+  byte findPaletteEntry(const Color &color) const {
+    // The default 8-bit palette maps directly; otherwise pick the nearest
+    // color
+    int size = strip_.paletteSize();
+    if (size == 256 and default_palette_)
+      return (color.red & 0xE0) | ((color.green & 0xE0) >> 3) |
+             (color.blue >> 6);
+    byte best = 0;
+    uint16_t best_distance = 0xFFFF;
+    for (int entry = 0; entry < size; ++entry) {
+      byte r, g, b;
+      Encoder::decode(strip_.getPalette() + kChannels * entry, r, g, b);
+      uint16_t distance =
+          abs(r - color.red) + abs(g - color.green) + abs(b - color.blue);
+      if (distance < best_distance) {
+        best = entry;
+        best_distance = distance;
+        if (distance == 0) break;
+      }
+    }
+    return best;
+  }
+
   Ws2812 strip_;
+  bool default_palette_;
 };
 
 }  // namespace led_strip
@@ -38,27 +38,53 @@ namespace led_strip {
 
 class LedStripNeoPixel : public LedStripBase {
  public:
+  /**
+   * \param[in] num_leds number of LEDs.
+   * \param[in] pin data pin.
+   * \param[in] type channel order and speed, e.g. NEO_GRB + NEO_KHZ800. On
+   * RGBW types, e.g. NEO_GRBW, the white LED emits the part of a color that
+   * is common to red, green, and blue.
+   */
   LedStripNeoPixel(const int &num_leds, const int &pin, neoPixelType type)
-      : strip_(num_leds, pin, type) {}
+      : strip_(num_leds, pin, type),
+        rgbw_(((type >> 6) & 3) != ((type >> 4) & 3)) {}
 
   virtual void init() override {
     strip_.begin();
     strip_.show();
   }
 
-  virtual void colorize(bool force = false) override {
-    if (not mode_->update() and not force) return;
-    for (uint16_t idx = 0; idx < strip_.numPixels(); ++idx) {
-      const Color &color = mode_->getPixel(idx);
+  virtual void show() override { strip_.show(); }
+
+  virtual int getNumLeds() const override { return strip_.numPixels(); }
+
+ protected:
+  virtual Color readPixel(int idx) const override {
+    uint32_t color = strip_.getPixelColor(idx);
+    byte white = color >> 24;
+    return Color(((color >> 16) & 0xFF) + white, ((color >> 8) & 0xFF) + white,
+                 (color & 0xFF) + white);
+  }
+
+  virtual void rotatePixels(int count) override {
+    int bytes_per_pixel = rgbw_ ? 4 : 3;
+    rotateBytes(strip_.getPixels(), bytes_per_pixel * strip_.numPixels(),
+                bytes_per_pixel * count);
+  }
+
+  virtual void writePixel(int idx, const Color &color) override {
+    if (not rgbw_) {
       strip_.setPixelColor(idx, color.red, color.green, color.blue);
+      return;
     }
-    strip_.show();
+    byte white = min(color.red, min(color.green, color.blue));
+    strip_.setPixelColor(idx, color.red - white, color.green - white,
+                         color.blue - white, white);
   }
 
-  virtual int getNumLeds() const { return strip_.numPixels(); }
-
- protected:
   Adafruit_NeoPixel strip_;
+  // The white channel is stored in the same position as red on RGB types
+  const bool rgbw_;
 };
 
 }  // namespace led_strip
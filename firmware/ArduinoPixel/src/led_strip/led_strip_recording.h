@@ -0,0 +1,112 @@
+/*! \file led_strip_recording.h
+ *  \brief Defines an LED strip that records its frames.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_LED_STRIP_LED_STRIP_RECORDING_H
+#define ARDUINO_PIXEL_LED_STRIP_LED_STRIP_RECORDING_H
+
+#include "clock.h"
+#include "led_strip/led_strip_base.h"
+
+namespace arduino_pixel {
+namespace led_strip {
+
+/**
+ * \brief LED strip that writes every frame to a stream instead of LEDs.
+ * \details The stream, e.g. a file on the host or a serial port, gets a
+ * header, and then a record for every shown frame. All values are little
+ * endian.
+ *   header: "APXL", version (1 byte), number of LEDs (2 bytes)
+ *   frame: time in ms (4 bytes), r, g, b of every LED
+ * \note The linux/cmd_line/arduino_pixel_replay tool renders a recording to
+ * an image or previews it on a terminal.
+ */
+class LedStripRecording : public LedStripBase {
+ public:
+  static const byte kVersion = 1;
+
+  /**
+   * \param[in] num_leds number of LEDs.
+   * \param[in] output stream that receives the recording.
+   */
+  LedStripRecording(const int &num_leds, Print &output)
+      : num_leds_(num_leds),
+        pixels_(new byte[3 * num_leds]()),
+        output_(output),
+        num_frames_(0) {}
+
+  virtual ~LedStripRecording() { delete[] pixels_; }
+
+  virtual void init() override {
+    output_.print(F("APXL"));
+    output_.write(kVersion);
+    output_.write(num_leds_ & 0xFF);
+    output_.write(num_leds_ >> 8);
+  }
+
+  virtual void show() override {
+    unsigned long time = Clock::millis();
+    for (byte i = 0; i < 4; ++i) output_.write((time >> (8 * i)) & 0xFF);
+    output_.write(pixels_, 3 * num_leds_);
+    ++num_frames_;
+  }
+
+  virtual int getNumLeds() const override { return num_leds_; }
+
+  /**
+   * \brief Gets the number of recorded frames.
+   */
+  unsigned long getNumFrames() const { return num_frames_; }
+
+ protected:
+  virtual Color readPixel(int idx) const override {
+    const byte *pixel = pixels_ + 3 * idx;
+    return Color(pixel[0], pixel[1], pixel[2]);
+  }
+
+  virtual void writePixel(int idx, const Color &color) override {
+    byte *pixel = pixels_ + 3 * idx;
+    pixel[0] = color.red;
+    pixel[1] = color.green;
+    pixel[2] = color.blue;
+  }
+
+  virtual void rotatePixels(int count) override {
+    rotateBytes(pixels_, 3 * num_leds_, 3 * count);
+  }
+
+ private:
+  int num_leds_;
+  byte *pixels_;
+  Print &output_;
+  unsigned long num_frames_;
+};
+
+}  // namespace led_strip
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_LED_STRIP_LED_STRIP_RECORDING_H
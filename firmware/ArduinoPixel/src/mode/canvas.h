@@ -0,0 +1,173 @@
+/*! \file canvas.h
+ *  \brief Defines the canvas mode.
+ *  \details The mode shows pixels that are set in parts over the network.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_MODE_CANVAS_H
+#define ARDUINO_PIXEL_MODE_CANVAS_H
+
+#include "scratch_arena.h"
+#include "mode/mode_base.h"
+
+namespace arduino_pixel {
+namespace mode {
+
+/**
+ * \brief Shows a canvas of pixels that are set in parts.
+ * \details The mode keeps the colors of all the pixels, so a part can be
+ * changed without sending the rest again, and the canvas survives the strip
+ * being turned off. The ranges that change are tracked, and an update
+ * writes only them to the frame buffer, so it costs in proportion to the
+ * pixels that change. The pixels are taken from the scratch arena, or from
+ * the heap when they do not fit in it.
+ */
+class Canvas : public ModeBase {
+ public:
+  static const byte kMaxRanges = 4;
+
+  Canvas(const int& num_leds)
+      : ModeBase(num_leds),
+        pixels_(nullptr),
+        owned_(num_leds * sizeof(Color) > ScratchArena::kCapacity),
+        color_(0, 0, 0),
+        num_ranges_(0) {
+    // The arena is empty when the mode starts, so only the heap can fail,
+    // and that is known before the mode replaces another
+    if (owned_) clear(new Color[num_leds]);
+  }
+
+  virtual ~Canvas() {
+    if (owned_) delete[] pixels_;
+  }
+
+  virtual void init() override {
+    if (not pixels_ and not owned_) {
+      clear(static_cast<Color*>(ScratchArena::allocate(num_leds_ *
+                                                       sizeof(Color))));
+      if (not pixels_) {
+        clear(new Color[num_leds_]);
+        owned_ = true;
+      }
+    }
+    num_ranges_ = 0;
+  }
+
+  /**
+   * rief Checks whether the pixels are available.
+   * eturn False if the heap could not hold the pixels, true otherwise.
+   */
+  bool isValid() const { return pixels_ or not owned_; }
+
+  virtual bool update(FrameBuffer& frame) override {
+    if (num_ranges_ == 0) return false;
+    for (byte i = 0; i < num_ranges_; ++i)
+      for (int idx = ranges_[i].first; idx < ranges_[i].last; ++idx)
+        frame.setPixel(idx, pixels_[idx]);
+    num_ranges_ = 0;
+    return true;
+  }
+
+  virtual void render(FrameBuffer& frame) override {
+    for (int idx = 0; idx < num_leds_; ++idx) frame.setPixel(idx, pixels_[idx]);
+    num_ranges_ = 0;
+  }
+
+  virtual const Color& getColor(int idx = 0) const override { return color_; }
+
+  virtual void setColor(const Color& color, int idx = 0) override {
+    color_ = color;
+  }
+
+  virtual Mode getModeType() const override { return Mode::CANVAS; }
+
+  virtual const __FlashStringHelper* getMode() const override {
+    return toString(Mode::CANVAS);
+  }
+
+  /**
+   * \brief Sets a range of pixels to a color.
+   * \details The pixels are shown on the next update.
+   * \param[in] first the index of the first pixel.
+   * \param[in] count the number of pixels, such that the range is within the
+   * strip.
+   * \param[in] color the color.
+   */
+  void setPixels(int first, int count, const Color& color) {
+    for (int idx = first; idx < first + count; ++idx) pixels_[idx] = color;
+    markRange(first, first + count);
+  }
+
+ private:
+  struct Range {
+    int first;
+    int last;  // Past the last pixel
+  };
+
+  /**
+   * \brief Takes a block for the pixels and turns them off.
+   * \param[in] pixels the block, or nullptr if the allocation failed.
+   */
+  void clear(Color* pixels) {
+    pixels_ = pixels;
+    if (not pixels_) return;
+    for (int idx = 0; idx < num_leds_; ++idx) pixels_[idx] = Color(0, 0, 0);
+  }
+
+  /**
+   * \brief Adds a range to the ranges that have changed.
+   * \details A range that touches another is merged with it. When all the
+   * slots are taken, the last range grows to cover the new one, so the
+   * update may write a few unchanged pixels, but never misses one.
+   */
+  void markRange(int first, int last) {
+    for (byte i = 0; i < num_ranges_; ++i) {
+      if (first <= ranges_[i].last and last >= ranges_[i].first) {
+        ranges_[i].first = min(ranges_[i].first, first);
+        ranges_[i].last = max(ranges_[i].last, last);
+        return;
+      }
+    }
+    if (num_ranges_ < kMaxRanges) {
+      ranges_[num_ranges_++] = {first, last};
+      return;
+    }
+    Range& range = ranges_[kMaxRanges - 1];
+    range.first = min(range.first, first);
+    range.last = max(range.last, last);
+  }
+
+  Color* pixels_;  // The colors of all the pixels
+  bool owned_;  // Whether the pixels are on the heap
+  Color color_;  // The color of the state, which the canvas does not show
+  Range ranges_[kMaxRanges];  // The ranges that have changed since the update
+  byte num_ranges_;
+};
+
+}  // namespace mode
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_MODE_CANVAS_H
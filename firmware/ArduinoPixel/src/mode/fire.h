@@ -0,0 +1,168 @@
+/*! \file fire.h
+ *  \brief Defines the fire mode.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_MODE_FIRE_H
+#define ARDUINO_PIXEL_MODE_FIRE_H
+
+#include "effects.h"
+#include "scratch_arena.h"
+#include "mode/mode_base.h"
+
+namespace arduino_pixel {
+namespace mode {
+
+/**
+ * \brief Simulates flames with the diffusion of heat.
+ * \details Every pixel holds a heat, which cools down by a random amount
+ * and drifts up on every step, while random sparks ignite at the bottom.
+ * A strip is a single column with the bottom at its first pixel, and a
+ * matrix a column of flames per column, with the bottom at its last row.
+ * The heat takes a byte per LED from the scratch arena, or from the heap
+ * when the arena is exhausted. A pixel costs a random number, a few adds,
+ * and a multiply per step, and, with a palette, the heat is the index of
+ * a pixel to a palette of the heat colors. The flames are random, so they
+ * aren't synchronized among strips.
+ */
+class Fire : public ModeBase {
+ public:
+  static const byte kCooling = 55;   // How fast the flames cool down
+  static const byte kSparking = 120;  // The chance of a spark in 1/256
+
+  Fire(const int& num_leds, const unsigned long& period)
+      : ModeBase(num_leds),
+        color_(0, 0, 0),
+        period_(period),
+        step_(0),
+        heat_(nullptr),
+        owned_(false) {}
+
+  virtual ~Fire() {
+    if (owned_) delete[] heat_;
+  }
+
+  virtual void init() override {
+    if (not heat_) {
+      heat_ = static_cast<byte*>(ScratchArena::allocate(num_leds_));
+      if (not heat_) {
+        heat_ = new byte[num_leds_];
+        owned_ = true;
+      }
+    }
+    for (int idx = 0; idx < num_leds_; ++idx) heat_[idx] = 0;
+    random_.seed(Clock::micros());
+    step_ = Clock::groupMillis() / period_;
+  }
+
+  virtual bool update(FrameBuffer& frame) override {
+    unsigned long step = Clock::groupMillis() / period_;
+    if (step == step_) return false;
+    step_ = step;
+    burn(frame);
+    draw(frame);
+    return true;
+  }
+
+  virtual void render(FrameBuffer& frame) override {
+    int palette_size = frame.getPaletteSize();
+    for (int entry = 0; entry < palette_size; ++entry)
+      frame.setPaletteColor(entry, heatColor(entry * 256 / palette_size));
+    draw(frame);
+  }
+
+  virtual const Color& getColor(int idx = 0) const override { return color_; }
+
+  virtual void setColor(const Color& color, int idx = 0) override {
+    color_ = color;
+  }
+
+  virtual unsigned long getPeriod() const override { return period_; }
+
+  virtual Mode getModeType() const override { return Mode::FIRE; }
+
+  virtual const __FlashStringHelper* getMode() const override {
+    return toString(Mode::FIRE);
+  }
+
+ private:
+  /**
+   * \brief Advances the heat by a step.
+   * \details The heat of a column is contiguous, from its bottom up.
+   */
+  void burn(const FrameBuffer& frame) {
+    int columns, rows;
+    getSize(frame, columns, rows);
+    byte cooling = min(255, kCooling * 10 / rows + 2);
+    byte spark_rows = min(rows, 7);
+    for (int column = 0; column < columns; ++column) {
+      byte* heat = heat_ + column * rows;
+      for (int row = 0; row < rows; ++row)
+        heat[row] = qsub8(heat[row], random_.next(cooling));
+      // The heat drifts up and diffuses, (a + 2b) * 85 / 256 for (a + 2b) / 3
+      for (int row = rows - 1; row >= 2; --row)
+        heat[row] = ((uint16_t)(heat[row - 1] + 2 * heat[row - 2]) * 85) >> 8;
+      if (random_.next() < kSparking) {
+        byte row = random_.next(spark_rows);
+        heat[row] = qadd8(heat[row], random_.next(160, 255));
+      }
+    }
+  }
+
+  void draw(FrameBuffer& frame) const {
+    int columns, rows;
+    getSize(frame, columns, rows);
+    int palette_size = frame.getPaletteSize();
+    for (int column = 0; column < columns; ++column) {
+      const byte* heat = heat_ + column * rows;
+      for (int row = 0; row < rows; ++row) {
+        int idx = (columns > 1) ? (rows - 1 - row) * columns + column : row;
+        if (palette_size)
+          frame.setPixelIndex(idx, (heat[row] * palette_size) >> 8);
+        else
+          frame.setPixel(idx, heatColor(heat[row]));
+      }
+    }
+  }
+
+  void getSize(const FrameBuffer& frame, int& columns, int& rows) const {
+    bool matrix = frame.getHeight() > 1;
+    columns = matrix ? frame.getWidth() : 1;
+    rows = matrix ? frame.getHeight() : num_leds_;
+  }
+
+  Color color_;           // Unused, since the flames have the heat colors
+  unsigned long period_;  // The period of a step of the heat
+  unsigned long step_;    // The step of the latest frame
+  byte* heat_;            // The heat of every pixel
+  bool owned_;            // Whether the heat is on the heap
+  Random8 random_;
+};
+
+}  // namespace mode
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_MODE_FIRE_H
@@ -0,0 +1,119 @@
+/*! \file gradient.h
+ *  \brief Defines the gradient mode.
+ *  \details A gradient through a number of colors spans the entire strip.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_MODE_GRADIENT_H
+#define ARDUINO_PIXEL_MODE_GRADIENT_H
+
+#include "mode/mode_base.h"
+
+namespace arduino_pixel {
+namespace mode {
+
+class Gradient : public ModeBase {
+ public:
+  static const byte kMaxColors = 4;
+
+  Gradient(const int& num_leds) : Gradient(num_leds, false) {}
+
+  virtual ~Gradient() {}
+
+  virtual void init() override {}
+
+  virtual bool update(FrameBuffer& frame) override { return false; }
+
+  virtual void render(FrameBuffer& frame) override {
+    for (int idx = 0; idx < num_leds_; ++idx)
+      frame.setPixel(idx, interpolate(idx));
+  }
+
+  virtual const Color& getColor(int idx = 0) const override {
+    return colors_[(idx >= 0 and idx < num_colors_) ? idx : 0];
+  }
+
+  virtual void setColor(const Color& color, int idx = 0) override {
+    if (idx >= 0 and idx < kMaxColors) colors_[idx] = color;
+  }
+
+  virtual int getNumColors() const override { return num_colors_; }
+
+  virtual void setNumColors(int num_colors) override {
+    if (num_colors >= 1 and num_colors <= kMaxColors) num_colors_ = num_colors;
+  }
+
+  virtual Mode getModeType() const override { return Mode::GRADIENT; }
+
+  virtual const __FlashStringHelper* getMode() const override {
+    return toString(Mode::GRADIENT);
+  }
+
+ protected:
+  /**
+   * \param[in] num_leds number of LEDs.
+   * \param[in] wrap flag to indicate whether the gradient returns from the
+   * last color to the first, so that it can move around the strip.
+   */
+  Gradient(const int& num_leds, bool wrap)
+      : ModeBase(num_leds), wrap_(wrap), num_colors_(2) {
+    colors_[0] = Color(255, 0, 0);
+    colors_[1] = Color(0, 0, 255);
+    for (byte i = 2; i < kMaxColors; ++i) colors_[i] = Color(0, 0, 0);
+  }
+
+  /**
+   * \brief Gets the color of the gradient at a position.
+   * \details The colors are evenly spaced along the strip, and the pixels
+   * between two colors are linearly interpolated.
+   * \param[in] pos a position in [0, num_leds).
+   * \return The color.
+   */
+  Color interpolate(int pos) const {
+    int spans = wrap_ ? num_colors_ : num_colors_ - 1;
+    int length = wrap_ ? num_leds_ : num_leds_ - 1;
+    if (spans == 0 or length == 0) return colors_[0];
+    // The position in 1/256 of the distance between two colors
+    uint32_t t = (uint32_t)pos * spans * 256 / length;
+    byte first = t >> 8;
+    int weight = t & 255;
+    // The last pixel of a gradient that doesn't wrap has a weight of 0
+    const Color& a = colors_[first];
+    const Color& b = colors_[(first + 1) % num_colors_];
+    return Color(a.red + (b.red - a.red) * weight / 256,
+                 a.green + (b.green - a.green) * weight / 256,
+                 a.blue + (b.blue - a.blue) * weight / 256);
+  }
+
+  const bool wrap_;
+  byte num_colors_;
+  Color colors_[kMaxColors];
+};
+
+}  // namespace mode
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_MODE_GRADIENT_H
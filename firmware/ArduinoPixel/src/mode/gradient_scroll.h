@@ -0,0 +1,90 @@
+/*! \file gradient_scroll.h
+ *  \brief Defines the scrolling gradient mode.
+ *  \details A gradient through a number of colors moves around the strip.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_MODE_GRADIENT_SCROLL_H
+#define ARDUINO_PIXEL_MODE_GRADIENT_SCROLL_H
+
+#include "mode/gradient.h"
+
+namespace arduino_pixel {
+namespace mode {
+
+/**
+ * \brief Moves a gradient around the strip.
+ * \details The gradient is drawn once, and every step rotates the frame
+ * buffer by a pixel, so a step costs the same for any number of colors.
+ */
+class GradientScroll : public Gradient {
+ public:
+  GradientScroll(const int& num_leds, const unsigned long& period)
+      : Gradient(num_leds, true), period_(period), step_(0), offset_(0) {}
+
+  virtual ~GradientScroll() {}
+
+  virtual void init() override {
+    step_ = Clock::groupMillis() / period_;
+    offset_ = step_ % num_leds_;
+  }
+
+  virtual bool update(FrameBuffer& frame) override {
+    // The phase follows the group time, so synchronized devices move together
+    unsigned long step = Clock::groupMillis() / period_;
+    if (step == step_) return false;
+    offset_ = step % num_leds_;
+    if (step == step_ + 1)
+      frame.rotate(1);
+    else
+      render(frame);  // The group time has been adjusted
+    step_ = step;
+    return true;
+  }
+
+  virtual void render(FrameBuffer& frame) override {
+    for (int idx = 0; idx < num_leds_; ++idx)
+      frame.setPixel(idx, interpolate((idx + num_leds_ - offset_) % num_leds_));
+  }
+
+  virtual unsigned long getPeriod() const override { return period_; }
+
+  virtual Mode getModeType() const override { return Mode::GRADIENT_SCROLL; }
+
+  virtual const __FlashStringHelper* getMode() const override {
+    return toString(Mode::GRADIENT_SCROLL);
+  }
+
+ private:
+  unsigned long period_;  // The period at which the gradient moves
+  unsigned long step_;  // The step of the latest frame
+  int offset_;  // The number of pixels the gradient has moved
+};
+
+}  // namespace mode
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_MODE_GRADIENT_SCROLL_H
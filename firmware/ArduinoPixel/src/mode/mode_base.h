@@ -30,6 +30,8 @@
 #define ARDUINO_PIXEL_MODE_BASE_H
 
 #include "common_types.h"
+#include "clock.h"
+#include "frame_buffer.h"
 
 namespace arduino_pixel {
 namespace mode {
@@ -40,22 +42,25 @@ class ModeBase {
   /**
    * \brief Initializes the mode.
    * \note Use to initialize any member variables when appropriate.
-   * E.g. Initialize the LED array after the base color has been set.
+   * E.g. Reserve scratch memory after the mode has become the active one.
    */
   virtual void init() = 0;
   /**
-   * \brief Updates the colors on the LED array.
+   * \brief Updates the colors on the frame buffer.
    * \note If you think the mode as a video (sequence of images), 
-   * this is where you fill the LED array with the next image.
-   * \return Flag to indicate whether the LED array has been updated.
+   * this is where you draw the next image. Only the pixels that change
+   * need to be written.
+   * \param[in] frame the frame buffer of the LED strip.
+   * \return Flag to indicate whether the frame buffer has been updated.
    */
-  virtual bool update() = 0;
+  virtual bool update(FrameBuffer& frame) = 0;
   /**
-   * \brief Gets the color of the request LED (aka pixel).
-   * \param[in] idx the index of the pixel in the array.
-   * \return The color of the pixel.
+   * \brief Draws the current image on the frame buffer.
+   * \note Writes every pixel, since the frame buffer may hold the image
+   * of another mode.
+   * \param[in] frame the frame buffer of the LED strip.
    */
-  virtual const Color& getPixel(int idx = 0) const = 0;
+  virtual void render(FrameBuffer& frame) = 0;
   /**
    * \brief Gets the requested color.
    * \param[in] idx the index of the color in the color array.
@@ -70,6 +75,23 @@ class ModeBase {
    * \param[in] idx the index of the color.
    */
   virtual void setColor(const Color& color, int idx = 0) = 0;
+  /**
+   * \brief Gets the number of base colors.
+   * \return The number of colors.
+   */
+  virtual int getNumColors() const { return 1; }
+  /**
+   * \brief Sets the number of base colors.
+   * \note Modes with a variable number of colors override it. The rest keep
+   * their number of colors.
+   * \param[in] num_colors the number of colors.
+   */
+  virtual void setNumColors(int num_colors) {}
+  /**
+   * \brief Gets the period at which the mode updates.
+   * \return The period in ms, or 0 if the mode is static.
+   */
+  virtual unsigned long getPeriod() const { return 0; }
   /**
    * \brief Gets the name of the mode.
    * \return The mode as a C++ type.
@@ -77,9 +99,9 @@ class ModeBase {
   virtual Mode getModeType() const = 0;
   /**
    * \brief The name of the mode.
-   * \return The mode as a string.
+   * \return The mode as a string in flash.
    */
-  virtual String getMode() const = 0;
+  virtual const __FlashStringHelper* getMode() const = 0;
 
  protected:
   ModeBase(const int& num_leds) : num_leds_(num_leds) {}
@@ -0,0 +1,131 @@
+/*! \file noise.h
+ *  \brief Defines the noise mode.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_MODE_NOISE_H
+#define ARDUINO_PIXEL_MODE_NOISE_H
+
+#include "effects.h"
+#include "mode/mode_base.h"
+
+namespace arduino_pixel {
+namespace mode {
+
+/**
+ * \brief Colors the pixels with value noise that changes over time.
+ * \details On a strip, the noise is a plane of the position and the time,
+ * so the pixels change in place. On a matrix, it's a plane of the columns
+ * and the rows that drifts over time. The noise is mapped to a gradient of
+ * up to 4 colors, or, with a single color, to its brightness. The noise
+ * follows the group time, so synchronized strips show the same noise. A
+ * pixel costs the 2D noise, i.e. 8 table reads and 3 multiplies, and the
+ * gradient, 3 more, or a multiply when the frame buffer has a palette.
+ */
+class Noise : public ModeBase {
+ public:
+  static const byte kMaxColors = 4;
+  static const byte kScale = 32;  // The distance of two pixels in 1/256
+  static const byte kSpeed = 8;   // The distance of two steps in 1/256
+
+  Noise(const int& num_leds, const unsigned long& period)
+      : ModeBase(num_leds), period_(period), step_(0), num_colors_(1) {
+    for (byte i = 0; i < kMaxColors; ++i) colors_[i] = Color(0, 0, 0);
+  }
+
+  virtual ~Noise() {}
+
+  virtual void init() override { step_ = Clock::groupMillis() / period_; }
+
+  virtual bool update(FrameBuffer& frame) override {
+    unsigned long step = Clock::groupMillis() / period_;
+    if (step == step_) return false;
+    step_ = step;
+    draw(frame);
+    return true;
+  }
+
+  virtual void render(FrameBuffer& frame) override {
+    int palette_size = frame.getPaletteSize();
+    for (int entry = 0; entry < palette_size; ++entry) {
+      byte value = entry * 256 / palette_size;
+      frame.setPaletteColor(entry, gradientColor(colors_, num_colors_, value));
+    }
+    draw(frame);
+  }
+
+  virtual const Color& getColor(int idx = 0) const override {
+    return colors_[(idx >= 0 and idx < num_colors_) ? idx : 0];
+  }
+
+  virtual void setColor(const Color& color, int idx = 0) override {
+    if (idx >= 0 and idx < kMaxColors) colors_[idx] = color;
+  }
+
+  virtual int getNumColors() const override { return num_colors_; }
+
+  virtual void setNumColors(int num_colors) override {
+    if (num_colors >= 1 and num_colors <= kMaxColors) num_colors_ = num_colors;
+  }
+
+  virtual unsigned long getPeriod() const override { return period_; }
+
+  virtual Mode getModeType() const override { return Mode::NOISE; }
+
+  virtual const __FlashStringHelper* getMode() const override {
+    return toString(Mode::NOISE);
+  }
+
+ private:
+  void draw(FrameBuffer& frame) const {
+    uint16_t time = step_ * kSpeed;
+    int palette_size = frame.getPaletteSize();
+    int width = frame.getWidth();
+    int height = frame.getHeight();
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        byte value = (height > 1)
+                         ? noise8(x * kScale + time, y * kScale + time / 2)
+                         : noise8(x * kScale, time);
+        int idx = y * width + x;
+        if (palette_size)
+          frame.setPixelIndex(idx, (value * palette_size) >> 8);
+        else
+          frame.setPixel(idx, gradientColor(colors_, num_colors_, value));
+      }
+    }
+  }
+
+  unsigned long period_;  // The period at which the noise moves
+  unsigned long step_;    // The step of the latest frame
+  byte num_colors_;
+  Color colors_[kMaxColors];
+};
+
+}  // namespace mode
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_MODE_NOISE_H
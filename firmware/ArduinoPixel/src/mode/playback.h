@@ -0,0 +1,138 @@
+/*! \file playback.h
+ *  \brief Defines the playback mode.
+ *  \details The mode plays an animation that was uploaded to the device.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_MODE_PLAYBACK_H
+#define ARDUINO_PIXEL_MODE_PLAYBACK_H
+
+#include "animation.h"
+#include "mode/mode_base.h"
+
+namespace arduino_pixel {
+namespace mode {
+
+/**
+ * \brief Plays an animation.
+ * \details Every step applies the next frame to the frame buffer, so it
+ * costs in proportion to the pixels that change. A looping animation is in
+ * phase with the group time, so synchronized devices play it together. An
+ * animation that doesn't loop plays once from the time the mode starts, and
+ * then holds its last frame.
+ */
+class Playback : public ModeBase {
+ public:
+  /**
+   * \param[in] num_leds the number of LEDs.
+   * \param[in] animation the animation.
+   * \param[in] period the period of the frames in ms, or 0 for the period
+   * of the animation.
+   */
+  Playback(const int& num_leds, const Animation& animation,
+           const unsigned long& period)
+      : ModeBase(num_leds),
+        animation_(animation),
+        color_(0, 0, 0),
+        period_(period),
+        index_(-1),
+        offset_(0),
+        start_step_(0) {}
+
+  virtual ~Playback() {}
+
+  virtual void init() override {
+    index_ = -1;
+    start_step_ = getStep();
+  }
+
+  virtual bool update(FrameBuffer& frame) override {
+    if (animation_.getNumFrames() == 0) return false;
+    long target = getTarget();
+    if (target == index_) return false;
+    if (target < index_) index_ = -1;  // Start over from the first frame
+    decodeTo(target, frame);
+    return true;
+  }
+
+  virtual void render(FrameBuffer& frame) override {
+    frame.fill(Color(0, 0, 0));
+    index_ = -1;
+    if (animation_.getNumFrames()) decodeTo(getTarget(), frame);
+  }
+
+  virtual const Color& getColor(int idx = 0) const override { return color_; }
+
+  virtual void setColor(const Color& color, int idx = 0) override {
+    color_ = color;
+  }
+
+  virtual unsigned long getPeriod() const override {
+    return period_ ? period_ : animation_.getPeriod();
+  }
+
+  virtual Mode getModeType() const override { return Mode::PLAYBACK; }
+
+  virtual const __FlashStringHelper* getMode() const override {
+    return toString(Mode::PLAYBACK);
+  }
+
+ private:
+  unsigned long getStep() const {
+    unsigned long period = getPeriod();
+    return period ? Clock::groupMillis() / period : 0;
+  }
+
+  long getTarget() const {
+    unsigned long num_frames = animation_.getNumFrames();
+    if (animation_.isLooping()) return getStep() % num_frames;
+    return min(getStep() - start_step_, num_frames - 1);
+  }
+
+  /**
+   * \brief Applies the frames after the current one up to a frame.
+   * \details The frames are deltas, so none can be skipped.
+   */
+  void decodeTo(long target, FrameBuffer& frame) {
+    if (index_ < 0) offset_ = animation_.getFirstFrame();
+    while (index_ < target) {
+      offset_ = animation_.decodeFrame(offset_, frame);
+      ++index_;
+    }
+  }
+
+  const Animation& animation_;
+  Color color_;  // Unused, but kept for the mode to carry a color over
+  unsigned long period_;  // The period of the frames, 0 for the animation's
+  long index_;  // The index of the frame in the frame buffer, -1 for none
+  size_t offset_;  // The offset of the next frame in the animation
+  unsigned long start_step_;  // The step at which the mode started
+};
+
+}  // namespace mode
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_MODE_PLAYBACK_H
@@ -44,14 +44,14 @@ class Rainbow : public RainbowBase {
 
   virtual Mode getModeType() const override { return Mode::RAINBOW; }
 
-  virtual String getMode() const override { return toString(Mode::RAINBOW); }
+  virtual const __FlashStringHelper* getMode() const override {
+    return toString(Mode::RAINBOW);
+  }
 
  private:
-  void setPixels() {
-    for (uint16_t idx = 0; idx < num_leds_; ++idx)
-      pixels_[idx] = wheel((offset_ + idx) & 255);
-    offset_ = (offset_ + 1) % 256;
-  }
+  void setStep(unsigned long step) override { offset_ = step % 256; }
+
+  byte getPosition(uint16_t idx) const override { return idx & 255; }
 };
 
 }  // namespace mode
@@ -41,24 +41,41 @@ class RainbowBase : public ModeBase {
         color_(0, 0, 0),
         alpha_(0.5f),
         period_(period),
-        offset_(0) {
-    pixels_ = new Color[num_leds_];
-    last_update_time_ = millis();
-  }
+        step_(0),
+        offset_(0) {}
 
-  virtual ~RainbowBase() { delete[] pixels_; }
+  virtual ~RainbowBase() {}
 
-  virtual void init() override { setPixels(); }
+  virtual void init() override {
+    step_ = Clock::groupMillis() / period_;
+    setStep(step_);
+  }
 
-  virtual bool update() override {
-    unsigned long current_time = millis();
-    if ((unsigned long)(current_time - last_update_time_) < period_) return false;
-    setPixels();
-    last_update_time_ = current_time;
+  virtual bool update(FrameBuffer& frame) override {
+    // The phase follows the group time, so synchronized devices move together
+    unsigned long step = Clock::groupMillis() / period_;
+    if (step == step_) return false;
+    step_ = step;
+    setStep(step);
+    if (frame.getPaletteSize())
+      renderPalette(frame);  // The pixels keep their index to the palette
+    else
+      render(frame);
     return true;
   }
 
-  virtual const Color& getPixel(int idx) const override { return pixels_[idx]; }
+  virtual void render(FrameBuffer& frame) override {
+    int palette_size = frame.getPaletteSize();
+    if (palette_size == 0) {
+      for (uint16_t idx = 0; idx < num_leds_; ++idx)
+        frame.setPixel(idx, wheel((offset_ + getPosition(idx)) & 255));
+      return;
+    }
+    // The rainbow is quantized to the palette
+    renderPalette(frame);
+    for (uint16_t idx = 0; idx < num_leds_; ++idx)
+      frame.setPixelIndex(idx, (getPosition(idx) * palette_size) >> 8);
+  }
 
   virtual const Color& getColor(int idx = 0) const override { return color_; }
 
@@ -68,12 +85,37 @@ class RainbowBase : public ModeBase {
     alpha_ = alpha_ / 255.f;
   }
 
+  virtual unsigned long getPeriod() const override { return period_; }
+
   virtual Mode getModeType() const override = 0;
 
-  virtual String getMode() const override = 0;
+  virtual const __FlashStringHelper* getMode() const override = 0;
 
  protected:
-  virtual void setPixels() = 0;
+  /**
+   * \brief Moves the rainbow to a step.
+   * \param[in] step the number of periods of the group time.
+   */
+  virtual void setStep(unsigned long step) = 0;
+  /**
+   * \brief Gets the position of a pixel on the color wheel.
+   * \param[in] idx the index of the pixel.
+   * \return The position of the pixel, regardless of the offset.
+   */
+  virtual byte getPosition(uint16_t idx) const = 0;
+
+  /**
+   * \brief Draws the color wheel on the palette.
+   * \details Moving the rainbow only rotates the palette, so a step costs
+   * the same no matter the number of LEDs.
+   * \param[in] frame a frame buffer with a palette.
+   */
+  void renderPalette(FrameBuffer& frame) {
+    int palette_size = frame.getPaletteSize();
+    for (int entry = 0; entry < palette_size; ++entry)
+      frame.setPaletteColor(
+          entry, wheel((offset_ + entry * 256 / palette_size) & 255));
+  }
 
   /**
    * \brief Turns the requested value into a color.
@@ -100,9 +142,7 @@ class RainbowBase : public ModeBase {
   float alpha_;           // Defines the brightness ([0.0,1.0]) of the rainbow
   unsigned long period_;  // The period at which the rainbow moves
 
-  Color* pixels_;
-
-  unsigned long last_update_time_;
+  unsigned long step_;  // The step of the latest frame
   uint16_t offset_;
 };
 
@@ -44,15 +44,17 @@ class RainbowCycle : public RainbowBase {
 
   virtual Mode getModeType() const override { return Mode::RAINBOW_CYCLE; }
 
-  virtual String getMode() const override {
+  virtual const __FlashStringHelper* getMode() const override {
     return toString(Mode::RAINBOW_CYCLE);
   }
 
  private:
-  void setPixels() {
-    for (uint16_t idx = 0; idx < num_leds_; ++idx)
-      pixels_[idx] = wheel((offset_ + (idx * 256 / num_leds_)) & 255);
-    offset_ = (offset_ + 1) % (5 * 256);
+  void setStep(unsigned long step) override {
+    offset_ = step % (5 * 256);
+  }
+
+  byte getPosition(uint16_t idx) const override {
+    return (uint32_t)idx * 256 / num_leds_;
   }
 };
 
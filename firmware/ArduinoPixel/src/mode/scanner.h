@@ -44,35 +44,39 @@ class Scanner : public ModeBase {
   Scanner(const int& num_leds, const unsigned long& period)
       : ModeBase(num_leds), color_(0, 0, 0), period_(period) {
     length_ = min(16u, (unsigned int)(num_leds_ / 2));
-    pixels_ = new Color[num_leds_];
   }
 
-  virtual ~Scanner() { delete[] pixels_; }
-
-  virtual void init() override {
-    start_idx_ = 0;
-    end_idx_ = length_ - 1;
-
-    for (int i = 0; i <= end_idx_; ++i) turnPixelOn(i);
-    for (int i = end_idx_ + 1; i < num_leds_; ++i) turnPixelOff(i);
-
-    last_update_time_ = millis();
-  }
-
-  virtual bool update() override {
-    unsigned long current_time = millis();
-    if ((unsigned long)(current_time - last_update_time_) < period_) return false;
-
-    turnPixelOff(start_idx_);
-    start_idx_ = (start_idx_ + 1) % num_leds_;
-    end_idx_ = (end_idx_ + 1) % num_leds_;
-    turnPixelOn(end_idx_);
-
-    last_update_time_ = current_time;
+  virtual ~Scanner() {}
+
+  virtual void init() override { setStep(Clock::groupMillis() / period_); }
+
+  virtual bool update(FrameBuffer& frame) override {
+    // The phase follows the group time, so synchronized devices move together
+    unsigned long step = Clock::groupMillis() / period_;
+    if (step == step_) return false;
+    if (step != step_ + 1) {  // The group time has been adjusted
+      setStep(step);
+      render(frame);
+      return true;
+    }
+
+    // Only the tail and the head of the scanner change
+    bool indexed = frame.getPaletteSize() >= 2;
+    setPixel(frame, start_idx_, false, indexed);
+    setStep(step);
+    setPixel(frame, end_idx_, true, indexed);
     return true;
   }
 
-  virtual const Color& getPixel(int idx) const override { return pixels_[idx]; }
+  virtual void render(FrameBuffer& frame) override {
+    bool indexed = frame.getPaletteSize() >= 2;
+    if (indexed) {
+      frame.setPaletteColor(0, Color(0, 0, 0));
+      frame.setPaletteColor(1, color_);
+    }
+    for (int i = 0; i < num_leds_; ++i)
+      setPixel(frame, i, isPixelOn(i), indexed);
+  }
 
   virtual const Color& getColor(int idx = 0) const override { return color_; }
 
@@ -80,26 +84,40 @@ class Scanner : public ModeBase {
     color_ = color;
   }
 
+  virtual unsigned long getPeriod() const override { return period_; }
+
   virtual Mode getModeType() const override { return Mode::SCANNER; }
 
-  virtual String getMode() const override { return toString(Mode::SCANNER); }
+  virtual const __FlashStringHelper* getMode() const override {
+    return toString(Mode::SCANNER);
+  }
 
  private:
-  void turnPixelOff(int idx) {
-    static Color color(0, 0, 0);
-    pixels_[idx] = color;
+  void setPixel(FrameBuffer& frame, int idx, bool on, bool indexed) {
+    static Color off(0, 0, 0);
+    if (indexed)
+      frame.setPixelIndex(idx, on ? 1 : 0);
+    else
+      frame.setPixel(idx, on ? color_ : off);
   }
 
-  void turnPixelOn(int idx) { pixels_[idx] = color_; }
+  void setStep(unsigned long step) {
+    step_ = step;
+    start_idx_ = step % num_leds_;
+    end_idx_ = (start_idx_ + length_ - 1) % num_leds_;
+  }
+
+  bool isPixelOn(int idx) const {
+    if (start_idx_ <= end_idx_) return start_idx_ <= idx and idx <= end_idx_;
+    return start_idx_ <= idx or idx <= end_idx_;  // The scanner wraps around
+  }
 
   Color color_;           // Holds the active color of the scanner
   byte length_;           // The length of the scanner
   unsigned long period_;  // The period at which the scanner moves
 
-  Color* pixels_;
-
   boolean inited_;
-  unsigned long last_update_time_;
+  unsigned long step_;  // The step of the latest frame
   int start_idx_, end_idx_;
 };
 
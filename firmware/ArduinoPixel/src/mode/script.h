@@ -0,0 +1,140 @@
+/*! \file script.h
+ *  \brief Defines the script mode.
+ *  \details The mode runs a program that was uploaded to the device.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_MODE_SCRIPT_H
+#define ARDUINO_PIXEL_MODE_SCRIPT_H
+
+#include "program.h"
+#include "mode/mode_base.h"
+
+namespace arduino_pixel {
+namespace mode {
+
+/**
+ * \brief Colors every pixel with a program.
+ * \details The program runs for every pixel, a block of pixels at a time,
+ * on every step of the group time, so synchronized devices show the same
+ * frames. A program that doesn't
+ * read the time is only run when the mode is rendered. The colors of the mode
+ * are inputs of the program.
+ */
+class Script : public ModeBase {
+ public:
+  static const byte kMaxColors = 4;
+
+  /**
+   * \param[in] num_leds the number of LEDs.
+   * \param[in] program the program.
+   * \param[in] period the period of the frames in ms, or 0 for the period
+   * of the program.
+   */
+  Script(const int& num_leds, const Program& program,
+         const unsigned long& period)
+      : ModeBase(num_leds),
+        program_(program),
+        period_(period),
+        num_colors_(1),
+        step_(0) {
+    for (byte i = 0; i < kMaxColors; ++i) colors_[i] = Color(255, 255, 255);
+  }
+
+  virtual ~Script() {}
+
+  virtual void init() override { step_ = getStep(); }
+
+  virtual bool update(FrameBuffer& frame) override {
+    if (not program_.isAnimated()) return false;
+    unsigned long step = getStep();
+    if (step == step_) return false;
+    render(frame);
+    return true;
+  }
+
+  virtual void render(FrameBuffer& frame) override {
+    step_ = getStep();
+    Program::Context context;
+    context.count = num_leds_;
+    context.width = frame.getWidth();
+    context.time = Clock::groupMillis() & 0x7FFFFFFF;
+    context.step = step_ & 0x7FFFFFFF;
+    context.colors = colors_;
+    context.num_colors = num_colors_;
+    Color colors[Program::kBlock];
+    for (int first = 0; first < num_leds_; first += Program::kBlock) {
+      byte count = min(num_leds_ - first, (int)Program::kBlock);
+      program_.run(first, count, context, colors);
+      for (byte j = 0; j < count; ++j) frame.setPixel(first + j, colors[j]);
+    }
+  }
+
+  virtual const Color& getColor(int idx = 0) const override {
+    return colors_[(idx >= 0 and idx < num_colors_) ? idx : 0];
+  }
+
+  virtual void setColor(const Color& color, int idx = 0) override {
+    if (idx >= 0 and idx < kMaxColors) colors_[idx] = color;
+  }
+
+  virtual int getNumColors() const override { return num_colors_; }
+
+  virtual void setNumColors(int num_colors) override {
+    if (num_colors >= 1 and num_colors <= kMaxColors) num_colors_ = num_colors;
+  }
+
+  virtual unsigned long getPeriod() const override {
+    return program_.isAnimated() ? getFramePeriod() : 0;
+  }
+
+  virtual Mode getModeType() const override { return Mode::SCRIPT; }
+
+  virtual const __FlashStringHelper* getMode() const override {
+    return toString(Mode::SCRIPT);
+  }
+
+ private:
+  unsigned long getFramePeriod() const {
+    if (period_) return period_;
+    return program_.getPeriod() ? program_.getPeriod() : 20ul;
+  }
+
+  unsigned long getStep() const {
+    return Clock::groupMillis() / getFramePeriod();
+  }
+
+  const Program& program_;
+  unsigned long period_;  // The period of the frames, 0 for the program's
+  byte num_colors_;
+  Color colors_[kMaxColors];
+  unsigned long step_;  // The step of the latest frame
+};
+
+}  // namespace mode
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_MODE_SCRIPT_H
@@ -45,9 +45,16 @@ class SingleColor : public ModeBase {
 
   virtual void init() override {}
 
-  virtual bool update() override { return false; }
+  virtual bool update(FrameBuffer& frame) override { return false; }
 
-  virtual const Color& getPixel(int idx = 0) const override { return color_; }
+  virtual void render(FrameBuffer& frame) override {
+    if (frame.getPaletteSize() == 0) {
+      frame.fill(color_);
+      return;
+    }
+    frame.setPaletteColor(0, color_);
+    for (int idx = 0; idx < num_leds_; ++idx) frame.setPixelIndex(idx, 0);
+  }
 
   virtual const Color& getColor(int idx = 0) const override { return color_; }
 
@@ -57,7 +64,7 @@ class SingleColor : public ModeBase {
 
   virtual Mode getModeType() const override { return Mode::SINGLE_COLOR; }
 
-  virtual String getMode() const override {
+  virtual const __FlashStringHelper* getMode() const override {
     return toString(Mode::SINGLE_COLOR);
   }
 
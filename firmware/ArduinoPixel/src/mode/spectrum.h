@@ -0,0 +1,157 @@
+/*! \file spectrum.h
+ *  \brief Defines the spectrum mode.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_MODE_SPECTRUM_H
+#define ARDUINO_PIXEL_MODE_SPECTRUM_H
+
+#include "effects.h"
+#include "sampler.h"
+#include "spectrum_analyzer.h"
+#include "mode/mode_base.h"
+
+namespace arduino_pixel {
+namespace mode {
+
+/**
+ * \brief Shows the levels of the frequency bands of an audio input as bars.
+ * \details On a strip, every band has a segment, from the lowest frequency
+ * at the first pixel, and on a matrix a column, from the bottom up. The bars
+ * are colored with a gradient of up to 4 colors along their length, or with
+ * a single color. Every call to update advances the analysis by a slice,
+ * and the bars are drawn at most once per period, when the levels change.
+ */
+class Spectrum : public ModeBase {
+ public:
+  static const byte kMaxColors = 4;
+
+  /**
+   * \param[in] num_leds number of LEDs.
+   * \param[in] sampler the source of the samples.
+   * \param[in] period the minimum period of the frames in ms.
+   */
+  Spectrum(const int& num_leds, SamplerBase& sampler,
+           const unsigned long& period)
+      : ModeBase(num_leds),
+        sampler_(sampler),
+        period_(period),
+        step_(0),
+        changed_(false),
+        num_colors_(1) {
+    for (byte i = 0; i < kMaxColors; ++i) colors_[i] = Color(0, 0, 0);
+  }
+
+  virtual ~Spectrum() {}
+
+  virtual void init() override {
+    analyzer_.reset();
+    step_ = Clock::millis() / period_;
+  }
+
+  virtual bool update(FrameBuffer& frame) override {
+    if (analyzer_.process(sampler_)) changed_ = true;
+    unsigned long step = Clock::millis() / period_;
+    if (not changed_ or step == step_) return false;
+    step_ = step;
+    changed_ = false;
+    render(frame);
+    return true;
+  }
+
+  virtual void render(FrameBuffer& frame) override {
+    static const Color off(0, 0, 0);
+    const byte bands = SpectrumAnalyzer::kBands;
+    int width = frame.getWidth();
+    int height = frame.getHeight();
+    if (height == 1) {
+      for (int idx = 0; idx < num_leds_; ++idx) {
+        // The band of the pixel, and the position of the pixel in its bar
+        long t = (long)idx * bands;
+        byte band = t / num_leds_;
+        byte position = (t - (long)band * num_leds_) * 256 / num_leds_;
+        frame.setPixel(idx, position < analyzer_.getLevel(band)
+                                ? getBarColor(position)
+                                : off);
+      }
+      return;
+    }
+    for (int x = 0; x < width; ++x) {
+      byte level = analyzer_.getLevel((long)x * bands / width);
+      for (int row = 0; row < height; ++row) {
+        byte position = (long)row * 256 / height;
+        frame.setPixel(x, height - 1 - row,
+                       position < level ? getBarColor(position) : off);
+      }
+    }
+  }
+
+  virtual const Color& getColor(int idx = 0) const override {
+    return colors_[(idx >= 0 and idx < num_colors_) ? idx : 0];
+  }
+
+  virtual void setColor(const Color& color, int idx = 0) override {
+    if (idx >= 0 and idx < kMaxColors) colors_[idx] = color;
+  }
+
+  virtual int getNumColors() const override { return num_colors_; }
+
+  virtual void setNumColors(int num_colors) override {
+    if (num_colors >= 1 and num_colors <= kMaxColors) num_colors_ = num_colors;
+  }
+
+  virtual unsigned long getPeriod() const override { return period_; }
+
+  virtual Mode getModeType() const override { return Mode::SPECTRUM; }
+
+  virtual const __FlashStringHelper* getMode() const override {
+    return toString(Mode::SPECTRUM);
+  }
+
+  const SpectrumAnalyzer& getAnalyzer() const { return analyzer_; }
+
+ private:
+  /**
+   * \brief Gets the color at a position along a bar.
+   */
+  Color getBarColor(byte position) const {
+    if (num_colors_ == 1) return colors_[0];
+    return gradientColor(colors_, num_colors_, position);
+  }
+
+  SamplerBase& sampler_;
+  SpectrumAnalyzer analyzer_;
+  unsigned long period_;  // The minimum period of the frames
+  unsigned long step_;    // The step of the latest frame
+  bool changed_;          // Whether the levels have changed since the frame
+  byte num_colors_;
+  Color colors_[kMaxColors];
+};
+
+}  // namespace mode
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_MODE_SPECTRUM_H
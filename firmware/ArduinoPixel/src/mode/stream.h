@@ -0,0 +1,103 @@
+/*! \file stream.h
+ *  \brief Defines the stream mode.
+ *  \details The frames are rendered elsewhere, e.g. on a host, and streamed to
+ *  the device over the network.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_MODE_STREAM_H
+#define ARDUINO_PIXEL_MODE_STREAM_H
+
+#include "mode/mode_base.h"
+
+namespace arduino_pixel {
+namespace mode {
+
+/**
+ * \brief Shows the frames that are streamed to the device.
+ * \details The server writes the pixels of the stream straight into the
+ * frame buffer, and pushes a frame when it's complete. The mode then only
+ * tells the strip when to show it.
+ */
+class FrameStream : public ModeBase {
+ public:
+  FrameStream(const int& num_leds)
+      : ModeBase(num_leds),
+        color_(0, 0, 0),
+        pending_(false),
+        received_(false) {}
+
+  virtual ~FrameStream() {}
+
+  virtual void init() override {
+    pending_ = false;
+    received_ = false;
+  }
+
+  virtual bool update(FrameBuffer& frame) override {
+    if (not pending_) return false;
+    pending_ = false;
+    return true;
+  }
+
+  virtual void render(FrameBuffer& frame) override {
+    // The strip is blank until the first frame arrives. Later, the frame
+    // buffer holds the last frame, which a full render, e.g. after a color
+    // request, leaves as it is
+    if (not received_) frame.fill(Color(0, 0, 0));
+    pending_ = false;
+  }
+
+  virtual const Color& getColor(int idx = 0) const override { return color_; }
+
+  virtual void setColor(const Color& color, int idx = 0) override {
+    color_ = color;
+  }
+
+  virtual Mode getModeType() const override { return Mode::STREAM; }
+
+  virtual const __FlashStringHelper* getMode() const override {
+    return toString(Mode::STREAM);
+  }
+
+  /**
+   * \brief Marks the frame in the frame buffer as complete.
+   */
+  void pushFrame() {
+    pending_ = true;
+    received_ = true;
+  }
+
+ private:
+  Color color_;  // Unused, but kept for the mode to carry a color over
+  boolean pending_;  // Flag that indicates whether a frame is ready
+  boolean received_;  // Flag that indicates whether a frame has arrived
+};
+
+}  // namespace mode
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_MODE_STREAM_H
@@ -0,0 +1,134 @@
+/*! \file twinkle.h
+ *  \brief Defines the twinkle mode.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_MODE_TWINKLE_H
+#define ARDUINO_PIXEL_MODE_TWINKLE_H
+
+#include "effects.h"
+#include "mode/mode_base.h"
+
+namespace arduino_pixel {
+namespace mode {
+
+/**
+ * \brief Twinkles random pixels in up to 4 colors.
+ * \details A pixel brightens fast and fades slowly, at its own speed, and
+ * rests for some of its cycles. The random numbers of every pixel are drawn
+ * again on every frame from the same seed, so the mode keeps no memory per
+ * pixel, and it follows the group time. A pixel costs 2 random numbers and
+ * 3 multiplies.
+ */
+class Twinkle : public ModeBase {
+ public:
+  static const byte kMaxColors = 4;
+  static const byte kDensity = 5;  // The cycles in 8 that a pixel twinkles
+
+  Twinkle(const int& num_leds, const unsigned long& period)
+      : ModeBase(num_leds), period_(period), step_(0), num_colors_(1) {
+    for (byte i = 0; i < kMaxColors; ++i) colors_[i] = Color(0, 0, 0);
+  }
+
+  virtual ~Twinkle() {}
+
+  virtual void init() override { step_ = Clock::groupMillis() / period_; }
+
+  virtual bool update(FrameBuffer& frame) override {
+    unsigned long step = Clock::groupMillis() / period_;
+    if (step == step_) return false;
+    step_ = step;
+    render(frame);
+    return true;
+  }
+
+  virtual void render(FrameBuffer& frame) override {
+    static const Color off(0, 0, 0);
+    unsigned long time = step_ * period_;
+    Random8 random(11337);  // The same numbers for every pixel on every frame
+    for (int idx = 0; idx < num_leds_; ++idx) {
+      uint16_t salt = random.next16();
+      uint16_t offset = random.next16();
+      byte speed = 8 + ((salt >> 8) & 15);  // In 1/16 of the time
+      // A cycle takes 4096 units of the clock of the pixel
+      unsigned long clock = ((time * speed) >> 4) + offset;
+      byte cycle = (clock >> 12) + salt;
+      if (((cycle & 0x0E) >> 1) >= kDensity) {
+        frame.setPixel(idx, off);
+        continue;
+      }
+      byte brightness = wave(clock >> 4);
+      brightness = scale8(brightness, brightness);  // Closer to perceived
+      byte pick = ((uint16_t)(byte)(cycle * 73) * num_colors_) >> 8;
+      frame.setPixel(idx, scaleColor(colors_[pick], brightness));
+    }
+  }
+
+  virtual const Color& getColor(int idx = 0) const override {
+    return colors_[(idx >= 0 and idx < num_colors_) ? idx : 0];
+  }
+
+  virtual void setColor(const Color& color, int idx = 0) override {
+    if (idx >= 0 and idx < kMaxColors) colors_[idx] = color;
+  }
+
+  virtual int getNumColors() const override { return num_colors_; }
+
+  virtual void setNumColors(int num_colors) override {
+    if (num_colors >= 1 and num_colors <= kMaxColors) num_colors_ = num_colors;
+  }
+
+  virtual unsigned long getPeriod() const override { return period_; }
+
+  virtual Mode getModeType() const override { return Mode::TWINKLE; }
+
+  virtual const __FlashStringHelper* getMode() const override {
+    return toString(Mode::TWINKLE);
+  }
+
+ private:
+  /**
+   * \brief Gets the brightness at a phase of a twinkle.
+   * \details The brightness rises in the first third of the cycle, and
+   * falls in the rest.
+   * \param[in] phase the phase.
+   * \return The brightness.
+   */
+  static byte wave(byte phase) {
+    if (phase < 86) return phase * 3;
+    return 255 - (((phase - 86) * 3) >> 1);
+  }
+
+  unsigned long period_;  // The period of the frames
+  unsigned long step_;    // The step of the latest frame
+  byte num_colors_;
+  Color colors_[kMaxColors];
+};
+
+}  // namespace mode
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_MODE_TWINKLE_H
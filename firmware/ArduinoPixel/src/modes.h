@@ -32,5 +32,15 @@
 #include "mode/scanner.h"
 #include "mode/rainbow.h"
 #include "mode/rainbow_cycle.h"
+#include "mode/gradient.h"
+#include "mode/gradient_scroll.h"
+#include "mode/stream.h"
+#include "mode/playback.h"
+#include "mode/script.h"
+#include "mode/canvas.h"
+#include "mode/noise.h"
+#include "mode/fire.h"
+#include "mode/twinkle.h"
+#include "mode/spectrum.h"
 
 #endif  // ARDUINO_PIXEL_MODES_H
@@ -0,0 +1,112 @@
+/*! \file pixel_format.h
+ *  \brief Defines the pixel formats on the wire.
+ *  \details A format describes the number of channels and their order. Every
+ *  format has its own encoder, so the conversion of a color to the bytes on
+ *  the wire compiles to a fixed sequence of stores.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_PIXEL_FORMAT_H
+#define ARDUINO_PIXEL_PIXEL_FORMAT_H
+
+#include "common_types.h"
+
+namespace arduino_pixel {
+
+enum class PixelFormat : byte { RGB, GRB, BGR, RGBW, GRBW };
+
+/**
+ * \brief Encodes colors to a format and decodes them back.
+ * \details The template parameters are the offsets of the channels within
+ * a pixel on the wire. The white channel gets the part that is common to
+ * red, green, and blue, which then emit only the remainder. The white LED
+ * draws that part at lower power and with a cleaner white.
+ * \tparam R offset of red.
+ * \tparam G offset of green.
+ * \tparam B offset of blue.
+ * \tparam W offset of white, or kNoWhite if the pixel has no white LED.
+ */
+template <byte R, byte G, byte B, byte W>
+struct PixelEncoder {
+  static const byte kNoWhite = 0xFF;
+  static const byte kChannels = (W == kNoWhite) ? 3 : 4;
+
+  static void encode(byte *pixel, byte red, byte green, byte blue) {
+    byte white = 0;
+    if (W != kNoWhite) {
+      white = (red < green) ? red : green;
+      white = (blue < white) ? blue : white;
+      pixel[W] = white;
+    }
+    pixel[R] = red - white;
+    pixel[G] = green - white;
+    pixel[B] = blue - white;
+  }
+
+  static void decode(const byte *pixel, byte &red, byte &green, byte &blue) {
+    byte white = (W != kNoWhite) ? pixel[W] : 0;
+    red = pixel[R] + white;
+    green = pixel[G] + white;
+    blue = pixel[B] + white;
+  }
+};
+
+/**
+ * \brief Maps a format to its encoder at compile time.
+ * \details The drivers take the format as a template parameter, so the
+ * channel offsets are constants in the code that writes every pixel.
+ */
+template <PixelFormat F>
+struct PixelFormatEncoder;
+
+template <>
+struct PixelFormatEncoder<PixelFormat::RGB> {
+  typedef PixelEncoder<0, 1, 2, 0xFF> type;
+};
+
+template <>
+struct PixelFormatEncoder<PixelFormat::GRB> {
+  typedef PixelEncoder<1, 0, 2, 0xFF> type;
+};
+
+template <>
+struct PixelFormatEncoder<PixelFormat::BGR> {
+  typedef PixelEncoder<2, 1, 0, 0xFF> type;
+};
+
+template <>
+struct PixelFormatEncoder<PixelFormat::RGBW> {
+  typedef PixelEncoder<0, 1, 2, 3> type;
+};
+
+template <>
+struct PixelFormatEncoder<PixelFormat::GRBW> {
+  typedef PixelEncoder<1, 0, 2, 3> type;
+};
+
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_PIXEL_FORMAT_H
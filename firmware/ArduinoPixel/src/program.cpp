@@ -0,0 +1,428 @@
+/*! \file program.cpp
+ *  \brief Implementation of the programs that are uploaded to the device.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "program.h"
+
+namespace arduino_pixel {
+
+namespace {
+
+/**
+ * \brief Gets the number of operand bytes, and the stack effect of an op.
+ * \return False if the op is invalid.
+ */
+bool getEffect(byte op, byte &operands, byte &pops, byte &pushes) {
+  operands = 0;
+  pushes = 1;
+  switch (static_cast<Op>(op)) {
+    case Op::PUSH8:
+      operands = 1;
+      pops = 0;
+      return true;
+    case Op::PUSH16:
+      operands = 2;
+      pops = 0;
+      return true;
+    case Op::PUSH32:
+      operands = 4;
+      pops = 0;
+      return true;
+    case Op::INDEX:
+    case Op::COUNT:
+    case Op::TIME:
+    case Op::STEP:
+    case Op::X:
+    case Op::Y:
+      pops = 0;
+      return true;
+    case Op::NEG:
+    case Op::NOT:
+    case Op::ABS:
+    case Op::SIN8:
+    case Op::TRI8:
+      pops = 1;
+      return true;
+    case Op::SEL:
+      pops = 3;
+      return true;
+    case Op::WHEEL:
+    case Op::COLOR:
+      pops = 1;
+      pushes = 3;
+      return true;
+    case Op::HSV:
+      pops = 3;
+      pushes = 3;
+      return true;
+    case Op::SCALE:
+      pops = 4;
+      pushes = 3;
+      return true;
+    case Op::BLEND:
+      pops = 7;
+      pushes = 3;
+      return true;
+    default:
+      pops = 2;
+      return op >= static_cast<byte>(Op::ADD) and
+             op <= static_cast<byte>(Op::NE);
+  }
+}
+
+int32_t tri8(int32_t x) {
+  x &= 255;
+  return x < 128 ? 2 * x : 511 - 2 * x;
+}
+
+int32_t clamp8(int32_t x) { return x < 0 ? 0 : x > 255 ? 255 : x; }
+
+int32_t negate(int32_t x) { return (int32_t)(0u - (uint32_t)x); }
+
+/**
+ * \brief Maps a weight in [0, 255] to [0, 256], so that 255 is the full
+ * weight.
+ */
+int32_t weight(int32_t k) {
+  k = clamp8(k);
+  return k + (k >> 7);
+}
+
+typedef int32_t Block[Program::kBlock];  // A value of every pixel
+
+void push(Block *stack, byte &depth, byte count, int32_t value) {
+  Block &a = stack[depth++];
+  for (int j = 0; j < count; ++j) a[j] = value;
+}
+
+template <typename F>
+void unary(Block &a, byte count, F f) {
+  for (int j = 0; j < count; ++j) a[j] = f(a[j]);
+}
+
+template <typename F>
+void binary(Block *stack, byte &depth, byte count, F f) {
+  Block &a = stack[depth - 2], &b = stack[depth - 1];
+  for (int j = 0; j < count; ++j) a[j] = f(a[j], b[j]);
+  --depth;
+}
+
+}  // namespace
+
+Program::Program() : size_(0), animated_(false) {}
+
+bool Program::parseHex(const char *hex, size_t length) {
+  clear();
+  long size = arduino_pixel::parseHex(hex, length, buffer_, kCapacity);
+  if (size < 0) return false;
+  size_ = size;
+  if (validate()) return true;
+  clear();
+  return false;
+}
+
+bool Program::setData_P(const byte *data, size_t size) {
+  clear();
+  if (size > kCapacity) return false;
+  memcpy_P(buffer_, data, size);
+  size_ = size;
+  if (validate()) return true;
+  clear();
+  return false;
+}
+
+void Program::clear() {
+  size_ = 0;
+  animated_ = false;
+}
+
+void Program::run(int32_t first, byte count, const Context &context,
+                  Color *colors) const {
+  if (size_ == 0) {
+    for (int j = 0; j < count; ++j) colors[j] = Color(0, 0, 0);
+    return;
+  }
+  Block stack[kMaxStack];
+  byte depth = 0;
+  const byte *end = buffer_ + size_;
+  for (const byte *pc = buffer_ + kHeaderSize; pc < end;) {
+    switch (static_cast<Op>(*pc++)) {
+      case Op::PUSH8:
+        push(stack, depth, count, (int8_t)pc[0]);
+        pc += 1;
+        break;
+      case Op::PUSH16:
+        push(stack, depth, count, (int16_t)(pc[0] | (pc[1] << 8)));
+        pc += 2;
+        break;
+      case Op::PUSH32:
+        push(stack, depth, count,
+             (int32_t)((uint32_t)pc[0] | ((uint32_t)pc[1] << 8) |
+                       ((uint32_t)pc[2] << 16) | ((uint32_t)pc[3] << 24)));
+        pc += 4;
+        break;
+      case Op::INDEX: {
+        Block &a = stack[depth++];
+        for (int j = 0; j < count; ++j) a[j] = first + j;
+        break;
+      }
+      case Op::X: {
+        Block &a = stack[depth++];
+        int32_t x = first % context.width;
+        for (int j = 0; j < count; ++j) {
+          a[j] = x;
+          if (++x == context.width) x = 0;
+        }
+        break;
+      }
+      case Op::Y: {
+        Block &a = stack[depth++];
+        int32_t x = first % context.width, y = first / context.width;
+        for (int j = 0; j < count; ++j) {
+          a[j] = y;
+          if (++x == context.width) {
+            x = 0;
+            ++y;
+          }
+        }
+        break;
+      }
+      case Op::COUNT:
+        push(stack, depth, count, context.count);
+        break;
+      case Op::TIME:
+        push(stack, depth, count, context.time);
+        break;
+      case Op::STEP:
+        push(stack, depth, count, context.step);
+        break;
+      case Op::ADD:
+        binary(stack, depth, count, [](int32_t a, int32_t b) {
+          return (int32_t)((uint32_t)a + (uint32_t)b);
+        });
+        break;
+      case Op::SUB:
+        binary(stack, depth, count, [](int32_t a, int32_t b) {
+          return (int32_t)((uint32_t)a - (uint32_t)b);
+        });
+        break;
+      case Op::MUL:
+        binary(stack, depth, count, [](int32_t a, int32_t b) {
+          return (int32_t)((uint32_t)a * (uint32_t)b);
+        });
+        break;
+      case Op::DIV:
+        binary(stack, depth, count, [](int32_t a, int32_t b) {
+          if (b == -1) return negate(a);  // INT32_MIN / -1 overflows
+          return b ? a / b : 0;
+        });
+        break;
+      case Op::MOD:
+        binary(stack, depth, count, [](int32_t a, int32_t b) {
+          return (b and b != -1) ? a % b : 0;
+        });
+        break;
+      case Op::MIN:
+        binary(stack, depth, count,
+               [](int32_t a, int32_t b) { return b < a ? b : a; });
+        break;
+      case Op::MAX:
+        binary(stack, depth, count,
+               [](int32_t a, int32_t b) { return b > a ? b : a; });
+        break;
+      case Op::AND:
+        binary(stack, depth, count,
+               [](int32_t a, int32_t b) { return a & b; });
+        break;
+      case Op::OR:
+        binary(stack, depth, count,
+               [](int32_t a, int32_t b) { return a | b; });
+        break;
+      case Op::XOR:
+        binary(stack, depth, count,
+               [](int32_t a, int32_t b) { return a ^ b; });
+        break;
+      case Op::SHL:
+        binary(stack, depth, count, [](int32_t a, int32_t b) {
+          return (int32_t)((uint32_t)a << (b & 31));
+        });
+        break;
+      case Op::SHR:
+        binary(stack, depth, count,
+               [](int32_t a, int32_t b) { return a >> (b & 31); });
+        break;
+      case Op::LT:
+        binary(stack, depth, count,
+               [](int32_t a, int32_t b) { return (int32_t)(a < b); });
+        break;
+      case Op::GT:
+        binary(stack, depth, count,
+               [](int32_t a, int32_t b) { return (int32_t)(a > b); });
+        break;
+      case Op::EQ:
+        binary(stack, depth, count,
+               [](int32_t a, int32_t b) { return (int32_t)(a == b); });
+        break;
+      case Op::NE:
+        binary(stack, depth, count,
+               [](int32_t a, int32_t b) { return (int32_t)(a != b); });
+        break;
+      case Op::NEG:
+        unary(stack[depth - 1], count, negate);
+        break;
+      case Op::NOT:
+        unary(stack[depth - 1], count,
+              [](int32_t a) { return (int32_t)(a == 0); });
+        break;
+      case Op::ABS:
+        unary(stack[depth - 1], count,
+              [](int32_t a) { return a < 0 ? negate(a) : a; });
+        break;
+      case Op::SIN8:
+        unary(stack[depth - 1], count, [](int32_t a) {
+          // A smoothstep of the triangle wave, in phase with a sine
+          int32_t t = tri8(a + 64);
+          return t * t * (765 - 2 * t) / 65025;
+        });
+        break;
+      case Op::TRI8:
+        unary(stack[depth - 1], count, tri8);
+        break;
+      case Op::SEL: {
+        Block &a = stack[depth - 3], &b = stack[depth - 2],
+              &c = stack[depth - 1];
+        for (int j = 0; j < count; ++j)
+          if (not c[j]) a[j] = b[j];
+        depth -= 2;
+        break;
+      }
+      case Op::WHEEL: {
+        Block &r = stack[depth - 1], &g = stack[depth], &b = stack[depth + 1];
+        for (int j = 0; j < count; ++j) {
+          byte pos = 255 - (r[j] & 255);
+          if (pos < 85) {
+            r[j] = 255 - pos * 3;
+            g[j] = 0;
+            b[j] = pos * 3;
+          } else if (pos < 170) {
+            pos -= 85;
+            r[j] = 0;
+            g[j] = pos * 3;
+            b[j] = 255 - pos * 3;
+          } else {
+            pos -= 170;
+            r[j] = pos * 3;
+            g[j] = 255 - pos * 3;
+            b[j] = 0;
+          }
+        }
+        depth += 2;
+        break;
+      }
+      case Op::HSV: {
+        Block &r = stack[depth - 3], &g = stack[depth - 2],
+              &b = stack[depth - 1];
+        for (int j = 0; j < count; ++j) {
+          int32_t h = r[j] & 255, s = clamp8(g[j]), v = clamp8(b[j]);
+          int32_t region = h / 43, remainder = (h - region * 43) * 6;
+          int32_t p = (v * (255 - s)) >> 8;
+          int32_t q = (v * (255 - ((s * remainder) >> 8))) >> 8;
+          int32_t t = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+          switch (region) {
+            case 0: r[j] = v; g[j] = t; b[j] = p; break;
+            case 1: r[j] = q; g[j] = v; b[j] = p; break;
+            case 2: r[j] = p; g[j] = v; b[j] = t; break;
+            case 3: r[j] = p; g[j] = q; b[j] = v; break;
+            case 4: r[j] = t; g[j] = p; b[j] = v; break;
+            default: r[j] = v; g[j] = p; b[j] = q; break;
+          }
+        }
+        break;
+      }
+      case Op::COLOR: {
+        Block &r = stack[depth - 1], &g = stack[depth], &b = stack[depth + 1];
+        for (int j = 0; j < count; ++j) {
+          const Color &color =
+              context.colors[(uint32_t)r[j] % context.num_colors];
+          r[j] = color.red;
+          g[j] = color.green;
+          b[j] = color.blue;
+        }
+        depth += 2;
+        break;
+      }
+      case Op::SCALE: {
+        Block &k = stack[--depth];
+        unary(k, count, weight);
+        for (byte i = 1; i <= 3; ++i) {
+          Block &c = stack[depth - i];
+          for (int j = 0; j < count; ++j) c[j] = (clamp8(c[j]) * k[j]) >> 8;
+        }
+        break;
+      }
+      case Op::BLEND: {
+        Block &k = stack[--depth];
+        unary(k, count, weight);
+        depth -= 3;
+        for (byte i = 1; i <= 3; ++i) {
+          Block &from = stack[depth - i], &to = stack[depth + 3 - i];
+          for (int j = 0; j < count; ++j) {
+            int32_t a = clamp8(from[j]);
+            from[j] = a + (((clamp8(to[j]) - a) * k[j]) >> 8);
+          }
+        }
+        break;
+      }
+    }
+  }
+  for (int j = 0; j < count; ++j)
+    colors[j] =
+        Color(clamp8(stack[0][j]), clamp8(stack[1][j]), clamp8(stack[2][j]));
+}
+
+bool Program::validate() {
+  if (size_ < kHeaderSize or buffer_[0] != 'A' or buffer_[1] != 'P' or
+      buffer_[2] != 'X' or buffer_[3] != 'S' or buffer_[4] != kVersion)
+    return false;
+  animated_ = false;
+  byte depth = 0;
+  for (size_t pc = kHeaderSize; pc < size_;) {
+    byte op = buffer_[pc++];
+    byte operands, pops, pushes;
+    if (not getEffect(op, operands, pops, pushes)) return false;
+    if (pops > depth) return false;
+    depth += pushes - pops;
+    if (depth > kMaxStack) return false;
+    pc += operands;
+    if (pc > size_) return false;
+    Op code = static_cast<Op>(op);
+    if (code == Op::TIME or code == Op::STEP) animated_ = true;
+  }
+  return depth == 3;
+}
+
+}  // namespace arduino_pixel
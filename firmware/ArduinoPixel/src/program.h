@@ -0,0 +1,199 @@
+/*! \file program.h
+ *  \brief Defines the programs that are uploaded to the device.
+ *  \details A program is the bytecode of an effect, which a small stack machine
+ *  evaluates for every pixel of every frame.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_PROGRAM_H
+#define ARDUINO_PIXEL_PROGRAM_H
+
+#include "common_types.h"
+
+// The size in bytes of the buffer for an uploaded program.
+#ifndef ARDUINO_PIXEL_PROGRAM_SIZE
+#if defined(__AVR__)
+#define ARDUINO_PIXEL_PROGRAM_SIZE 64
+#else
+#define ARDUINO_PIXEL_PROGRAM_SIZE 256
+#endif
+#endif
+
+// The number of pixels a program runs on at once. Every instruction is
+// applied to the whole block, so the cost of decoding it is shared, but the
+// stack takes 64 bytes per pixel.
+#ifndef ARDUINO_PIXEL_PROGRAM_BLOCK
+#if defined(__AVR__)
+#define ARDUINO_PIXEL_PROGRAM_BLOCK 4
+#else
+#define ARDUINO_PIXEL_PROGRAM_BLOCK 32
+#endif
+#endif
+
+namespace arduino_pixel {
+
+/**
+ * \brief The instructions of a program.
+ * \details The binary ops pop b, then a, and push a op b. The values are
+ * 32-bit integers, and the arithmetic wraps around. Division and modulo by 0
+ * give 0. The color ops push the red, green, and blue of a color, in [0, 255].
+ */
+enum class Op : byte {
+  PUSH8 = 0x01,   // Pushes the next byte, signed
+  PUSH16 = 0x02,  // Pushes the next 2 bytes, signed
+  PUSH32 = 0x03,  // Pushes the next 4 bytes
+  INDEX = 0x04,   // Pushes the index of the pixel
+  COUNT = 0x05,   // Pushes the number of LEDs
+  TIME = 0x06,    // Pushes the group time in ms
+  STEP = 0x07,    // Pushes the group time in periods of the mode
+  X = 0x08,       // Pushes the column of the pixel
+  Y = 0x09,       // Pushes the row of the pixel
+  ADD = 0x10,
+  SUB = 0x11,
+  MUL = 0x12,
+  DIV = 0x13,
+  MOD = 0x14,
+  MIN = 0x15,
+  MAX = 0x16,
+  AND = 0x17,
+  OR = 0x18,
+  XOR = 0x19,
+  SHL = 0x1A,
+  SHR = 0x1B,  // Arithmetic shift
+  LT = 0x1C,   // 1 if a < b, 0 otherwise
+  GT = 0x1D,
+  EQ = 0x1E,
+  NE = 0x1F,
+  NEG = 0x20,
+  NOT = 0x21,   // 1 if a == 0, 0 otherwise
+  ABS = 0x22,
+  SIN8 = 0x23,  // A sine wave in [0, 255] with a period of 256
+  TRI8 = 0x24,  // A triangle wave in [0, 255] with a period of 256
+  SEL = 0x28,   // Pops c, b, a, and pushes c ? a : b
+  WHEEL = 0x30,  // Pops a position, and pushes the color wheel r - g - b
+  HSV = 0x31,    // Pops v, s, h, in [0, 255], and pushes the color
+  COLOR = 0x32,  // Pops k, and pushes the color k of the mode
+  SCALE = 0x33,  // Pops k, in [0, 255], and a color, and pushes k * color
+  BLEND = 0x34   // Pops k, in [0, 255], and two colors, and pushes the mix
+};
+
+/**
+ * \brief Holds a program.
+ * \details A program holds, all values little endian:
+ *   0-3: "APXS"
+ *   4: version
+ *   5: flags, reserved
+ *   6-7: the period of the frames in ms, 0 for the default
+ *   8-...: the instructions
+ * \par
+ * The instructions compute the color of a pixel, and have to leave exactly
+ * its red, green, and blue on the stack, which are clamped to [0, 255].
+ * There are no jumps, so the depth of the stack is known at every
+ * instruction. The program is validated once, when it's set, and is then
+ * run without further checks. It runs on a block of pixels at once, with
+ * a stack per pixel.
+ */
+class Program {
+ public:
+  static const byte kHeaderSize = 8;
+  static const byte kVersion = 1;
+  static const byte kMaxStack = 16;
+  static const size_t kCapacity = ARDUINO_PIXEL_PROGRAM_SIZE;
+  static const byte kBlock = ARDUINO_PIXEL_PROGRAM_BLOCK;
+
+  /**
+   * \brief The inputs of a program, besides the index of the pixel.
+   */
+  struct Context {
+    int32_t count;  // The number of LEDs
+    int32_t width;  // The number of pixels in a row
+    int32_t time;   // The group time in ms
+    int32_t step;   // The group time in periods
+    const Color *colors;  // The colors of the mode
+    byte num_colors;
+  };
+
+  Program();
+
+  /**
+   * \brief Copies a program from its hex representation to the buffer.
+   * \param[in] hex the hex digits, two per byte.
+   * \param[in] length the number of digits.
+   * \return False if the program is invalid or doesn't fit in the buffer,
+   * in which case the previous program is lost.
+   */
+  bool parseHex(const char *hex, size_t length);
+  /**
+   * \brief Copies a program from flash to the buffer.
+   * \param[in] data the program in flash.
+   * \param[in] size the size of the program.
+   * \return False if the program is invalid or doesn't fit in the buffer.
+   */
+  bool setData_P(const byte *data, size_t size);
+  /**
+   * \brief Forgets the program.
+   */
+  void clear();
+
+  bool isEmpty() const { return size_ == 0; }
+
+  /**
+   * \brief Tells whether the program reads the time, i.e. whether its
+   * colors change from frame to frame.
+   */
+  bool isAnimated() const { return animated_; }
+
+  uint16_t getPeriod() const {
+    return size_ ? buffer_[6] | ((uint16_t)buffer_[7] << 8) : 0;
+  }
+
+  size_t getSize() const { return size_; }
+
+  /**
+   * \brief Computes the colors of a block of pixels.
+   * \param[in] first the index of the first pixel.
+   * \param[in] count the number of pixels, up to kBlock.
+   * \param[in] context the rest of the inputs.
+   * \param[out] colors the colors, black if there is no program.
+   */
+  void run(int32_t first, byte count, const Context &context,
+           Color *colors) const;
+
+ private:
+  /**
+   * \brief Checks the header, that the operands are within the data, and
+   * that the stack neither underflows nor overflows.
+   */
+  bool validate();
+
+  byte buffer_[kCapacity];
+  size_t size_;
+  bool animated_;
+};
+
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_PROGRAM_H
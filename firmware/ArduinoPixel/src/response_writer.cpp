@@ -0,0 +1,89 @@
+/*! \file response_writer.cpp
+ *  \brief Writes HTTP responses through a buffer
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "response_writer.h"
+
+namespace arduino_pixel {
+
+ResponseWriter::ResponseWriter(Client &client)
+    : client_(client), size_(0), failed_(false) {}
+
+void ResponseWriter::printStatus(int status_code,
+                                 const __FlashStringHelper *status_msg) {
+  print(F("HTTP/1.1 "));
+  print(status_code);
+  print(' ');
+  print(status_msg);
+  print(F("\r\n"));
+}
+
+void ResponseWriter::printHeader(const __FlashStringHelper *name,
+                                 const __FlashStringHelper *value) {
+  print(name);
+  print(F(": "));
+  print(value);
+  print(F("\r\n"));
+}
+
+void ResponseWriter::printHeader(const __FlashStringHelper *name,
+                                 unsigned long value) {
+  print(name);
+  print(F(": "));
+  print(value);
+  print(F("\r\n"));
+}
+
+void ResponseWriter::endHeaders() { print(F("\r\n")); }
+
+size_t ResponseWriter::write(uint8_t value) {
+  if (failed_) return 0;
+  buffer_[size_++] = value;
+  if (size_ == sizeof(buffer_) and not send()) return 0;
+  return 1;
+}
+
+size_t ResponseWriter::write(const uint8_t *buffer, size_t size) {
+  size_t written = 0;
+  while (written < size and not failed_) {
+    size_t count = sizeof(buffer_) - size_;
+    if (count > size - written) count = size - written;
+    memcpy(buffer_ + size_, buffer + written, count);
+    size_ += count;
+    if (size_ == sizeof(buffer_) and not send()) break;
+    written += count;
+  }
+  return written;
+}
+
+bool ResponseWriter::send() {
+  if (size_ and not failed_) failed_ = (client_.write(buffer_, size_) != size_);
+  size_ = 0;
+  return not failed_;
+}
+
+}  // namespace arduino_pixel
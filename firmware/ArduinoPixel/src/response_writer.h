@@ -0,0 +1,102 @@
+/*! \file response_writer.h
+ *  \brief Writes HTTP responses through a buffer
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_RESPONSE_WRITER_H
+#define ARDUINO_PIXEL_RESPONSE_WRITER_H
+
+#include <Client.h>
+
+#include "common_types.h"
+
+// The size in bytes of the buffer that a response is collected in, so that
+// the headers and a short body are sent to the client in a single write.
+#ifndef ARDUINO_PIXEL_RESPONSE_BUFFER
+#if defined(__AVR__)
+#define ARDUINO_PIXEL_RESPONSE_BUFFER 128
+#else
+#define ARDUINO_PIXEL_RESPONSE_BUFFER 512
+#endif
+#endif
+
+namespace arduino_pixel {
+
+/**
+ * \brief Collects a response, and writes it to a client in as few writes as
+ * possible.
+ * \details Everything that is printed on the writer, the status line, the
+ * headers and the body, goes to a buffer of ARDUINO_PIXEL_RESPONSE_BUFFER
+ * bytes, which is written to the client when it fills up, and by send. A
+ * response that fits in the buffer goes out in a single write, and so in a
+ * single packet, instead of one for every print on the client. Once the
+ * client fails to take a write, the writer drops the rest of the response,
+ * and its writes return 0.
+ */
+class ResponseWriter : public Print {
+ public:
+  explicit ResponseWriter(Client &client);
+
+  /**
+   * \brief Prints the status line, e.g. "HTTP/1.1 200 OK".
+   * \param[in] status_code the status code.
+   * \param[in] status_msg the reason phrase, in flash.
+   */
+  void printStatus(int status_code, const __FlashStringHelper *status_msg);
+  /**
+   * \brief Prints a header.
+   * \param[in] name the name of the header, in flash.
+   * \param[in] value the value of the header, in flash.
+   */
+  void printHeader(const __FlashStringHelper *name,
+                   const __FlashStringHelper *value);
+  void printHeader(const __FlashStringHelper *name, unsigned long value);
+  /**
+   * \brief Prints the empty line that ends the headers.
+   */
+  void endHeaders();
+
+  virtual size_t write(uint8_t value) override;
+  virtual size_t write(const uint8_t *buffer, size_t size) override;
+  using Print::write;
+
+  /**
+   * \brief Writes the buffered bytes to the client.
+   * \return False if the client didn't take everything that was printed.
+   */
+  bool send();
+  bool failed() const { return failed_; }
+
+ private:
+  Client &client_;
+  byte buffer_[ARDUINO_PIXEL_RESPONSE_BUFFER];
+  size_t size_;
+  bool failed_;
+};
+
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_RESPONSE_WRITER_H
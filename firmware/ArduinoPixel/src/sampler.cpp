@@ -0,0 +1,94 @@
+/*! \file sampler.cpp
+ *  \brief Implements the sources of audio samples.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "sampler.h"
+
+namespace arduino_pixel {
+
+bool SamplerWav::begin() {
+  byte tag[4];
+  if (input_.readBytes(tag, 4) != 4 or memcmp(tag, "RIFF", 4) != 0)
+    return false;
+  readValue(4);  // The size of the file
+  if (input_.readBytes(tag, 4) != 4 or memcmp(tag, "WAVE", 4) != 0)
+    return false;
+  bool format = false;
+  while (input_.readBytes(tag, 4) == 4) {
+    uint32_t size = readValue(4);
+    if (memcmp(tag, "fmt ", 4) == 0 and size >= 16) {
+      uint16_t type = readValue(2);
+      channels_ = readValue(2);
+      unsigned long rate = readValue(4);
+      readValue(4);  // Bytes per second
+      readValue(2);  // Bytes per frame
+      uint16_t bits = readValue(2);
+      if (type != 1 or channels_ == 0 or rate == 0 or
+          (bits != 8 and bits != 16))
+        return false;
+      bytes_ = bits / 8;
+      rate_ = rate;
+      interval_ = 1000000ul / rate;
+      format = true;
+      size -= 16;
+    } else if (memcmp(tag, "data", 4) == 0) {
+      if (not format) return false;
+      remaining_ = size;
+      started_ = false;
+      return true;
+    }
+    while (size--) {  // Skip the rest of the chunk
+      if (input_.read() < 0) return false;
+    }
+  }
+  return false;
+}
+
+int16_t SamplerWav::sample() {
+  if (remaining_ < (uint32_t)channels_ * bytes_) return 0;
+  remaining_ -= channels_ * bytes_;
+  long sum = 0;
+  for (byte channel = 0; channel < channels_; ++channel) {
+    if (bytes_ == 1)
+      sum += ((int)readValue(1) - 128) << 8;  // 8-bit samples are unsigned
+    else
+      sum += (int16_t)readValue(2);
+  }
+  return sum / channels_;
+}
+
+uint32_t SamplerWav::readValue(byte size) {
+  uint32_t value = 0;
+  for (byte i = 0; i < size; ++i) {
+    int c = input_.read();
+    if (c < 0) return 0;
+    value |= (uint32_t)c << (8 * i);
+  }
+  return value;
+}
+
+}  // namespace arduino_pixel
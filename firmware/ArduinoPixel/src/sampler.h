@@ -0,0 +1,194 @@
+/*! \file sampler.h
+ *  \brief Defines the sources of audio samples.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_SAMPLER_H
+#define ARDUINO_PIXEL_SAMPLER_H
+
+#include "clock.h"
+#include "common_types.h"
+
+// The maximum number of samples that a sampler takes in a call, so that a
+// sampler that has fallen behind doesn't hold the main loop back.
+#ifndef ARDUINO_PIXEL_SAMPLER_BURST
+#if defined(__AVR__)
+#define ARDUINO_PIXEL_SAMPLER_BURST 8
+#else
+#define ARDUINO_PIXEL_SAMPLER_BURST 64
+#endif
+#endif
+
+namespace arduino_pixel {
+
+/**
+ * \brief Interface of the sources of audio samples.
+ * \details A sampler is polled from the main loop, and returns the samples
+ * that have become due since the last call, without waiting for more. A
+ * device implements it on its ADC or I2S peripheral, and a host on a file.
+ */
+class SamplerBase {
+ public:
+  virtual ~SamplerBase() {}
+  /**
+   * \brief Reads the samples that are ready.
+   * \param[out] samples the samples, signed and centered at 0.
+   * \param[in] count the maximum number of samples.
+   * \return The number of samples.
+   */
+  virtual int read(int16_t *samples, int count) = 0;
+  /**
+   * \brief Gets the sample rate.
+   * \return The rate in Hz.
+   */
+  virtual unsigned long getRate() const = 0;
+};
+
+/**
+ * \brief Base of the samplers that take a sample at a time when it's due.
+ * \details The samples are due at the sample rate on the time of the Clock,
+ * so a sampler on the virtual time produces the same samples on every run.
+ * A sampler that falls more than a burst behind skips the missed samples.
+ */
+class PacedSampler : public SamplerBase {
+ public:
+  virtual int read(int16_t *samples, int count) override {
+    unsigned long now = Clock::micros();
+    if (not started_) {
+      next_time_ = now;
+      started_ = true;
+    }
+    if ((long)(now - next_time_) >
+        (long)(ARDUINO_PIXEL_SAMPLER_BURST * interval_))
+      next_time_ = now - ARDUINO_PIXEL_SAMPLER_BURST * interval_;
+    int n = 0;
+    while (n < count and n < ARDUINO_PIXEL_SAMPLER_BURST and
+           (long)(now - next_time_) >= 0) {
+      samples[n++] = sample();
+      next_time_ += interval_;
+    }
+    return n;
+  }
+
+  virtual unsigned long getRate() const override { return rate_; }
+
+ protected:
+  /**
+   * \param[in] rate the sample rate in Hz.
+   */
+  PacedSampler(unsigned long rate)
+      : rate_(rate), interval_(1000000ul / rate), started_(false) {}
+  /**
+   * \brief Takes a sample.
+   * \return The sample.
+   */
+  virtual int16_t sample() = 0;
+
+  unsigned long rate_;
+  unsigned long interval_;   // Time in us between two samples
+  unsigned long next_time_;  // Time in us of the next sample
+  bool started_;
+};
+
+/**
+ * \brief Samples an analog input, e.g. a microphone with an amplifier.
+ * \details The DC offset of the input is tracked and removed, so a signal
+ * that is biased to the middle of the range is centered at 0. A sample is an
+ * analogRead, which takes about 110 us on AVR, so a burst of samples takes
+ * at most ARDUINO_PIXEL_SAMPLER_BURST of them.
+ */
+class SamplerAnalog : public PacedSampler {
+ public:
+  /**
+   * \param[in] pin the analog pin.
+   * \param[in] rate the sample rate in Hz, e.g. 8000.
+   * \param[in] bits the resolution of the ADC, e.g. 10 on AVR and 12 on
+   * ESP32.
+   */
+  SamplerAnalog(int pin, unsigned long rate, byte bits = 10)
+      : PacedSampler(rate), pin_(pin), shift_(16 - bits), offset_(1L << 23) {}
+
+  virtual ~SamplerAnalog() {}
+
+ protected:
+  virtual int16_t sample() override {
+    long value = (long)analogRead(pin_) << shift_;  // In [0, 65535]
+    offset_ += ((value << 8) - offset_) >> 8;  // A slow average of the input
+    long centered = value - (offset_ >> 8);
+    return centered > 32767 ? 32767 : centered < -32768 ? -32768 : centered;
+  }
+
+  int pin_;
+  byte shift_;
+  long offset_;  // The DC offset in 1/256
+};
+
+/**
+ * \brief Samples a WAV file, e.g. on a host.
+ * \details The file is read from a stream as its samples become due, so it
+ * plays at its own rate. The samples are PCM, 8 or 16 bits, and the channels
+ * are mixed to one. The sampler returns silence after the end of the file.
+ */
+class SamplerWav : public PacedSampler {
+ public:
+  /**
+   * \param[in] input the stream of the file.
+   */
+  SamplerWav(Stream &input)
+      : PacedSampler(8000),
+        input_(input),
+        channels_(1),
+        bytes_(2),
+        remaining_(0) {}
+
+  virtual ~SamplerWav() {}
+
+  /**
+   * \brief Reads the header of the file.
+   * \details The sample rate of the sampler becomes the one of the file.
+   * \return False if the file isn't a PCM WAV file, true otherwise.
+   */
+  bool begin();
+
+ protected:
+  virtual int16_t sample() override;
+
+  /**
+   * \brief Reads a little endian value.
+   * \param[in] size the number of bytes, up to 4.
+   * \return The value, or 0 if the stream has ended.
+   */
+  uint32_t readValue(byte size);
+
+  Stream &input_;
+  byte channels_;
+  byte bytes_;  // Bytes per sample of a channel
+  uint32_t remaining_;  // Bytes of the data that haven't been read
+};
+
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_SAMPLER_H
@@ -0,0 +1,77 @@
+/*! \file scratch_arena.h
+ *  \brief Defines the scratch memory that is shared among the modes.
+ *  \details Modes that need working memory besides the frame buffer (e.g. a
+ *  heat map) take it from a single statically allocated block. Only the active
+ *  mode may hold scratch memory, so the block is recycled on every mode change.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_SCRATCH_ARENA_H
+#define ARDUINO_PIXEL_SCRATCH_ARENA_H
+
+#include "common_types.h"
+
+// The size of the arena in bytes. Define it before including the library
+// to trade scratch memory for LEDs.
+#ifndef ARDUINO_PIXEL_SCRATCH_SIZE
+#if defined(__AVR__)
+#define ARDUINO_PIXEL_SCRATCH_SIZE 64
+#else
+#define ARDUINO_PIXEL_SCRATCH_SIZE 2048
+#endif
+#endif
+
+namespace arduino_pixel {
+
+class ScratchArena {
+ public:
+  static const size_t kCapacity = ARDUINO_PIXEL_SCRATCH_SIZE;
+
+  /**
+   * \brief Reserves a block of scratch memory.
+   * \param[in] size the number of bytes.
+   * \return A pointer to the block, or nullptr if the arena is exhausted.
+   */
+  static void *allocate(size_t size);
+  /**
+   * \brief Releases all the blocks.
+   * \note Call this once the mode that holds the blocks has been destroyed.
+   */
+  static void reset() { used_ = 0; }
+  /**
+   * \brief Gets the number of reserved bytes.
+   * \return The number of bytes.
+   */
+  static size_t getUsed() { return used_; }
+
+ private:
+  static byte buffer_[kCapacity];
+  static size_t used_;
+};
+
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_SCRATCH_ARENA_H
@@ -40,14 +40,14 @@ namespace arduino_pixel {
 
 enum class HttpMethod : byte { INVALID, GET, PUT };
 
-inline String toString(HttpMethod method) {
+inline const __FlashStringHelper *toString(HttpMethod method) {
   switch (method) {
     case HttpMethod::GET:
-      return String("GET");
+      return F("GET");
     case HttpMethod::PUT:
-      return String("PUT");
+      return F("PUT");
     default:
-      return String("INVALID");
+      return F("INVALID");
   }
 }
 
@@ -61,54 +61,179 @@ enum class Uri : byte {
   MODE_GET,    // "/strip/mode"
   MODE_PUT,    // "/strip/mode"
   COLOR_GET,   // "/strip/color"
-  COLOR_PUT    // "/strip/color"
+  COLOR_PUT,   // "/strip/color"
+  STATS,       // "/strip/stats"
+  CLOCK,          // "/strip/clock"
+  EVENTS,         // "/strip/events"
+  ANIMATION_GET,  // "/strip/animation"
+  ANIMATION_PUT,  // "/strip/animation"
+  SCRIPT_GET,     // "/strip/script"
+  SCRIPT_PUT,     // "/strip/script"
+  LAYOUT_GET,     // "/strip/layout"
+  LAYOUT_PUT,     // "/strip/layout"
+  PIXELS,         // "/strip/pixels"
+  FRAME           // "/strip/frame"
 };
 
-inline String toString(Uri uri) {
+inline const __FlashStringHelper *toString(Uri uri) {
   switch (uri) {
     case Uri::ROOT:
-      return String("ROOT");
+      return F("ROOT");
     case Uri::STATUS:
-      return String("STATUS");
+      return F("STATUS");
     case Uri::STATUS_ON:
-      return String("STATUS_ON");
+      return F("STATUS_ON");
     case Uri::STATUS_OFF:
-      return String("STATUS_OFF");
+      return F("STATUS_OFF");
     case Uri::MODES:
-      return String("MODES");
+      return F("MODES");
     case Uri::MODE_GET:
-      return String("MODE_GET");
+      return F("MODE_GET");
     case Uri::MODE_PUT:
-      return String("MODE_PUT");
+      return F("MODE_PUT");
     case Uri::COLOR_GET:
-      return String("COLOR_GET");
+      return F("COLOR_GET");
     case Uri::COLOR_PUT:
-      return String("COLOR_PUT");
+      return F("COLOR_PUT");
+    case Uri::STATS:
+      return F("STATS");
+    case Uri::CLOCK:
+      return F("CLOCK");
+    case Uri::EVENTS:
+      return F("EVENTS");
+    case Uri::ANIMATION_GET:
+      return F("ANIMATION_GET");
+    case Uri::ANIMATION_PUT:
+      return F("ANIMATION_PUT");
+    case Uri::SCRIPT_GET:
+      return F("SCRIPT_GET");
+    case Uri::SCRIPT_PUT:
+      return F("SCRIPT_PUT");
+    case Uri::LAYOUT_GET:
+      return F("LAYOUT_GET");
+    case Uri::LAYOUT_PUT:
+      return F("LAYOUT_PUT");
+    case Uri::PIXELS:
+      return F("PIXELS");
+    case Uri::FRAME:
+      return F("FRAME");
     default:
-      return String("INVALID");
+      return F("INVALID");
   }
 }
 
 struct RequestData {
   HttpMethod http_method;
   Uri uri;
+  String query;  // The parameters after the '?' of the uri
   String data;
+  bool keep_alive;  // The client asked to keep the connection open
 };
 
 struct ResponseData {
   ResponseData() {}
-  ResponseData(int status_code, String status_msg, boolean keep_alive,
-               String data)
+  ResponseData(int status_code, const __FlashStringHelper *status_msg,
+               const __FlashStringHelper *data_P = nullptr)
+      : status_code(status_code), status_msg(status_msg), data_P(data_P) {}
+  ResponseData(int status_code, const __FlashStringHelper *status_msg,
+               const String &data)
       : status_code(status_code),
         status_msg(status_msg),
-        keep_alive(keep_alive),
+        data_P(nullptr),
         data(data) {}
   int status_code;
-  String status_msg;
-  boolean keep_alive;
-  String data;
+  const __FlashStringHelper *status_msg;  // Resides in flash
+  const __FlashStringHelper *data_P;  // Constant data that reside in flash
+  String data;                        // Data that are built on request
+};
+
+/**
+ * \brief Defines the packets of the frame stream.
+ * \details A frame is sent in one or more UDP packets, each with a range of
+ * pixels. All values are little endian.
+ *   0-1: "AP"
+ *   2: version
+ *   3: flags (bit 0: the last packet of the frame)
+ *   4-5: the sequence number of the frame
+ *   6-7: the index of the first pixel
+ *   8-9: the number of pixels
+ *   10-...: r, g, b of every pixel
+ */
+struct StreamPacket {
+  static const byte kVersion = 1;
+  static const byte kHeaderSize = 10;
+  static const byte kLastPacket = 0x01;
 };
 
+/**
+ * \brief Holds statistics about the rendered frames.
+ * \details Times are in us. The current is 0 if the strip has no power
+ * limit.
+ */
+struct FrameStats {
+  FrameStats()
+      : updates(0),
+        coalesced(0),
+        frames(0),
+        latency(0),
+        max_latency(0),
+        render_time(0),
+        jitter(0),
+        max_jitter(0),
+        current(0),
+        max_current(0),
+        limit(255) {}
+  unsigned long updates;    // Requests that changed the state
+  unsigned long coalesced;  // Updates that were replaced by a later one
+  unsigned long frames;     // Frames sent to the LED strip
+  unsigned long latency;    // From the latest update to its frame
+  unsigned long max_latency;
+  unsigned long render_time;  // Time to draw and send the latest frame
+  unsigned long jitter;  // Difference between the last two frame intervals
+  unsigned long max_jitter;
+  unsigned long current;  // Estimated current of the latest frame in mA
+  unsigned long max_current;
+  byte limit;  // The scale of the power limit, 255 if the frame isn't limited
+};
+
+/**
+ * \brief Compares the beginning of a string with a string in flash.
+ * \param[in] str a string.
+ * \param[in] prefix a string in flash.
+ * \return The length of the prefix, if the string starts with it, or 0.
+ */
+inline size_t startsWith(const char *str, const __FlashStringHelper *prefix) {
+  PGM_P prefix_P = reinterpret_cast<PGM_P>(prefix);
+  size_t length = strlen_P(prefix_P);
+  return (strncmp_P(str, prefix_P, length) == 0) ? length : 0;
+}
+
+/**
+ * \brief Compares the beginning of a string with a string in flash, ignoring
+ * the case, e.g. of the name of a header.
+ * \param[in] str a string.
+ * \param[in] prefix a string in flash.
+ * \return The length of the prefix, if the string starts with it, or 0.
+ */
+inline size_t startsWithIgnoreCase(const char *str,
+                                   const __FlashStringHelper *prefix) {
+  PGM_P prefix_P = reinterpret_cast<PGM_P>(prefix);
+  size_t length = strlen_P(prefix_P);
+  return (strncasecmp_P(str, prefix_P, length) == 0) ? length : 0;
+}
+
+/**
+ * \brief Finds a string in flash inside a string.
+ * \param[in] str a string.
+ * \param[in] needle a string in flash.
+ * \return The index of the first occurrence of the needle, or -1.
+ */
+inline int indexOf(const String &str, const __FlashStringHelper *needle) {
+  const char *found =
+      strstr_P(str.c_str(), reinterpret_cast<PGM_P>(needle));
+  return found ? (int)(found - str.c_str()) : -1;
+}
+
 }  // namespace arduino_pixel
 
 #endif  // ARDUINO_PIXEL_SERVER_TYPES_H
@@ -0,0 +1,200 @@
+/*! \file spectrum_analyzer.cpp
+ *  \brief Implements an incremental fixed-point spectrum analyzer.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "spectrum_analyzer.h"
+
+namespace arduino_pixel {
+
+namespace {
+
+static_assert(SpectrumAnalyzer::kSize >= 16 and SpectrumAnalyzer::kSize <= 256
+                  and (SpectrumAnalyzer::kSize &
+                       (SpectrumAnalyzer::kSize - 1)) == 0,
+              "ARDUINO_PIXEL_FFT_SIZE must be a power of 2 from 16 to 256");
+
+// A quarter of a sine of 512 points in Q15
+const int16_t kSine[129] PROGMEM = {
+        0,   402,   804,  1206,  1608,  2009,  2410,  2811,  3212,  3612,
+     4011,  4410,  4808,  5205,  5602,  5998,  6393,  6786,  7179,  7571,
+     7962,  8351,  8739,  9126,  9512,  9896, 10278, 10659, 11039, 11417,
+    11793, 12167, 12539, 12910, 13279, 13645, 14010, 14372, 14732, 15090,
+    15446, 15800, 16151, 16499, 16846, 17189, 17530, 17869, 18204, 18537,
+    18868, 19195, 19519, 19841, 20159, 20475, 20787, 21096, 21403, 21705,
+    22005, 22301, 22594, 22884, 23170, 23452, 23731, 24007, 24279, 24547,
+    24811, 25072, 25329, 25582, 25832, 26077, 26319, 26556, 26790, 27019,
+    27245, 27466, 27683, 27896, 28105, 28310, 28510, 28706, 28898, 29085,
+    29268, 29447, 29621, 29791, 29956, 30117, 30273, 30424, 30571, 30714,
+    30852, 30985, 31113, 31237, 31356, 31470, 31580, 31685, 31785, 31880,
+    31971, 32057, 32137, 32213, 32285, 32351, 32412, 32469, 32521, 32567,
+    32609, 32646, 32678, 32705, 32728, 32745, 32757, 32765, 32767};
+
+const byte kLogSize = (SpectrumAnalyzer::kSize == 16)    ? 4
+                      : (SpectrumAnalyzer::kSize == 32)  ? 5
+                      : (SpectrumAnalyzer::kSize == 64)  ? 6
+                      : (SpectrumAnalyzer::kSize == 128) ? 7
+                                                         : 8;
+const uint16_t kFloor = 4 * 16;  // The quietest peak on the log scale
+const byte kRange = 64;  // The range of the levels, 4 octaves in 1/16
+
+/**
+ * \brief Gets the sine of an angle.
+ * \param[in] angle the angle in 1/512 of a circle.
+ * \return The sine in Q15.
+ */
+int16_t sine(int angle) {
+  angle &= 511;
+  int idx = angle & 127;
+  if (angle & 128) idx = 128 - idx;
+  int16_t value = pgm_read_word(kSine + idx);
+  return (angle & 256) ? -value : value;
+}
+
+int16_t cosine(int angle) { return sine(angle + 128); }
+
+/**
+ * \brief Gets the log2 of a value in 1/16 octave.
+ */
+uint16_t log2x16(uint32_t value) {
+  if (value == 0) return 0;
+  byte exponent = 0;
+  while (value >> (exponent + 1)) ++exponent;
+  // The 4 bits below the leading one are the fraction
+  byte fraction = (exponent >= 4) ? (value >> (exponent - 4)) & 15
+                                  : (value << (4 - exponent)) & 15;
+  return exponent * 16 + fraction;
+}
+
+}  // namespace
+
+SpectrumAnalyzer::SpectrumAnalyzer() {
+  // The bands are spaced quadratically over the bins but the first, DC
+  const int bins = kSize / 2;
+  edges_[0] = 1;
+  for (int band = 1; band <= kBands; ++band) {
+    int edge = 1 + (long)(bins - 1) * band * band / (kBands * kBands);
+    edges_[band] = max(edge, edges_[band - 1] + 1);
+  }
+  edges_[kBands] = bins;
+  reset();
+}
+
+void SpectrumAnalyzer::reset() {
+  filled_ = 0;
+  state_ = State::COLLECT;
+  peak_ = kFloor;
+  transforms_ = 0;
+  for (byte band = 0; band < kBands; ++band) levels_[band] = 0;
+}
+
+bool SpectrumAnalyzer::process(SamplerBase &sampler) {
+  if (state_ == State::COLLECT) {
+    filled_ += sampler.read(real_ + filled_, kSize - filled_);
+    if (filled_ < kSize) return false;
+    prepare();
+    state_ = State::TRANSFORM;
+    stage_ = 0;
+    next_ = 0;
+    return false;  // The windowing has taken the time of this call
+  }
+  for (int count = 0; count < kBudget; ++count) {
+    butterfly(next_);
+    if (++next_ < kSize / 2) continue;
+    next_ = 0;
+    if (++stage_ < kLogSize) continue;
+    updateLevels();
+    ++transforms_;
+    filled_ = 0;
+    state_ = State::COLLECT;
+    return true;
+  }
+  return false;
+}
+
+void SpectrumAnalyzer::prepare() {
+  // A Hann window, sin^2(pi * n / N), in Q15
+  for (int n = 0; n < kSize; ++n) {
+    int32_t s = sine(n * (256 / kSize));
+    int32_t window = (s * s) >> 15;
+    real_[n] = (real_[n] * window) >> 15;
+    imag_[n] = 0;
+  }
+  for (int i = 0, j = 0; i < kSize; ++i) {
+    if (i < j) {
+      int16_t t = real_[i];
+      real_[i] = real_[j];
+      real_[j] = t;
+    }
+    int bit = kSize >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j |= bit;
+  }
+}
+
+void SpectrumAnalyzer::butterfly(int idx) {
+  int half = 1 << stage_;
+  int k = idx & (half - 1);
+  int i = ((idx >> stage_) << (stage_ + 1)) + k;
+  int j = i + half;
+  // The twiddle factor exp(-2 pi i k / (2 half))
+  int angle = k * (256 >> stage_);
+  int32_t c = cosine(angle), s = sine(angle);
+  int32_t tr = (real_[j] * c + imag_[j] * s) >> 15;
+  int32_t ti = (imag_[j] * c - real_[j] * s) >> 15;
+  int32_t ur = real_[i], ui = imag_[i];
+  real_[j] = (ur - tr) >> 1;
+  imag_[j] = (ui - ti) >> 1;
+  real_[i] = (ur + tr) >> 1;
+  imag_[i] = (ui + ti) >> 1;
+}
+
+void SpectrumAnalyzer::updateLevels() {
+  uint16_t logs[kBands];
+  uint16_t loudest = 0;
+  for (byte band = 0; band < kBands; ++band) {
+    uint32_t sum = 0;
+    for (int bin = edges_[band]; bin < edges_[band + 1]; ++bin) {
+      uint16_t a = abs(real_[bin]), b = abs(imag_[bin]);
+      // The magnitude, max + 3/8 min, within 7% of sqrt(a^2 + b^2)
+      sum += (a > b) ? a + ((3 * b) >> 3) : b + ((3 * a) >> 3);
+    }
+    logs[band] = log2x16(sum);
+    loudest = max(loudest, logs[band]);
+  }
+  // The peak jumps to a louder band, and falls by an octave in 16 transforms
+  peak_ = max(kFloor, max(loudest, (uint16_t)(peak_ - 1)));
+  for (byte band = 0; band < kBands; ++band) {
+    uint16_t below = peak_ - min(logs[band], peak_);
+    byte level = (below >= kRange) ? 0 : 255 - below * (256 / kRange);
+    if (level >= levels_[band])
+      levels_[band] = level;
+    else
+      levels_[band] -= (levels_[band] - level + 3) >> 2;
+  }
+}
+
+}  // namespace arduino_pixel
@@ -0,0 +1,139 @@
+/*! \file spectrum_analyzer.h
+ *  \brief Defines an incremental fixed-point spectrum analyzer.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_SPECTRUM_ANALYZER_H
+#define ARDUINO_PIXEL_SPECTRUM_ANALYZER_H
+
+#include "common_types.h"
+#include "sampler.h"
+
+// The number of samples of a transform, a power of 2 from 16 to 256.
+#ifndef ARDUINO_PIXEL_FFT_SIZE
+#if defined(__AVR__)
+#define ARDUINO_PIXEL_FFT_SIZE 64
+#else
+#define ARDUINO_PIXEL_FFT_SIZE 256
+#endif
+#endif
+
+// The number of frequency bands.
+#ifndef ARDUINO_PIXEL_FFT_BANDS
+#if defined(__AVR__)
+#define ARDUINO_PIXEL_FFT_BANDS 8
+#else
+#define ARDUINO_PIXEL_FFT_BANDS 16
+#endif
+#endif
+
+// The number of butterflies of the transform in a call to process.
+#ifndef ARDUINO_PIXEL_FFT_BUDGET
+#if defined(__AVR__)
+#define ARDUINO_PIXEL_FFT_BUDGET 16
+#else
+#define ARDUINO_PIXEL_FFT_BUDGET 128
+#endif
+#endif
+
+namespace arduino_pixel {
+
+/**
+ * \brief Turns audio samples to the levels of frequency bands.
+ * \details The samples of a window are collected, multiplied by a Hann
+ * window, and transformed by a radix-2 FFT on Q15 integers, which halves the
+ * values on every stage so they never overflow. The magnitudes of the bins
+ * are summed in bands that are spaced quadratically, finer at the low end,
+ * and the sums are turned into levels on a log scale, relative to a peak that
+ * follows the loudness, so the levels don't depend on the gain of the input.
+ * The levels rise at once and fall smoothly.
+ * The work is split over the calls to process, which take the samples that
+ * are ready and run at most ARDUINO_PIXEL_FFT_BUDGET butterflies, so the
+ * analyzer never holds the main loop back. A transform takes
+ * ARDUINO_PIXEL_FFT_SIZE / 2 * log2(ARDUINO_PIXEL_FFT_SIZE) butterflies, each
+ * 4 multiplies of 16 bits.
+ */
+class SpectrumAnalyzer {
+ public:
+  static const int kSize = ARDUINO_PIXEL_FFT_SIZE;
+  static const byte kBands = ARDUINO_PIXEL_FFT_BANDS;
+  static const int kBudget = ARDUINO_PIXEL_FFT_BUDGET;
+
+  SpectrumAnalyzer();
+  /**
+   * \brief Drops the samples of the current window, and the levels.
+   */
+  void reset();
+  /**
+   * \brief Advances the analysis.
+   * \param[in] sampler the source of the samples.
+   * \return True if the levels have changed, false otherwise.
+   */
+  bool process(SamplerBase &sampler);
+  /**
+   * \brief Gets the level of a band.
+   * \param[in] band the index of the band, from the lowest frequency.
+   * \return The level in [0, 255].
+   */
+  byte getLevel(byte band) const { return levels_[band]; }
+  /**
+   * \brief Gets the number of transforms since the reset.
+   * \return The number of transforms.
+   */
+  unsigned long getNumTransforms() const { return transforms_; }
+
+ private:
+  enum class State : byte { COLLECT, TRANSFORM };
+
+  /**
+   * \brief Windows the samples and puts them in bit-reversed order.
+   */
+  void prepare();
+  /**
+   * \brief Computes a butterfly of the current stage.
+   * \param[in] idx the index of the butterfly in the stage.
+   */
+  void butterfly(int idx);
+  /**
+   * \brief Sums the bins in bands, and updates the levels.
+   */
+  void updateLevels();
+
+  int16_t real_[kSize];
+  int16_t imag_[kSize];
+  int filled_;  // Samples of the current window
+  State state_;
+  byte stage_;  // log2 of the half size of the butterflies of the stage
+  int next_;    // The next butterfly of the stage
+  byte edges_[kBands + 1];  // The first bin of every band
+  uint16_t peak_;  // The loudest band on the log scale, in 1/16 octave
+  byte levels_[kBands];
+  unsigned long transforms_;
+};
+
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_SPECTRUM_ANALYZER_H
@@ -0,0 +1,162 @@
+/*! \file state_store.cpp
+ *  \brief Implements the persistent store of the device state.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "state_store.h"
+
+namespace arduino_pixel {
+
+// Record layout:
+//   0: version
+//   1-2: sequence number (little endian)
+//   3: flags (bit 0: power)
+//   4: mode
+//   5-6: period in ms (little endian)
+//   7: number of colors
+//   8: brightness
+//   9-...: colors (r, g, b)
+//   last: crc8 of the preceding bytes
+
+StateStore::StateStore(storage::StorageBase &storage,
+                       const unsigned long &delay)
+    : storage_(storage),
+      delay_(delay),
+      num_slots_(storage.getSize() / kRecordSize),
+      slot_(num_slots_ - 1),
+      sequence_(0),
+      dirty_(false),
+      change_time_(0) {}
+
+bool StateStore::load(DeviceState &state) {
+  byte record[kRecordSize];
+  byte latest[kRecordSize];
+  bool found = false;
+  for (size_t slot = 0; slot < num_slots_; ++slot) {
+    if (not readRecord(slot, record)) continue;
+    uint16_t sequence = getSequence(record);
+    // Sequence numbers wrap around, so compare their distance
+    if (found and (int16_t)(sequence - sequence_) <= 0) continue;
+    found = true;
+    slot_ = slot;
+    sequence_ = sequence;
+    memcpy(latest, record, kRecordSize);
+  }
+  if (found) decode(latest, state);
+  return found;
+}
+
+void StateStore::save(const DeviceState &state) {
+  pending_ = state;
+  dirty_ = true;
+  change_time_ = Clock::millis();
+}
+
+void StateStore::update() {
+  if (not dirty_) return;
+  if ((unsigned long)(Clock::millis() - change_time_) < delay_) return;
+  flush();
+}
+
+void StateStore::flush() {
+  if (not dirty_ or num_slots_ == 0) return;
+  dirty_ = false;
+
+  byte record[kRecordSize];
+  byte latest[kRecordSize];
+  encode(pending_, sequence_, record);
+  // Skip the write if the latest record holds the same state
+  if (readRecord(slot_, latest) and getSequence(latest) == sequence_ and
+      memcmp(record + 3, latest + 3, kRecordSize - 4) == 0)
+    return;
+
+  slot_ = (slot_ + 1) % num_slots_;
+  encode(pending_, ++sequence_, record);
+  size_t addr = slot_ * kRecordSize;
+  for (byte i = 0; i < kRecordSize; ++i) storage_.write(addr + i, record[i]);
+  storage_.commit();
+}
+
+bool StateStore::readRecord(size_t slot, byte *record) {
+  size_t addr = slot * kRecordSize;
+  for (byte i = 0; i < kRecordSize; ++i) record[i] = storage_.read(addr + i);
+  return record[0] == kVersion and
+         record[kRecordSize - 1] == crc8(record, kRecordSize - 1) and
+         record[7] <= DeviceState::kMaxColors;
+}
+
+uint16_t StateStore::getSequence(const byte *record) {
+  return record[1] | ((uint16_t)record[2] << 8);
+}
+
+void StateStore::encode(const DeviceState &state, uint16_t sequence,
+                        byte *record) {
+  uint16_t period = (state.period > 0xFFFF) ? 0xFFFF : state.period;
+  record[0] = kVersion;
+  record[1] = sequence & 0xFF;
+  record[2] = sequence >> 8;
+  record[3] = state.power ? 1 : 0;
+  record[4] = (byte)state.mode;
+  record[5] = period & 0xFF;
+  record[6] = period >> 8;
+  record[7] = state.num_colors;
+  record[8] = state.brightness;
+  byte *color = record + kHeaderSize;
+  for (byte i = 0; i < DeviceState::kMaxColors; ++i, color += 3) {
+    const Color &c = (i < state.num_colors) ? state.colors[i] : Color(0, 0, 0);
+    color[0] = c.red;
+    color[1] = c.green;
+    color[2] = c.blue;
+  }
+  record[kRecordSize - 1] = crc8(record, kRecordSize - 1);
+}
+
+void StateStore::decode(const byte *record, DeviceState &state) {
+  state.power = record[3] & 1;
+  state.mode = (Mode)record[4];
+  state.period = record[5] | ((uint16_t)record[6] << 8);
+  state.num_colors = record[7];
+  state.brightness = record[8];
+  const byte *color = record + kHeaderSize;
+  for (byte i = 0; i < state.num_colors; ++i, color += 3)
+    state.colors[i] = Color(color[0], color[1], color[2]);
+}
+
+byte StateStore::crc8(const byte *data, size_t length) {
+  // CRC-8/MAXIM
+  byte crc = 0;
+  while (length--) {
+    byte value = *data++;
+    for (byte i = 0; i < 8; ++i, value >>= 1) {
+      bool mix = (crc ^ value) & 1;
+      crc >>= 1;
+      if (mix) crc ^= 0x8C;
+    }
+  }
+  return crc;
+}
+
+}  // namespace arduino_pixel
@@ -0,0 +1,125 @@
+/*! \file state_store.h
+ *  \brief Declares the persistent store of the device state.
+ *  \details The state is saved as a compact, versioned record. Every save
+ *  goes to the next slot of a ring, so the writes are spread over the entire
+ *  storage. Saves are deferred until the state stops changing, so a burst of
+ *  requests costs a single write.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_STATE_STORE_H
+#define ARDUINO_PIXEL_STATE_STORE_H
+
+#include "clock.h"
+#include "common_types.h"
+#include "storage/storage_base.h"
+
+namespace arduino_pixel {
+
+struct DeviceState {
+  static const byte kMaxColors = 4;
+
+  DeviceState()
+      : power(false),
+        mode(Mode::SINGLE_COLOR),
+        period(0),
+        brightness(255),
+        num_colors(0) {}
+
+  boolean power;
+  Mode mode;
+  unsigned long period;
+  byte brightness;
+  byte num_colors;
+  Color colors[kMaxColors];
+};
+
+class StateStore {
+ public:
+  /**
+   * \param[in] storage the storage of the records.
+   * \param[in] delay the time in ms that the state has to stay unchanged
+   * before it's written to the storage.
+   */
+  StateStore(storage::StorageBase &storage,
+             const unsigned long &delay = 5000ul);
+  /**
+   * \brief Loads the latest valid state.
+   * \param[out] state the state. It's left untouched if no record is found.
+   * \return Flag to indicate whether a state was found.
+   */
+  bool load(DeviceState &state);
+  /**
+   * \brief Schedules a state to be saved.
+   * \note Only the latest state is written, once the delay has passed.
+   * \param[in] state the state.
+   */
+  void save(const DeviceState &state);
+  /**
+   * \brief Writes the pending state, if it's due.
+   * \note Call this periodically, e.g. on every iteration of the main loop.
+   */
+  void update();
+  /**
+   * \brief Writes the pending state immediately.
+   */
+  void flush();
+
+ private:
+  static const byte kVersion = 2;
+  static const byte kHeaderSize = 9;
+  static const byte kRecordSize = kHeaderSize + 3 * DeviceState::kMaxColors + 1;
+
+  /**
+   * \brief Reads and validates the record in a slot.
+   * \param[in] slot the slot.
+   * \param[out] record the raw record.
+   * \return Flag to indicate whether the record is valid.
+   */
+  bool readRecord(size_t slot, byte *record);
+  /**
+   * \brief Gets the sequence number of a raw record.
+   */
+  static uint16_t getSequence(const byte *record);
+  static void encode(const DeviceState &state, uint16_t sequence,
+                     byte *record);
+  static void decode(const byte *record, DeviceState &state);
+  static byte crc8(const byte *data, size_t length);
+
+  storage::StorageBase &storage_;
+  const unsigned long delay_;
+  const size_t num_slots_;
+  size_t slot_;        // The slot of the latest record
+  uint16_t sequence_;  // The sequence number of the latest record
+
+  DeviceState pending_;
+  boolean dirty_;
+  unsigned long change_time_;
+};
+
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_STATE_STORE_H
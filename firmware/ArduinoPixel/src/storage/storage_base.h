@@ -0,0 +1,76 @@
+/*! \file storage_base.h
+ *  \brief Defines the storage base.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_STORAGE_STORAGE_BASE_H
+#define ARDUINO_PIXEL_STORAGE_STORAGE_BASE_H
+
+#include "common_types.h"
+
+namespace arduino_pixel {
+namespace storage {
+
+class StorageBase {
+ public:
+  virtual ~StorageBase() {}
+  /**
+   * \brief Initializes the storage.
+   * \note Use to open or map the underlying medium.
+   */
+  virtual void init() {}
+  /**
+   * \brief Gets the size of the storage.
+   * \return The number of bytes.
+   */
+  virtual size_t getSize() const = 0;
+  /**
+   * \brief Reads a byte.
+   * \param[in] addr the address of the byte.
+   * \return The value of the byte.
+   */
+  virtual byte read(size_t addr) = 0;
+  /**
+   * \brief Writes a byte.
+   * \note Implementations should skip bytes that don't change, to spare
+   * the medium.
+   * \param[in] addr the address of the byte.
+   * \param[in] value the value of the byte.
+   */
+  virtual void write(size_t addr, byte value) = 0;
+  /**
+   * \brief Makes the written bytes persistent.
+   */
+  virtual void commit() {}
+
+ protected:
+  StorageBase() {}
+};
+
+}  // namespace storage
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_STORAGE_STORAGE_BASE_H
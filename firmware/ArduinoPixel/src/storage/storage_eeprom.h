@@ -0,0 +1,80 @@
+/*! \file storage_eeprom.h
+ *  \brief Interface for the EEPROM.
+ *  \details On ESP32, the EEPROM library emulates the EEPROM on top of NVS.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_STORAGE_STORAGE_EEPROM_H
+#define ARDUINO_PIXEL_STORAGE_STORAGE_EEPROM_H
+
+#include <EEPROM.h>
+
+#include "storage/storage_base.h"
+
+namespace arduino_pixel {
+namespace storage {
+
+class StorageEeprom : public StorageBase {
+ public:
+  /**
+   * \param[in] offset the address of the first byte in the EEPROM.
+   * \param[in] size the number of bytes to use.
+   */
+  StorageEeprom(const size_t &offset = 0, const size_t &size = 512)
+      : offset_(offset), size_(size) {}
+
+  virtual void init() override {
+#if defined(ESP32) || defined(ESP8266)
+    EEPROM.begin(offset_ + size_);
+#endif
+  }
+
+  virtual size_t getSize() const override { return size_; }
+
+  virtual byte read(size_t addr) override {
+    return EEPROM.read(offset_ + addr);
+  }
+
+  virtual void write(size_t addr, byte value) override {
+    addr += offset_;
+    if (EEPROM.read(addr) != value) EEPROM.write(addr, value);
+  }
+
+  virtual void commit() override {
+#if defined(ESP32) || defined(ESP8266)
+    EEPROM.commit();
+#endif
+  }
+
+ protected:
+  const size_t offset_;
+  const size_t size_;
+};
+
+}  // namespace storage
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_STORAGE_STORAGE_EEPROM_H
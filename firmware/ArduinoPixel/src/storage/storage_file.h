@@ -0,0 +1,98 @@
+/*! \file storage_file.h
+ *  \brief Interface for a file.
+ *  \details The storage is kept in memory and written to a file on commit, e.g.
+ *  on a host, or on ESP32 on a mounted file system. Platforms without stdio
+ *  files, e.g. AVR, can't use it.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_STORAGE_STORAGE_FILE_H
+#define ARDUINO_PIXEL_STORAGE_STORAGE_FILE_H
+
+#include <stdio.h>
+
+#include "storage/storage_base.h"
+
+namespace arduino_pixel {
+namespace storage {
+
+class StorageFile : public StorageBase {
+ public:
+  /**
+   * \param[in] path the path of the file, which has to outlive the storage.
+   * \param[in] size the number of bytes to use.
+   */
+  StorageFile(const char *path, const size_t &size = 512)
+      : path_(path), size_(size), bytes_(nullptr), dirty_(false) {}
+
+  virtual ~StorageFile() { delete[] bytes_; }
+
+  /**
+   * \details Reads the file. The bytes past its end, or all of them if
+   * there is no file, are erased, i.e. 0xFF, as on an EEPROM.
+   */
+  virtual void init() override {
+    if (not bytes_) bytes_ = new byte[size_];
+    if (not bytes_) return;
+    memset(bytes_, 0xFF, size_);
+    FILE *file = fopen(path_, "rb");
+    if (not file) return;
+    if (fread(bytes_, 1, size_, file) < size_ and ferror(file))
+      memset(bytes_, 0xFF, size_);
+    fclose(file);
+  }
+
+  virtual size_t getSize() const override { return size_; }
+
+  virtual byte read(size_t addr) override {
+    return bytes_ ? bytes_[addr] : 0xFF;
+  }
+
+  virtual void write(size_t addr, byte value) override {
+    if (not bytes_ or bytes_[addr] == value) return;
+    bytes_[addr] = value;
+    dirty_ = true;
+  }
+
+  virtual void commit() override {
+    if (not dirty_) return;
+    FILE *file = fopen(path_, "wb");
+    if (not file) return;  // The bytes are written on the next commit
+    dirty_ = fwrite(bytes_, 1, size_, file) != size_;
+    if (fclose(file) != 0) dirty_ = true;
+  }
+
+ protected:
+  const char *path_;
+  const size_t size_;
+  byte *bytes_;  // The bytes of the file
+  bool dirty_;   // Whether the bytes have changed since the commit
+};
+
+}  // namespace storage
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_STORAGE_STORAGE_FILE_H
@@ -0,0 +1,100 @@
+/*! \file Adafruit_NeoPixel.h
+ *  \brief Stands in for the Adafruit NeoPixel library.
+ *  \details The pixels are kept in the order of the type, as the library does,
+ *  and show only counts the frames.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_HOST_ADAFRUIT_NEOPIXEL_H
+#define ARDUINO_PIXEL_HOST_ADAFRUIT_NEOPIXEL_H
+
+#include "Arduino.h"
+
+typedef uint16_t neoPixelType;
+
+// The offsets of white, red, green, and blue in a pixel
+#define NEO_RGB ((0 << 6) | (0 << 4) | (1 << 2) | (2))
+#define NEO_GRB ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_BRG ((1 << 6) | (1 << 4) | (2 << 2) | (0))
+#define NEO_RGBW ((3 << 6) | (0 << 4) | (1 << 2) | (2))
+#define NEO_GRBW ((3 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_KHZ800 0x0000
+
+class Adafruit_NeoPixel {
+ public:
+  Adafruit_NeoPixel(uint16_t n, int16_t pin, neoPixelType type)
+      : w_offset_((type >> 6) & 3),
+        r_offset_((type >> 4) & 3),
+        g_offset_((type >> 2) & 3),
+        b_offset_(type & 3),
+        bytes_per_pixel_((w_offset_ == r_offset_) ? 3 : 4),
+        pixels_(new uint8_t[n * bytes_per_pixel_]()),
+        num_leds_(pixels_ ? n : 0),  // No pixels when there is no memory
+        shows_(0) {}
+
+  ~Adafruit_NeoPixel() { delete[] pixels_; }
+
+  void begin() {}
+  void show() { ++shows_; }
+  uint16_t numPixels() const { return num_leds_; }
+  uint8_t *getPixels() const { return pixels_; }
+  void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b) {
+    if (n >= num_leds_) return;
+    uint8_t *pixel = pixels_ + n * bytes_per_pixel_;
+    pixel[r_offset_] = r;
+    pixel[g_offset_] = g;
+    pixel[b_offset_] = b;
+  }
+  void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b, uint8_t w) {
+    if (n >= num_leds_) return;
+    setPixelColor(n, r, g, b);
+    if (bytes_per_pixel_ == 4) pixels_[n * 4 + w_offset_] = w;
+  }
+  uint32_t getPixelColor(uint16_t n) const {
+    if (n >= num_leds_) return 0;
+    const uint8_t *pixel = pixels_ + n * bytes_per_pixel_;
+    uint32_t white = (bytes_per_pixel_ == 4) ? pixel[w_offset_] : 0;
+    return (white << 24) | ((uint32_t)pixel[r_offset_] << 16) |
+           ((uint32_t)pixel[g_offset_] << 8) | pixel[b_offset_];
+  }
+
+  /**
+   * \brief Gets the number of frames that have been shown.
+   */
+  unsigned long getShows() const { return shows_; }
+
+ private:
+  uint8_t w_offset_;
+  uint8_t r_offset_;
+  uint8_t g_offset_;
+  uint8_t b_offset_;
+  uint8_t bytes_per_pixel_;
+  uint8_t *pixels_;
+  uint16_t num_leds_;
+  unsigned long shows_;
+};
+
+#endif  // ARDUINO_PIXEL_HOST_ADAFRUIT_NEOPIXEL_H
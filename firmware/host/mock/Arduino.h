@@ -0,0 +1,260 @@
+/*! \file Arduino.h
+ *  \brief Stands in for the Arduino core on the host.
+ *  \details The library is built on a PC for the tests, the simulator, and the
+ *  benchmarks. Only the parts of the core that the library uses are provided,
+ *  and the time follows a monotonic clock of the host.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_HOST_ARDUINO_H
+#define ARDUINO_PIXEL_HOST_ARDUINO_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <algorithm>
+#include <string>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+// Flash is ordinary memory on the host
+class __FlashStringHelper;
+#define F(string_literal) \
+  (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+#define PSTR(string_literal) (string_literal)
+#define PROGMEM
+typedef const char *PGM_P;
+#define pgm_read_byte(address) (*reinterpret_cast<const uint8_t *>(address))
+#define pgm_read_word(address) (*reinterpret_cast<const uint16_t *>(address))
+#define pgm_read_dword(address) (*reinterpret_cast<const uint32_t *>(address))
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define strncasecmp_P strncasecmp
+#define strstr_P strstr
+#define memcpy_P memcpy
+
+#define DEC 10
+#define HEX 16
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+int analogRead(uint8_t pin);
+
+using std::max;
+using std::min;
+
+template <typename T, typename L, typename H>
+T constrain(T value, L low, H high) {
+  return (value < low) ? low : (value > high) ? high : value;
+}
+
+inline bool isDigit(int c) { return c >= '0' and c <= '9'; }
+inline bool isSpace(int c) {
+  return c == ' ' or c == '\t' or c == '\n' or c == '\r' or c == '\f' or
+         c == '\v';
+}
+inline bool isHexadecimalDigit(int c) {
+  return isDigit(c) or (c >= 'a' and c <= 'f') or (c >= 'A' and c <= 'F');
+}
+
+class String {
+ public:
+  String() {}
+  String(const char *text) : text_(text) {}
+  String(const __FlashStringHelper *text)
+      : text_(reinterpret_cast<const char *>(text)) {}
+  explicit String(int value) : text_(std::to_string(value)) {}
+  explicit String(long value) : text_(std::to_string(value)) {}
+  explicit String(unsigned long value) : text_(std::to_string(value)) {}
+
+  const char *c_str() const { return text_.c_str(); }
+  unsigned int length() const { return text_.size(); }
+  bool reserve(unsigned int size) {
+    text_.reserve(size);
+    return true;
+  }
+  char operator[](unsigned int idx) const {
+    return (idx < text_.size()) ? text_[idx] : 0;
+  }
+  bool operator==(const String &other) const { return text_ == other.text_; }
+  bool operator!=(const String &other) const { return text_ != other.text_; }
+
+  String &operator+=(const String &other) {
+    text_ += other.text_;
+    return *this;
+  }
+  String &operator+=(const char *text) {
+    text_ += text;
+    return *this;
+  }
+  String &operator+=(const __FlashStringHelper *text) {
+    text_ += reinterpret_cast<const char *>(text);
+    return *this;
+  }
+  String &operator+=(char c) {
+    text_ += c;
+    return *this;
+  }
+  // Numbers are appended in decimal, as on the Arduino
+  String &operator+=(unsigned char value) { return append(value); }
+  String &operator+=(int value) { return append(value); }
+  String &operator+=(unsigned int value) { return append(value); }
+  String &operator+=(long value) { return append(value); }
+  String &operator+=(unsigned long value) { return append(value); }
+
+  int indexOf(char c, unsigned int from = 0) const {
+    return toIndex(text_.find(c, from));
+  }
+  int indexOf(const char *text, unsigned int from = 0) const {
+    return toIndex(text_.find(text, from));
+  }
+  int lastIndexOf(char c) const { return toIndex(text_.rfind(c)); }
+  String substring(unsigned int begin) const {
+    return substring(begin, text_.size());
+  }
+  String substring(unsigned int begin, unsigned int end) const {
+    if (end > text_.size()) end = text_.size();
+    if (begin > end) std::swap(begin, end);
+    String part;
+    part.text_ = text_.substr(begin, end - begin);
+    return part;
+  }
+  long toInt() const { return atol(text_.c_str()); }
+
+ private:
+  template <typename T>
+  String &append(T value) {
+    text_ += std::to_string(value);
+    return *this;
+  }
+  static int toIndex(size_t position) {
+    return (position == std::string::npos) ? -1 : (int)position;
+  }
+
+  std::string text_;
+};
+
+class Print {
+ public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size) {
+    size_t count = 0;
+    while (size--) count += write(*buffer++);
+    return count;
+  }
+  size_t write(const char *text) {
+    return write(reinterpret_cast<const uint8_t *>(text), strlen(text));
+  }
+  size_t print(const __FlashStringHelper *text) {
+    return write(reinterpret_cast<const char *>(text));
+  }
+  size_t print(const char *text) { return write(text); }
+  size_t print(const String &text) {
+    return write(reinterpret_cast<const uint8_t *>(text.c_str()),
+                 text.length());
+  }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char value, int base = DEC) {
+    return print((unsigned long)value, base);
+  }
+  size_t print(int value, int base = DEC) { return print((long)value, base); }
+  size_t print(unsigned int value, int base = DEC) {
+    return print((unsigned long)value, base);
+  }
+  size_t print(long value, int base = DEC) {
+    if (value < 0 and base == DEC) return print('-') + print(-value, base);
+    return print((unsigned long)value, base);
+  }
+  size_t print(unsigned long value, int base = DEC) {
+    char digits[8 * sizeof(value) + 1];
+    char *digit = digits + sizeof(digits);
+    *--digit = '\0';
+    do {
+      *--digit = "0123456789ABCDEF"[value % base];
+      value /= base;
+    } while (value);
+    return write(digit);
+  }
+  size_t println() { return write("\r\n"); }
+  template <typename T>
+  size_t println(const T &value) {
+    size_t count = print(value);
+    return count + println();
+  }
+  virtual void flush() {}
+};
+
+class Stream : public Print {
+ public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  size_t readBytes(uint8_t *buffer, size_t size) {
+    size_t count = 0;
+    for (int c; count < size and (c = read()) >= 0;) buffer[count++] = c;
+    return count;
+  }
+};
+
+class IPAddress {
+ public:
+  IPAddress() : address_{0, 0, 0, 0} {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+      : address_{a, b, c, d} {}
+  uint8_t operator[](int idx) const { return address_[idx]; }
+  bool operator==(const IPAddress &other) const {
+    return memcmp(address_, other.address_, 4) == 0;
+  }
+
+ private:
+  uint8_t address_[4];
+};
+
+/**
+ * \brief Serial port that writes to the standard output.
+ */
+class HardwareSerial : public Stream {
+ public:
+  void begin(unsigned long baud) {}
+  virtual size_t write(uint8_t c) override;
+  using Print::write;
+  virtual int available() override { return 0; }
+  virtual int read() override { return -1; }
+  virtual int peek() override { return -1; }
+};
+
+extern HardwareSerial Serial;
+
+#endif  // ARDUINO_PIXEL_HOST_ARDUINO_H
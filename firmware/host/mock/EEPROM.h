@@ -0,0 +1,66 @@
+/*! \file EEPROM.h
+ *  \brief Stands in for the EEPROM library of the Arduino core.
+ *  \details The EEPROM is an erased block of memory that counts the writes, so
+ *  the tests can check the wear of the medium.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_HOST_EEPROM_H
+#define ARDUINO_PIXEL_HOST_EEPROM_H
+
+#include "Arduino.h"
+
+class EEPROMClass {
+ public:
+  static const uint16_t kSize = 4096;
+
+  EEPROMClass() : writes_(0) { memset(memory_, 0xFF, kSize); }
+
+  void begin(size_t size) {}
+  bool commit() { return true; }
+  uint8_t read(int address) const { return memory_[address]; }
+  void write(int address, uint8_t value) {
+    memory_[address] = value;
+    ++writes_;
+  }
+  void update(int address, uint8_t value) {
+    if (memory_[address] != value) write(address, value);
+  }
+  uint16_t length() const { return kSize; }
+
+  /**
+   * \brief Gets the number of writes.
+   */
+  unsigned long getWrites() const { return writes_; }
+
+ private:
+  uint8_t memory_[kSize];
+  unsigned long writes_;
+};
+
+extern EEPROMClass EEPROM;
+
+#endif  // ARDUINO_PIXEL_HOST_EEPROM_H
@@ -0,0 +1,99 @@
+/*! \file SPI.h
+ *  \brief Stands in for the SPI library of the Arduino core.
+ *  \details The bus keeps every byte that is sent, so the tests can check what
+ *  a strip puts on the wire.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_HOST_SPI_H
+#define ARDUINO_PIXEL_HOST_SPI_H
+
+#include <vector>
+
+#include "Arduino.h"
+
+#define SPI_MODE0 0x00
+
+class SPISettings {
+ public:
+  SPISettings()
+      : clock_(4000000), bit_order_(MSBFIRST), data_mode_(SPI_MODE0) {}
+  SPISettings(uint32_t clock, uint8_t bit_order, uint8_t data_mode)
+      : clock_(clock), bit_order_(bit_order), data_mode_(data_mode) {}
+
+  uint32_t getClock() const { return clock_; }
+
+ private:
+  uint32_t clock_;
+  uint8_t bit_order_;
+  uint8_t data_mode_;
+};
+
+class SPIClass {
+ public:
+  SPIClass() : transactions_(0) {}
+
+  void begin() {}
+  void end() {}
+  void beginTransaction(const SPISettings &settings) {
+    settings_ = settings;
+    ++transactions_;
+  }
+  void endTransaction() {}
+  uint8_t transfer(uint8_t data) {
+    sent_.push_back(data);
+    return 0;
+  }
+  void writeBytes(const uint8_t *data, uint32_t size) {
+    sent_.insert(sent_.end(), data, data + size);
+  }
+
+  /**
+   * \brief Gets the bytes that have been sent.
+   */
+  const std::vector<uint8_t> &getSent() const { return sent_; }
+  /**
+   * \brief Forgets the bytes that have been sent.
+   */
+  void clearSent() { sent_.clear(); }
+  /**
+   * \brief Gets the number of transactions.
+   */
+  unsigned long getTransactions() const { return transactions_; }
+  /**
+   * \brief Gets the settings of the latest transaction.
+   */
+  const SPISettings &getSettings() const { return settings_; }
+
+ private:
+  std::vector<uint8_t> sent_;
+  SPISettings settings_;
+  unsigned long transactions_;
+};
+
+extern SPIClass SPI;
+
+#endif  // ARDUINO_PIXEL_HOST_SPI_H
@@ -0,0 +1,115 @@
+/*! \file arduino.cpp
+ *  \brief Implements the parts of the Arduino core for the host.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <thread>
+
+#include "Arduino.h"
+#include "EEPROM.h"
+#include "SPI.h"
+#include "host.h"
+
+HardwareSerial Serial;
+SPIClass SPI;
+EEPROMClass EEPROM;
+
+namespace {
+
+const std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+
+// Every block of the heap starts with its size, padded to keep the
+// alignment of new
+union BlockHeader {
+  size_t size;
+  max_align_t align;
+};
+
+std::atomic<size_t> heap_used(0);
+std::atomic<size_t> heap_limit(0);
+
+void *allocate(size_t size) {
+  size_t limit = heap_limit.load();
+  if (limit and heap_used.load() + size > limit) return nullptr;
+  BlockHeader *header =
+      static_cast<BlockHeader *>(malloc(sizeof(BlockHeader) + size));
+  if (not header) return nullptr;
+  header->size = size;
+  heap_used += size;
+  return header + 1;
+}
+
+void release(void *block) {
+  if (not block) return;
+  BlockHeader *header = static_cast<BlockHeader *>(block) - 1;
+  heap_used -= header->size;
+  free(header);
+}
+
+}  // namespace
+
+unsigned long millis() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+unsigned long micros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+void delay(unsigned long ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+int analogRead(uint8_t pin) { return 512; }  // The midpoint of silence
+
+size_t HardwareSerial::write(uint8_t c) { return fputc(c, stdout) != EOF; }
+
+size_t getHeapUsed() { return heap_used.load(); }
+
+void setHeapLimit(size_t limit) { heap_limit = limit; }
+
+// On the Arduino, new returns nullptr when the heap is exhausted
+void *operator new(size_t size) { return allocate(size); }
+void *operator new[](size_t size) { return allocate(size); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size);
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size);
+}
+void operator delete(void *block) noexcept { release(block); }
+void operator delete[](void *block) noexcept { release(block); }
+void operator delete(void *block, size_t) noexcept { release(block); }
+void operator delete[](void *block, size_t) noexcept { release(block); }
@@ -0,0 +1,50 @@
+/*! \file host.h
+ *  \brief Hooks of the host build that the Arduino core doesn't have.
+ *  \details The heap of the host counts the bytes that are allocated with new,
+ *  so the tests can account for the memory of the library, and it can be
+ *  limited, so they can exhaust it as on a microcontroller, where new returns
+ *  nullptr.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_HOST_HOST_H
+#define ARDUINO_PIXEL_HOST_HOST_H
+
+#include <stddef.h>
+
+/**
+ * \brief Gets the number of bytes that are allocated with new.
+ */
+size_t getHeapUsed();
+/**
+ * \brief Limits the bytes that new may allocate.
+ * \details A new that would go over the limit returns nullptr. The library
+ * is built with -fcheck-new, so it sees the failure as on the Arduino.
+ * \param[in] limit the number of bytes, or 0 for no limit.
+ */
+void setHeapLimit(size_t limit);
+
+#endif  // ARDUINO_PIXEL_HOST_HOST_H
@@ -0,0 +1,78 @@
+/*! \file file_print.h
+ *  \brief Print stream on a file of the host.
+ *  \details E.g. the output of a LedStripRecording.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_HOST_FILE_PRINT_H
+#define ARDUINO_PIXEL_HOST_FILE_PRINT_H
+
+#include <stdio.h>
+
+#include <Arduino.h>
+
+namespace arduino_pixel {
+namespace host {
+
+class FilePrint : public Print {
+ public:
+  /**
+   * \param[in] path the path of the file, which is truncated.
+   */
+  explicit FilePrint(const char *path) : file_(fopen(path, "wb")) {}
+
+  virtual ~FilePrint() {
+    if (file_) fclose(file_);
+  }
+
+  /**
+   * \brief Checks whether the file could be opened.
+   */
+  bool isOpen() const { return file_ != nullptr; }
+
+  virtual size_t write(uint8_t c) override { return write(&c, 1); }
+
+  virtual size_t write(const uint8_t *buffer, size_t size) override {
+    return file_ ? fwrite(buffer, 1, size, file_) : 0;
+  }
+
+  using Print::write;
+
+  virtual void flush() override {
+    if (file_) fflush(file_);
+  }
+
+ private:
+  FilePrint(const FilePrint &) = delete;
+  FilePrint &operator=(const FilePrint &) = delete;
+
+  FILE *file_;
+};
+
+}  // namespace host
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_HOST_FILE_PRINT_H
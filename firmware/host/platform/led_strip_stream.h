@@ -0,0 +1,141 @@
+/*! \file led_strip_stream.h
+ *  \brief LED strip that streams its frames to an ArduinoPixel server.
+ *  \details A strip on the host renders a mode as on a device, and every shown
+ *  frame is sent in the packets of the STREAM mode, so the server only shows
+ *  it.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_HOST_LED_STRIP_STREAM_H
+#define ARDUINO_PIXEL_HOST_LED_STRIP_STREAM_H
+
+#include <Udp.h>
+
+#include "led_strip/led_strip_base.h"
+#include "server_types.h"
+
+namespace arduino_pixel {
+namespace host {
+
+/**
+ * \brief LED strip that sends every frame to a server over UDP.
+ * \details A frame is split in packets of at most max_leds pixels, which
+ * have a header of StreamPacket::kHeaderSize bytes, all values little endian:
+ *   "AP", version, flags (StreamPacket::kLastPacket on the last packet of a
+ *   frame), sequence number of the frame, first pixel, number of pixels
+ *   (2 bytes each), and the r, g, b of every pixel
+ * \note A strip isn't thread safe, but strips on different sockets can show
+ * their frames on different threads.
+ */
+class LedStripStream : public led_strip::LedStripBase {
+ public:
+  /**
+   * \param[in] num_leds number of LEDs.
+   * \param[in] udp the socket that sends the packets.
+   * \param[in] address the address of the server.
+   * \param[in] port the UDP port of the frame stream of the server.
+   * \param[in] max_leds the maximum number of pixels in a packet, e.g. 480
+   * to keep a packet in an Ethernet frame.
+   */
+  LedStripStream(const int &num_leds, UDP &udp, const IPAddress &address,
+                 uint16_t port, int max_leds = 480)
+      : num_leds_(num_leds),
+        pixels_(new byte[3 * num_leds]()),
+        udp_(udp),
+        address_(address),
+        port_(port),
+        max_leds_(max_leds > 0 ? max_leds : 1),
+        sequence_(0),
+        num_frames_(0),
+        num_packets_(0) {}
+
+  virtual ~LedStripStream() { delete[] pixels_; }
+
+  virtual void show() override {
+    for (int first = 0; first < num_leds_; first += max_leds_) {
+      int count = min(max_leds_, num_leds_ - first);
+      byte header[StreamPacket::kHeaderSize] = {
+          'A', 'P', StreamPacket::kVersion,
+          (byte)((first + count == num_leds_) ? StreamPacket::kLastPacket : 0),
+          (byte)(sequence_ & 0xFF), (byte)(sequence_ >> 8),
+          (byte)(first & 0xFF), (byte)(first >> 8),
+          (byte)(count & 0xFF), (byte)(count >> 8)};
+      udp_.beginPacket(address_, port_);
+      udp_.write(header, sizeof(header));
+      udp_.write(pixels_ + 3 * first, 3 * count);
+      if (udp_.endPacket()) ++num_packets_;
+    }
+    ++sequence_;
+    ++num_frames_;
+  }
+
+  virtual int getNumLeds() const override { return num_leds_; }
+
+  /**
+   * \brief Gets the number of shown frames.
+   */
+  unsigned long getNumFrames() const { return num_frames_; }
+  /**
+   * \brief Gets the number of packets that have been sent.
+   */
+  unsigned long getNumPackets() const { return num_packets_; }
+
+ protected:
+  virtual Color readPixel(int idx) const override {
+    const byte *pixel = pixels_ + 3 * idx;
+    return Color(pixel[0], pixel[1], pixel[2]);
+  }
+
+  virtual void writePixel(int idx, const Color &color) override {
+    byte *pixel = pixels_ + 3 * idx;
+    pixel[0] = color.red;
+    pixel[1] = color.green;
+    pixel[2] = color.blue;
+  }
+
+  virtual void rotatePixels(int count) override {
+    rotateBytes(pixels_, 3 * num_leds_, 3 * count);
+  }
+
+ private:
+  LedStripStream(const LedStripStream &) = delete;
+  LedStripStream &operator=(const LedStripStream &) = delete;
+
+  int num_leds_;
+  byte *pixels_;
+  UDP &udp_;
+  IPAddress address_;
+  uint16_t port_;
+  int max_leds_;
+  uint16_t sequence_;
+  unsigned long num_frames_;
+  unsigned long num_packets_;
+};
+
+}  // namespace host
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_HOST_LED_STRIP_STREAM_H
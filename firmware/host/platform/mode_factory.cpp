@@ -0,0 +1,72 @@
+/*! \file mode_factory.cpp
+ *  \brief Creates the modes by name on the host.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "mode_factory.h"
+
+namespace arduino_pixel {
+namespace host {
+
+Mode parseMode(const char *name) {
+  for (byte type = (byte)Mode::SINGLE_COLOR; type <= (byte)Mode::SPECTRUM;
+       ++type) {
+    PGM_P mode_name = reinterpret_cast<PGM_P>(toString((Mode)type));
+    if (strcmp_P(name, mode_name) == 0) return (Mode)type;
+  }
+  return Mode::INVALID;
+}
+
+mode::ModeBase *createMode(Mode type, int num_leds, unsigned long period) {
+  // The same defaults as ArduinoPixelServer::createMode
+  switch (type) {
+    case Mode::SINGLE_COLOR:
+      return new mode::SingleColor(num_leds);
+    case Mode::SCANNER:
+      return new mode::Scanner(num_leds, period ? period : 100ul);
+    case Mode::RAINBOW:
+      return new mode::Rainbow(num_leds, period ? period : 10ul);
+    case Mode::RAINBOW_CYCLE:
+      return new mode::RainbowCycle(num_leds, period ? period : 10ul);
+    case Mode::GRADIENT:
+      return new mode::Gradient(num_leds);
+    case Mode::GRADIENT_SCROLL:
+      return new mode::GradientScroll(num_leds, period ? period : 50ul);
+    case Mode::CANVAS:
+      return new mode::Canvas(num_leds);
+    case Mode::NOISE:
+      return new mode::Noise(num_leds, period ? period : 20ul);
+    case Mode::FIRE:
+      return new mode::Fire(num_leds, period ? period : 15ul);
+    case Mode::TWINKLE:
+      return new mode::Twinkle(num_leds, period ? period : 20ul);
+    default:
+      return nullptr;
+  }
+}
+
+}  // namespace host
+}  // namespace arduino_pixel
@@ -0,0 +1,59 @@
+/*! \file mode_factory.h
+ *  \brief Creates the modes by name on the host.
+ *  \details The tools of the host build, e.g. the simulator, take the modes by
+ *  the names that the server uses. The modes that need the data of the server,
+ *  i.e. PLAYBACK, SCRIPT, STREAM, and SPECTRUM, aren't created.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_HOST_MODE_FACTORY_H
+#define ARDUINO_PIXEL_HOST_MODE_FACTORY_H
+
+#include "modes.h"
+
+namespace arduino_pixel {
+namespace host {
+
+/**
+ * \brief Finds a mode by its name.
+ * \param[in] name the name of the mode, e.g. "SCANNER".
+ * \return The mode, or Mode::INVALID if there is none with the name.
+ */
+Mode parseMode(const char *name);
+
+/**
+ * \brief Creates a mode.
+ * \param[in] type the mode.
+ * \param[in] num_leds the number of LEDs.
+ * \param[in] period the period in ms, or 0 for the default of the server.
+ * \return The mode, or nullptr if it can't be created on its own.
+ */
+mode::ModeBase *createMode(Mode type, int num_leds, unsigned long period);
+
+}  // namespace host
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_HOST_MODE_FACTORY_H
@@ -0,0 +1,93 @@
+/*! \file render_pool.cpp
+ *  \brief Pool of threads that render the frames of many LED strips.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "render_pool.h"
+
+namespace arduino_pixel {
+namespace host {
+
+RenderPool::RenderPool(int num_threads)
+    : frame_(0),
+      running_(0),
+      stopped_(false),
+      force_(false),
+      next_(0),
+      shown_(0) {
+  for (int i = 1; i < num_threads; ++i)
+    workers_.push_back(std::thread(&RenderPool::work, this));
+}
+
+RenderPool::~RenderPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  start_.notify_all();
+  for (std::thread &worker : workers_) worker.join();
+}
+
+int RenderPool::render(bool force) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    force_ = force;
+    next_ = 0;
+    shown_ = 0;
+    running_ = workers_.size();
+    ++frame_;
+  }
+  start_.notify_all();
+  renderStrips();
+  // The mutex orders the writes of the workers before the next frame
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this]() { return running_ == 0; });
+  return shown_;
+}
+
+void RenderPool::work() {
+  unsigned long frame = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_.wait(lock,
+                  [this, frame]() { return stopped_ or frame_ != frame; });
+      if (stopped_) return;
+      frame = frame_;
+    }
+    renderStrips();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--running_ == 0) done_.notify_one();
+  }
+}
+
+void RenderPool::renderStrips() {
+  for (size_t idx = next_++; idx < strips_.size(); idx = next_++)
+    if (strips_[idx]->colorize(force_)) ++shown_;
+}
+
+}  // namespace host
+}  // namespace arduino_pixel
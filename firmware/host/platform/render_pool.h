@@ -0,0 +1,102 @@
+/*! \file render_pool.h
+ *  \brief Pool of threads that render the frames of many LED strips.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_HOST_RENDER_POOL_H
+#define ARDUINO_PIXEL_HOST_RENDER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "led_strip/led_strip_base.h"
+
+namespace arduino_pixel {
+namespace host {
+
+/**
+ * \brief Renders a frame of every strip on a pool of threads.
+ * \details The strips are taken by the threads one at a time, so a slow
+ * strip, e.g. a long one, doesn't hold back the strips of the other threads.
+ * The modes read the Clock, and the arena and the heap are shared, so:
+ *   - the modes are created, set on their strips, and initialized on the
+ *     thread that calls render, before the first frame
+ *   - the Clock is set on the thread that calls render, between the frames
+ * Every strip and mode is used by one thread at a time.
+ */
+class RenderPool {
+ public:
+  /**
+   * \param[in] num_threads the number of threads, including the one that
+   * calls render.
+   */
+  explicit RenderPool(int num_threads);
+  ~RenderPool();
+
+  /**
+   * \brief Adds a strip, which has its mode set. The pool doesn't own it.
+   */
+  void addStrip(led_strip::LedStripBase *strip) { strips_.push_back(strip); }
+
+  /**
+   * \brief Colorizes every strip, and returns when they are all done.
+   * \param[in] force whether to render every frame in full.
+   * \return The number of strips that showed a frame.
+   */
+  int render(bool force = false);
+
+  int getNumThreads() const { return workers_.size() + 1; }
+
+ private:
+  RenderPool(const RenderPool &) = delete;
+  RenderPool &operator=(const RenderPool &) = delete;
+
+  void work();
+  /**
+   * \brief Colorizes strips until none is left in the frame.
+   */
+  void renderStrips();
+
+  std::vector<led_strip::LedStripBase *> strips_;
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  unsigned long frame_;  // Incremented for every frame, under the mutex
+  int running_;          // Workers that are rendering the frame
+  bool stopped_;
+  bool force_;
+  std::atomic<size_t> next_;  // The index of the next strip of the frame
+  std::atomic<int> shown_;
+};
+
+}  // namespace host
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_HOST_RENDER_POOL_H
@@ -0,0 +1,155 @@
+/*! \file socket_client.h
+ *  \brief Client on a TCP socket of the host.
+ *  \details It has the semantics of the clients of the Arduino network
+ *  libraries: reads don't block, and a connection reads as connected while it
+ *  has bytes to read, even after the peer has closed it.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_HOST_SOCKET_CLIENT_H
+#define ARDUINO_PIXEL_HOST_SOCKET_CLIENT_H
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <Client.h>
+
+namespace arduino_pixel {
+namespace host {
+
+class SocketClient : public Client {
+ public:
+  /**
+   * \param[in] fd a connected socket, which the client then owns, or -1.
+   */
+  explicit SocketClient(int fd = -1) : fd_(fd) { setNoDelay(); }
+
+  virtual ~SocketClient() { stop(); }
+
+  virtual int connect(IPAddress ip, uint16_t port) override {
+    stop();
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr =
+        htonl((uint32_t)ip[0] << 24 | (uint32_t)ip[1] << 16 |
+              (uint32_t)ip[2] << 8 | ip[3]);
+    fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd_ < 0) return 0;
+    if (::connect(fd_, reinterpret_cast<sockaddr *>(&address),
+                  sizeof(address)) < 0) {
+      stop();
+      return 0;
+    }
+    setNoDelay();
+    return 1;
+  }
+
+  virtual int connect(const char *host, uint16_t port) override {
+    in_addr address;
+    if (inet_pton(AF_INET, host, &address) != 1) return 0;
+    uint32_t ip = ntohl(address.s_addr);
+    return connect(IPAddress(ip >> 24, ip >> 16, ip >> 8, ip), port);
+  }
+
+  virtual size_t write(uint8_t c) override { return write(&c, 1); }
+
+  virtual size_t write(const uint8_t *buffer, size_t size) override {
+    size_t sent = 0;
+    while (fd_ >= 0 and sent < size) {
+      ssize_t count = send(fd_, buffer + sent, size - sent, MSG_NOSIGNAL);
+      if (count <= 0) break;
+      sent += count;
+    }
+    return sent;
+  }
+
+  using Print::write;
+
+  virtual int available() override {
+    int count = 0;
+    if (fd_ < 0 or ioctl(fd_, FIONREAD, &count) < 0) return 0;
+    return count;
+  }
+
+  virtual int read() override {
+    uint8_t c;
+    return (read(&c, 1) == 1) ? c : -1;
+  }
+
+  virtual int read(uint8_t *buffer, size_t size) override {
+    if (fd_ < 0) return -1;
+    ssize_t count = recv(fd_, buffer, size, MSG_DONTWAIT);
+    return (count > 0) ? count : -1;
+  }
+
+  virtual int peek() override {
+    uint8_t c;
+    if (fd_ < 0 or recv(fd_, &c, 1, MSG_PEEK | MSG_DONTWAIT) != 1) return -1;
+    return c;
+  }
+
+  virtual void flush() override {}  // The kernel sends the bytes
+
+  virtual void stop() override {
+    if (fd_ >= 0) close(fd_);
+    fd_ = -1;
+  }
+
+  virtual uint8_t connected() override {
+    if (fd_ < 0) return 0;
+    // A read of 0 bytes is the end of the stream, after the bytes that have
+    // arrived
+    uint8_t c;
+    ssize_t count = recv(fd_, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    return count > 0 or
+           (count < 0 and (errno == EAGAIN or errno == EWOULDBLOCK));
+  }
+
+  virtual operator bool() override { return fd_ >= 0; }
+
+ private:
+  SocketClient(const SocketClient &) = delete;
+  SocketClient &operator=(const SocketClient &) = delete;
+
+  // A response is sent in a single write, so it isn't held back
+  void setNoDelay() {
+    int on = 1;
+    if (fd_ >= 0) setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+  }
+
+  int fd_;
+};
+
+}  // namespace host
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_HOST_SOCKET_CLIENT_H
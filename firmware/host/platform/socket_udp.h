@@ -0,0 +1,195 @@
+/*! \file socket_udp.h
+ *  \brief UDP on a socket of the host.
+ *  \details As the UDP of the Arduino network libraries, a packet is collected
+ *  between beginPacket and endPacket and sent as one datagram, and parsePacket
+ *  takes the next datagram without blocking.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_HOST_SOCKET_UDP_H
+#define ARDUINO_PIXEL_HOST_SOCKET_UDP_H
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include <Udp.h>
+
+namespace arduino_pixel {
+namespace host {
+
+class SocketUdp : public UDP {
+ public:
+  // The largest datagram
+  static const size_t kMaxPacketSize = 65507;
+
+  SocketUdp()
+      : fd_(-1), input_(kMaxPacketSize), size_(0), position_(0), remote_({}) {}
+
+  virtual ~SocketUdp() { stop(); }
+
+  /**
+   * \brief Opens the socket on a port of the loopback, or of any address.
+   * \param[in] port the port, or 0 for any free port.
+   * \param[in] loopback whether to listen on the loopback only.
+   * \return 1 on success, or 0.
+   */
+  uint8_t begin(uint16_t port, bool loopback) {
+    stop();
+    fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd_ < 0) return 0;
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(loopback ? INADDR_LOOPBACK : INADDR_ANY);
+    if (bind(fd_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) <
+        0) {
+      stop();
+      return 0;
+    }
+    return 1;
+  }
+
+  virtual uint8_t begin(uint16_t port) override { return begin(port, false); }
+
+  virtual void stop() override {
+    if (fd_ >= 0) close(fd_);
+    fd_ = -1;
+  }
+
+  virtual int beginPacket(IPAddress ip, uint16_t port) override {
+    remote_ = {};
+    remote_.sin_family = AF_INET;
+    remote_.sin_port = htons(port);
+    remote_.sin_addr.s_addr =
+        htonl((uint32_t)ip[0] << 24 | (uint32_t)ip[1] << 16 |
+              (uint32_t)ip[2] << 8 | ip[3]);
+    output_.clear();
+    return (fd_ >= 0 or begin(0, false)) ? 1 : 0;
+  }
+
+  virtual int beginPacket(const char *host, uint16_t port) override {
+    in_addr address;
+    if (inet_pton(AF_INET, host, &address) != 1) return 0;
+    uint32_t ip = ntohl(address.s_addr);
+    return beginPacket(IPAddress(ip >> 24, ip >> 16, ip >> 8, ip), port);
+  }
+
+  virtual int endPacket() override {
+    ssize_t sent = sendto(fd_, output_.data(), output_.size(), 0,
+                          reinterpret_cast<sockaddr *>(&remote_),
+                          sizeof(remote_));
+    return (sent == (ssize_t)output_.size()) ? 1 : 0;
+  }
+
+  virtual size_t write(uint8_t c) override { return write(&c, 1); }
+
+  virtual size_t write(const uint8_t *buffer, size_t size) override {
+    if (output_.size() + size > kMaxPacketSize) return 0;
+    output_.insert(output_.end(), buffer, buffer + size);
+    return size;
+  }
+
+  using Print::write;
+
+  virtual int parsePacket() override {
+    position_ = 0;
+    socklen_t length = sizeof(remote_);
+    ssize_t size = (fd_ < 0) ? -1
+                              : recvfrom(fd_, input_.data(), input_.size(),
+                                         MSG_DONTWAIT,
+                                         reinterpret_cast<sockaddr *>(&remote_),
+                                         &length);
+    size_ = (size > 0) ? size : 0;
+    return size_;
+  }
+
+  virtual int available() override { return size_ - position_; }
+
+  virtual int read() override {
+    return (position_ < size_) ? input_[position_++] : -1;
+  }
+
+  virtual int read(unsigned char *buffer, size_t size) override {
+    size_t count = 0;
+    while (count < size and position_ < size_)
+      buffer[count++] = input_[position_++];
+    return count;
+  }
+
+  virtual int read(char *buffer, size_t size) override {
+    return read(reinterpret_cast<unsigned char *>(buffer), size);
+  }
+
+  virtual int peek() override {
+    return (position_ < size_) ? input_[position_] : -1;
+  }
+
+  virtual void flush() override { position_ = size_; }
+
+  virtual IPAddress remoteIP() override {
+    uint32_t ip = ntohl(remote_.sin_addr.s_addr);
+    return IPAddress(ip >> 24, ip >> 16, ip >> 8, ip);
+  }
+
+  virtual uint16_t remotePort() override { return ntohs(remote_.sin_port); }
+
+  /**
+   * \brief Gets the socket, e.g. to poll it, or -1 if it isn't open.
+   */
+  int getSocket() const { return fd_; }
+
+  /**
+   * \brief Gets the port that the socket is bound to, or 0.
+   */
+  uint16_t getLocalPort() const {
+    sockaddr_in address = {};
+    socklen_t length = sizeof(address);
+    if (fd_ < 0 or getsockname(fd_, reinterpret_cast<sockaddr *>(&address),
+                               &length) < 0)
+      return 0;
+    return ntohs(address.sin_port);
+  }
+
+ private:
+  SocketUdp(const SocketUdp &) = delete;
+  SocketUdp &operator=(const SocketUdp &) = delete;
+
+  int fd_;
+  std::vector<uint8_t> input_;
+  size_t size_;  // The size of the last packet
+  size_t position_;
+  std::vector<uint8_t> output_;
+  sockaddr_in remote_;  // The destination, or the source of the last packet
+};
+
+}  // namespace host
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_HOST_SOCKET_UDP_H
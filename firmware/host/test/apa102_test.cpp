@@ -0,0 +1,150 @@
+/*! \file apa102_test.cpp
+ *  \brief Tests the APA102 strip against a recording SPI bus.
+ *  \details The bus of the host keeps every byte that is sent, so the test
+ *  checks the stream on the wire: the start frame, the brightness and the
+ *  channel order of every LED frame, and the end frame.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <host.h>
+
+#include <vector>
+
+#include "led_strip/led_strip_apa102.h"
+#include "modes.h"
+#include "test/test.h"
+
+using namespace arduino_pixel;
+
+namespace {
+
+typedef std::vector<uint8_t> Bytes;
+
+// The bytes of the stream of a strip of 20 LEDs
+const size_t kStartFrame = 4;
+const size_t kEndFrame = 4 + (20 + 15) / 16;
+const size_t kLength = kStartFrame + 4 * 20 + kEndFrame;
+
+Bytes getLedFrame(const Bytes &sent, int idx) {
+  const uint8_t *frame = sent.data() + kStartFrame + 4 * idx;
+  return Bytes(frame, frame + 4);
+}
+
+void checkEndFrame(const Bytes &sent) {
+  for (size_t i = kLength - kEndFrame; i < kLength; ++i)
+    CHECK_EQUAL(sent[i], 0);
+}
+
+void testStream() {
+  SPIClass bus;
+  led_strip::LedStripApa102<> strip(20, 4000000, bus);
+  CHECK(strip.isValid());
+  CHECK_EQUAL(strip.getNumLeds(), 20);
+  strip.init();
+  CHECK_EQUAL(bus.getSettings().getClock(), 4000000u);
+  CHECK_EQUAL(bus.getTransactions(), 1u);
+  const Bytes &sent = bus.getSent();
+  CHECK_EQUAL(sent.size(), kLength);
+  for (size_t i = 0; i < kStartFrame; ++i) CHECK_EQUAL(sent[i], 0);
+  for (int idx = 0; idx < 20; ++idx)  // Full brightness, and black
+    CHECK(getLedFrame(sent, idx) == Bytes({0xFF, 0, 0, 0}));
+  checkEndFrame(sent);
+
+  // The colors are sent in BGR, after the brightness
+  bus.clearSent();
+  strip.setGlobalBrightness(5);
+  strip.setPixel(0, Color(1, 2, 3));
+  strip.setPixel(19, Color(255, 128, 0));
+  strip.show();
+  CHECK_EQUAL(bus.getTransactions(), 2u);  // A single transfer per frame
+  CHECK_EQUAL(sent.size(), kLength);
+  CHECK(getLedFrame(sent, 0) == Bytes({0xE5, 3, 2, 1}));
+  CHECK(getLedFrame(sent, 1) == Bytes({0xE5, 0, 0, 0}));
+  CHECK(getLedFrame(sent, 19) == Bytes({0xE5, 0, 128, 255}));
+  checkEndFrame(sent);
+  Color color = strip.getPixel(19);
+  CHECK(color.red == 255 and color.green == 128 and color.blue == 0);
+
+  strip.setGlobalBrightness(200);  // Clamped to the 5 bits of the field
+  CHECK_EQUAL(strip.getGlobalBrightness(), 31);
+}
+
+void testChannelOrder() {
+  SPIClass bus;
+  led_strip::LedStripApa102<PixelFormat::RGB> strip(20, 8000000, bus);
+  strip.setPixel(2, Color(1, 2, 3));
+  strip.show();
+  CHECK(getLedFrame(bus.getSent(), 2) == Bytes({0xFF, 1, 2, 3}));
+}
+
+void testMode() {
+  SPIClass bus;
+  led_strip::LedStripApa102<> strip(20, 8000000, bus);
+  mode::SingleColor mode(20);
+  mode.setColor(Color(10, 20, 30));
+  strip.setMode(&mode);
+  strip.colorize(true);
+  const Bytes &sent = bus.getSent();
+  CHECK_EQUAL(sent.size(), kLength);
+  for (int idx = 0; idx < 20; ++idx)
+    CHECK(getLedFrame(sent, idx) == Bytes({0xFF, 30, 20, 10}));
+}
+
+void testEndFrame() {
+  // Half a clock edge per LED, i.e. a byte for every 16 LEDs
+  const int num_leds[] = {1, 16, 17, 300};
+  const size_t end_frames[] = {5, 5, 6, 23};
+  for (int i = 0; i < 4; ++i) {
+    SPIClass bus;
+    led_strip::LedStripApa102<> strip(num_leds[i], 8000000, bus);
+    strip.show();
+    CHECK_EQUAL(bus.getSent().size(), 4 + 4 * num_leds[i] + end_frames[i]);
+  }
+}
+
+void testAllocationFailure() {
+  SPIClass bus;
+  setHeapLimit(getHeapUsed() + 1000);  // Less than 4 bytes per LED
+  led_strip::LedStripApa102<> strip(1000, 8000000, bus);
+  setHeapLimit(0);
+  CHECK(not strip.isValid());
+  CHECK_EQUAL(strip.getNumLeds(), 0);  // So the modes draw nothing
+  strip.setGlobalBrightness(3);
+  strip.init();
+  CHECK_EQUAL(bus.getSent().size(), 0u);
+  CHECK_EQUAL(bus.getTransactions(), 0u);
+}
+
+}  // namespace
+
+int main() {
+  testStream();
+  testChannelOrder();
+  testMode();
+  testEndFrame();
+  testAllocationFailure();
+  return TEST_RESULT();
+}
@@ -0,0 +1,76 @@
+#!/usr/bin/python3
+
+"""Runs arduino_pixel_batch against arduino_pixel_serve on the loopback.
+
+The requests to the server share connections that the server keeps alive,
+one after the other and pipelined, unless the client asks for a connection
+per request. The connections that the client reports are checked against
+the ones that the server has accepted.
+"""
+
+import os
+import re
+import signal
+import subprocess
+import sys
+import tempfile
+
+COMMANDS = '''put /strip/status/on
+put /strip/mode SCANNER 40
+get /strip/mode
+put /strip/color {"r":1,"g":2,"b":3,"period":20}
+get /strip/color
+'''
+
+# The server closes a connection after 32 requests
+KEEPALIVE_REQUESTS = 32
+
+
+def batch(client, path, port, *options):
+    """Runs the client, and returns the requests and the connections of its
+    summary."""
+    output = subprocess.check_output(
+        [sys.executable, client, path, '-u', '127.0.0.1:%d' % port] +
+        list(options), universal_newlines=True, timeout=60)
+    summary = output.strip().splitlines()[-1]
+    print(' '.join(options) or 'keep-alive', '->', summary)
+    match = re.match(r'(\d+) requests, 0 failed, (\d+) connections', summary)
+    if not match: sys.exit('Error: Failed requests: ' + summary)
+    if 'SCANNER' not in output or '{"r":1,"g":2,"b":3}' not in output:
+        sys.exit('Error: Unexpected responses:\n' + output)
+    return int(match.group(1)), int(match.group(2))
+
+
+def main():
+    if len(sys.argv) != 3: sys.exit('Usage: %s SERVE BATCH' % sys.argv[0])
+    serve, client = sys.argv[1:]
+    server = subprocess.Popen([serve, '-p', '0'], stdout=subprocess.PIPE,
+                              universal_newlines=True)
+    try:
+        port = int(server.stdout.readline().split()[1])
+        with tempfile.TemporaryDirectory() as directory:
+            path = os.path.join(directory, 'commands.txt')
+            with open(path, 'w') as f: f.write(COMMANDS * 10)
+            requests = 10 * len(COMMANDS.splitlines())
+            kept = -(-requests // KEEPALIVE_REQUESTS)
+            expected = [((), kept), (('-p', '8'), kept), (('-k',), requests)]
+            total = 0
+            for options, connections in expected:
+                counts = batch(client, path, port, *options)
+                if counts != (requests, connections):
+                    sys.exit('Error: Expected %d requests on %d connections, '
+                             'got %d on %d' %
+                             ((requests, connections) + counts))
+                total += connections
+    finally:
+        server.send_signal(signal.SIGTERM)
+        output = server.communicate(timeout=10)[0]
+    accepted = int(output.split()[-1])
+    if accepted != total:
+        sys.exit('Error: The server accepted %d connections, instead of %d' %
+                 (accepted, total))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
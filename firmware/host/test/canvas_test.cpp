@@ -0,0 +1,141 @@
+/*! \file canvas_test.cpp
+ *  \brief Tests the canvas mode.
+ *  \details The pixels of a canvas are taken from the scratch arena, or from
+ *  the heap when they do not fit in it. A canvas the heap can not hold is
+ *  rejected, and the mode stays as it is.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <host.h>
+
+#include "arduino_pixel_server.h"
+#include "led_strip/led_strip_neopixel.h"
+#include "test/mock_client.h"
+#include "test/test.h"
+
+using namespace arduino_pixel;
+
+namespace {
+
+class TestServer : public ArduinoPixelServer {
+ public:
+  using ArduinoPixelServer::init;
+  using ArduinoPixelServer::getState;
+  using ArduinoPixelServer::setState;
+
+  /**
+   * \brief Renders the state after the changes to it.
+   */
+  void render() {
+    Clock::advance(ARDUINO_PIXEL_FRAME_INTERVAL);
+    colorize();
+  }
+
+  /**
+   * \brief Sends a request.
+   * \return The status line of the response.
+   */
+  std::string request(const char *method, const char *path,
+                      const std::string &data = "") {
+    test::MockClient client(test::formatRequest(method, path, data));
+    processRequest(client);
+    const std::string &output = client.getOutput();
+    return output.substr(0, output.find("\r\n"));
+  }
+};
+
+bool isOk(const std::string &status) {
+  return status.find("200 OK") != std::string::npos;
+}
+
+bool hasColor(const led_strip::LedStripBase &strip, int idx,
+              const Color &color) {
+  Color pixel = strip.getPixel(idx);
+  return pixel.red == color.red and pixel.green == color.green and
+         pixel.blue == color.blue;
+}
+
+void testArena() {
+  Clock::setTime(0);
+  led_strip::LedStripNeoPixel strip(30, 6, NEO_GRB + NEO_KHZ800);
+  TestServer server;
+  server.init(&strip);
+  server.request("PUT", "/strip/status/on");
+  size_t heap_used = getHeapUsed();
+  CHECK(isOk(server.request("PUT", "/strip/pixels", "[[3,255,0,0]]")));
+  CHECK_EQUAL(server.getState().mode, Mode::CANVAS);
+  CHECK_EQUAL(ScratchArena::getUsed(), 92u);  // 30 pixels, word aligned
+  CHECK(getHeapUsed() - heap_used < 30 * sizeof(Color));
+  server.render();
+  CHECK(hasColor(strip, 2, Color(0, 0, 0)));
+  CHECK(hasColor(strip, 3, Color(255, 0, 0)));
+}
+
+void testHeap() {
+  Clock::setTime(0);
+  const int num_leds = ScratchArena::kCapacity / sizeof(Color) + 1;
+  led_strip::LedStripNeoPixel strip(num_leds, 6, NEO_GRB + NEO_KHZ800);
+  TestServer server;
+  server.init(&strip);
+  server.request("PUT", "/strip/status/on");
+  CHECK(isOk(server.request("PUT", "/strip/pixels", "[[3,255,0,0]]")));
+  CHECK_EQUAL(server.getState().mode, Mode::CANVAS);
+  CHECK_EQUAL(ScratchArena::getUsed(), 0u);
+  server.render();
+  CHECK(hasColor(strip, num_leds - 1, Color(0, 0, 0)));
+  CHECK(hasColor(strip, 3, Color(255, 0, 0)));
+}
+
+void testAllocationFailure() {
+  Clock::setTime(0);
+  const int num_leds = ScratchArena::kCapacity / sizeof(Color) + 1;
+  led_strip::LedStripNeoPixel strip(num_leds, 6, NEO_GRB + NEO_KHZ800);
+  TestServer server;
+  server.init(&strip);
+  server.request("PUT", "/strip/status/on");
+  CHECK(isOk(server.request("PUT", "/strip/mode", "SCANNER")));
+  setHeapLimit(getHeapUsed() + 1000);  // Less than 3 bytes per LED
+  std::string status = server.request("PUT", "/strip/pixels", "[[3,255,0,0]]");
+  CHECK(status.find("400") != std::string::npos);
+  CHECK_EQUAL(server.getState().mode, Mode::SCANNER);
+
+  // A stored canvas falls back to a single color
+  DeviceState state = server.getState();
+  state.mode = Mode::CANVAS;
+  server.setState(state);
+  setHeapLimit(0);
+  CHECK_EQUAL(server.getState().mode, Mode::SINGLE_COLOR);
+  server.render();
+}
+
+}  // namespace
+
+int main() {
+  testArena();
+  testHeap();
+  testAllocationFailure();
+  return TEST_RESULT();
+}
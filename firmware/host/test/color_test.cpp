@@ -0,0 +1,206 @@
+/*! \file color_test.cpp
+ *  \brief Tests the color requests.
+ *  \details A period rebuilds an animated mode, and leaves a canvas or a stream
+ *  as they are. Mutations of valid requests are rejected or applied, but never
+ *  crash the server.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+
+#include "arduino_pixel_server.h"
+#include "led_strip/led_strip_neopixel.h"
+#include "test/mock_client.h"
+#include "test/mock_udp.h"
+#include "test/test.h"
+
+using namespace arduino_pixel;
+
+namespace {
+
+const int kNumLeds = 30;
+
+class TestServer : public ArduinoPixelServer {
+ public:
+  using ArduinoPixelServer::init;
+  using ArduinoPixelServer::getState;
+
+  /**
+   * \brief Renders the state after the changes to it.
+   */
+  void render() {
+    Clock::advance(ARDUINO_PIXEL_FRAME_INTERVAL);
+    colorize();
+  }
+
+  /**
+   * \brief Sends a request.
+   * \return The status line of the response.
+   */
+  std::string request(const char *method, const char *path,
+                      const std::string &data = "") {
+    test::MockClient client(test::formatRequest(method, path, data));
+    processRequest(client);
+    const std::string &output = client.getOutput();
+    return output.substr(0, output.find("\r\n"));
+  }
+};
+
+bool isOk(const std::string &status) {
+  return status.find("200 OK") != std::string::npos;
+}
+
+/**
+ * \brief Formats a stream packet that completes a frame.
+ */
+std::string formatFrame(uint16_t sequence, const Color &color) {
+  std::string packet = {'A', 'P', (char)StreamPacket::kVersion,
+                        (char)StreamPacket::kLastPacket};
+  packet += {(char)(sequence & 0xFF), (char)(sequence >> 8), 0, 0,
+             (char)(kNumLeds & 0xFF), (char)(kNumLeds >> 8)};
+  for (int i = 0; i < kNumLeds; ++i)
+    packet += {(char)color.red, (char)color.green, (char)color.blue};
+  return packet;
+}
+
+bool hasColor(const led_strip::LedStripBase &strip, int idx,
+              const Color &color) {
+  Color pixel = strip.getPixel(idx);
+  return pixel.red == color.red and pixel.green == color.green and
+         pixel.blue == color.blue;
+}
+
+void testPeriod() {
+  Clock::setTime(0);
+  led_strip::LedStripNeoPixel strip(kNumLeds, 6, NEO_GRB + NEO_KHZ800);
+  TestServer server;
+  server.init(&strip);
+  server.request("PUT", "/strip/status/on");
+  CHECK(isOk(server.request("PUT", "/strip/mode", "SCANNER")));
+  CHECK(isOk(server.request("PUT", "/strip/color",
+                            "{\"r\":1,\"g\":2,\"b\":3,\"period\":40}")));
+  DeviceState state = server.getState();
+  CHECK_EQUAL(state.mode, Mode::SCANNER);
+  CHECK_EQUAL(state.period, 40u);
+  CHECK_EQUAL(state.colors[0].blue, 3);
+}
+
+void testCanvas() {
+  Clock::setTime(0);
+  led_strip::LedStripNeoPixel strip(kNumLeds, 6, NEO_GRB + NEO_KHZ800);
+  TestServer server;
+  server.init(&strip);
+  server.request("PUT", "/strip/status/on");
+  // 10 LEDs from the 5th in red
+  CHECK(isOk(server.request("PUT", "/strip/pixels", "05000A00FF0000")));
+  server.render();
+  CHECK(hasColor(strip, 5, Color(255, 0, 0)));
+
+  // The period is ignored, and the canvas keeps its pixels
+  CHECK(isOk(server.request("PUT", "/strip/color", "{\"period\":40}")));
+  CHECK(isOk(server.request("PUT", "/strip/color",
+                            "{\"r\":0,\"g\":0,\"b\":0,\"period\":40}")));
+  server.render();
+  CHECK_EQUAL(server.getState().mode, Mode::CANVAS);
+  CHECK_EQUAL(server.getState().period, 0u);
+  CHECK(hasColor(strip, 5, Color(255, 0, 0)));
+  CHECK(hasColor(strip, 14, Color(255, 0, 0)));
+}
+
+void testStream() {
+  Clock::setTime(0);
+  led_strip::LedStripNeoPixel strip(kNumLeds, 6, NEO_GRB + NEO_KHZ800);
+  TestServer server;
+  test::MockUdp udp;
+  server.init(&strip);
+  server.request("PUT", "/strip/status/on");
+  CHECK(isOk(server.request("PUT", "/strip/mode", "STREAM")));
+  server.render();
+
+  // A frame arrives before a color request, and is shown after it
+  udp.receive(formatFrame(0, Color(0, 255, 0)));
+  server.processPacket(udp);
+  CHECK(isOk(server.request("PUT", "/strip/color", "{\"period\":40}")));
+  server.render();
+  CHECK_EQUAL(server.getState().mode, Mode::STREAM);
+  CHECK(hasColor(strip, 0, Color(0, 255, 0)));
+
+  // The sequence of the stream carries on
+  udp.receive(formatFrame(1, Color(0, 0, 255)));
+  server.processPacket(udp);
+  server.render();
+  CHECK(hasColor(strip, kNumLeds - 1, Color(0, 0, 255)));
+}
+
+void testMutations() {
+  const std::string requests[] = {
+      "{\"r\":1,\"g\":2,\"b\":3}",
+      "{\"colors\":[{\"r\":1,\"g\":2,\"b\":3},{\"r\":4,\"g\":5,\"b\":6}],"
+      "\"period\":20,\"brightness\":128}",
+      "{\"period\":65535,\"brightness\":0}",
+  };
+  const char characters[] = "{}[]\":,-.0123456789eEtrufalsn \\";
+  const char *modes[] = {"SCANNER", "CANVAS", "GRADIENT_SCROLL"};
+
+  Clock::setTime(0);
+  led_strip::LedStripNeoPixel strip(kNumLeds, 6, NEO_GRB + NEO_KHZ800);
+  TestServer server;
+  server.init(&strip);
+  server.request("PUT", "/strip/status/on");
+  srand(1);
+  int applied = 0;
+  for (int i = 0; i < 3000; ++i) {
+    if (i % 1000 == 0)
+      server.request("PUT", "/strip/mode", modes[i / 1000]);
+    std::string data = requests[i % 3];
+    for (int j = rand() % 4; j >= 0; --j) {
+      size_t pos = rand() % data.size();
+      char c = characters[rand() % (sizeof(characters) - 1)];
+      switch (rand() % 3) {
+        case 0: data[pos] = c; break;
+        case 1: data.insert(pos, 1, c); break;
+        default: data.erase(pos, 1);
+      }
+      if (data.empty()) data = "{";
+    }
+    if (isOk(server.request("PUT", "/strip/color", data))) ++applied;
+    Clock::advance(10);
+    server.render();
+  }
+  // Some mutations, e.g. of a digit, are still valid
+  CHECK(applied > 0);
+  CHECK_EQUAL(server.getState().mode, Mode::GRADIENT_SCROLL);
+}
+
+}  // namespace
+
+int main() {
+  testPeriod();
+  testCanvas();
+  testStream();
+  testMutations();
+  return TEST_RESULT();
+}
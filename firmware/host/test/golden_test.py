@@ -0,0 +1,35 @@
+#!/usr/bin/python3
+
+"""Compares a simulated recording of a mode with its golden recording.
+
+The mode is recorded with arduino_pixel_simulate, and compared frame by
+frame with arduino_pixel_replay --compare. With ARDUINO_PIXEL_UPDATE_GOLDEN
+set, the golden recording is replaced instead, e.g. after a deliberate
+change of a mode.
+"""
+
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+
+def main():
+    if len(sys.argv) < 4:
+        sys.exit('Usage: %s SIMULATE REPLAY GOLDEN [SIMULATE ARGS...]' %
+                 sys.argv[0])
+    simulate, replay, golden = sys.argv[1:4]
+    with tempfile.TemporaryDirectory() as directory:
+        recording = os.path.join(directory, os.path.basename(golden))
+        subprocess.check_call([simulate, '-o', recording] + sys.argv[4:])
+        if os.environ.get('ARDUINO_PIXEL_UPDATE_GOLDEN'):
+            shutil.copyfile(recording, golden)
+            print('Updated %s' % golden)
+            return 0
+        return subprocess.call([sys.executable, replay, recording,
+                                '--compare', golden])
+
+
+if __name__ == '__main__':
+    sys.exit(main())
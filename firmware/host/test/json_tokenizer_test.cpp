@@ -0,0 +1,141 @@
+/*! \file json_tokenizer_test.cpp
+ *  \brief Tests the json tokenizer on valid, invalid, and random text.
+ *  \details Random text and mutations of valid documents must either fail or
+ *  give tokens that stay in the text, and never read past its end.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+
+#include <string>
+#include <vector>
+
+#include "json_tokenizer.h"
+#include "test/test.h"
+
+using namespace arduino_pixel;
+
+namespace {
+
+/**
+ * \brief Tokenizes a text and checks the structure of the tokens.
+ * \details The text is copied without a terminator, so that a read past its
+ * end is caught by a sanitizer.
+ * \return The result of tokenize.
+ */
+int tokenize(const std::string &json, byte max_tokens = 16) {
+  std::vector<char> text(json.begin(), json.end());
+  JsonToken tokens[255];
+  JsonTokenizer tokenizer(text.data(), text.size(), tokens, max_tokens);
+  int count = tokenizer.tokenize();
+  if (count < 0) return count;
+  CHECK(count > 0 and count <= max_tokens);
+  CHECK_EQUAL(tokens[0].next, count);
+  for (int i = 0; i < count; ++i) {
+    if (not CHECK(tokens[i].start <= tokens[i].end and
+                  tokens[i].end <= json.size() and tokens[i].next > i and
+                  tokens[i].next <= count))
+      break;
+  }
+  return count;
+}
+
+void testValid() {
+  CHECK_EQUAL(tokenize("{\"r\":48,\"g\":254,\"b\":176}"), 7);
+  CHECK_EQUAL(tokenize(" [1, -2.5e3, \"a\\\"b\", true, null] "), 6);
+  CHECK_EQUAL(tokenize("{\"a\":{\"b\":[{}]}}"), 6);
+  CHECK_EQUAL(tokenize("\"\\u00e9\""), 1);
+}
+
+void testInvalid() {
+  const char *texts[] = {"",       "{",        "{\"a\"}",   "{\"a\":}",
+                         "[1,]",   "[1 2]",    "\"abc",     "\"\\x\"",
+                         "\"\\u12\"", "-",         "1.",
+                         "tru",    "{} {}",    "{\"a\":1,}", "[[[[[1]]]]]"};
+  for (const char *text : texts)
+    if (not CHECK(tokenize(text) < 0)) fprintf(stderr, "  %s\n", text);
+
+  // Deep nesting stops at the maximum depth, rather than the stack
+  CHECK(tokenize(std::string(10000, '[') + std::string(10000, ']')) < 0);
+  // A document with too many tokens fails
+  CHECK(tokenize("[1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16]") < 0);
+  CHECK_EQUAL(tokenize("[1,2,3,4,5,6,7,8,9,10,11,12,13,14,15]"), 16);
+}
+
+void testRandom() {
+  const char characters[] = "{}[]\":,-+.0123456789eEtrufalsn \t\\/x";
+  srand(1);
+  for (int i = 0; i < 20000; ++i) {
+    std::string text;
+    for (int length = rand() % 24; length > 0; --length)
+      text += characters[rand() % (sizeof(characters) - 1)];
+    tokenize(text);
+  }
+  // Arbitrary bytes, including the terminator
+  for (int i = 0; i < 20000; ++i) {
+    std::string text;
+    for (int length = rand() % 24; length > 0; --length)
+      text += (char)(rand() % 256);
+    tokenize(text);
+  }
+}
+
+void testMutations() {
+  const std::string documents[] = {
+      "{\"colors\":[{\"r\":1,\"g\":2,\"b\":3},{\"r\":4,\"g\":5,\"b\":6}],"
+      "\"period\":20,\"brightness\":128}",
+      "{\"a\":[true,false,null,-0.5e-3,\"\\u0041\\n\"],\"b\":{\"c\":{}}}",
+  };
+  const char characters[] = "{}[]\":,-.0123456789eEtrufalsn \\";
+  srand(2);
+  int valid = 0;
+  for (int i = 0; i < 50000; ++i) {
+    std::string text = documents[i % 2];
+    for (int j = rand() % 4; j >= 0; --j) {
+      if (text.empty()) break;
+      size_t pos = rand() % text.size();
+      char c = characters[rand() % (sizeof(characters) - 1)];
+      switch (rand() % 4) {
+        case 0: text[pos] = c; break;
+        case 1: text.insert(pos, 1, c); break;
+        case 2: text.erase(pos, 1); break;
+        default: text.resize(pos);  // A truncated body
+      }
+    }
+    if (tokenize(text, 32) >= 0) ++valid;
+  }
+  CHECK(valid > 0);
+}
+
+}  // namespace
+
+int main() {
+  testValid();
+  testInvalid();
+  testRandom();
+  testMutations();
+  return TEST_RESULT();
+}
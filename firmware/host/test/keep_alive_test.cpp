@@ -0,0 +1,142 @@
+/*! \file keep_alive_test.cpp
+ *  \brief Tests the connections that are kept alive.
+ *  \details A client that asks for it sends a number of requests on a
+ *  connection, one after the other or pipelined, and the data of every request
+ *  are bounded by its Content-Length.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "arduino_pixel_server.h"
+#include "led_strip/led_strip_neopixel.h"
+#include "test/mock_client.h"
+#include "test/test.h"
+
+using namespace arduino_pixel;
+
+namespace {
+
+const char *kKeepAlive = "Connection: keep-alive\r\n";
+
+class TestServer : public ArduinoPixelServer {
+ public:
+  using ArduinoPixelServer::init;
+};
+
+int count(const std::string &text, const std::string &part) {
+  int n = 0;
+  for (size_t pos = text.find(part); pos != std::string::npos;
+       pos = text.find(part, pos + part.size()))
+    ++n;
+  return n;
+}
+
+struct Fixture {
+  Fixture() : strip(30, 6, NEO_GRB + NEO_KHZ800) {
+    Clock::setTime(0);
+    server.init(&strip);
+  }
+
+  led_strip::LedStripNeoPixel strip;
+  TestServer server;
+};
+
+void testClose() {
+  Fixture fixture;
+  test::MockClient client(test::formatRequest("GET", "/strip/status"));
+  fixture.server.processRequest(client);
+  CHECK(client.getOutput().find("Connection: close") != std::string::npos);
+  CHECK(not client.isOpen());
+}
+
+void testPipelined() {
+  Fixture fixture;
+  // The data of the first request are followed by the next request
+  test::MockClient client(
+      test::formatRequest("PUT", "/strip/mode", "SCANNER", kKeepAlive) +
+      test::formatRequest("GET", "/strip/mode", "", kKeepAlive) +
+      test::formatRequest("PUT", "/strip/status/on", "",
+                          "connection: Keep-Alive\r\n"));
+  client.hangUp();
+  fixture.server.processRequest(client);
+  const std::string &output = client.getOutput();
+  CHECK_EQUAL(count(output, "HTTP/1.1 200 OK"), 3);
+  CHECK_EQUAL(count(output, "Connection: keep-alive"), 3);
+  CHECK(output.find("\r\n\r\nSCANNER") != std::string::npos);
+  CHECK(not client.isOpen());  // Closed after the peer hung up
+
+  test::MockClient status(test::formatRequest("GET", "/strip/status"));
+  fixture.server.processRequest(status);
+  CHECK_EQUAL(status.getBody(), std::string("ON"));
+}
+
+void testLater() {
+  Fixture fixture;
+  test::MockClient client(
+      test::formatRequest("PUT", "/strip/status/on", "", kKeepAlive));
+  fixture.server.processRequest(client);
+  // Nothing followed within the timeout
+  CHECK_EQUAL(count(client.getOutput(), "HTTP/1.1 200 OK"), 1);
+  CHECK(not client.isOpen());
+}
+
+void testLimit() {
+  Fixture fixture;
+  std::string requests;
+  for (int i = 0; i < ARDUINO_PIXEL_KEEPALIVE_REQUESTS + 8; ++i)
+    requests += test::formatRequest("GET", "/strip/status", "", kKeepAlive);
+  test::MockClient client(requests);
+  fixture.server.processRequest(client);
+  const std::string &output = client.getOutput();
+  CHECK_EQUAL(count(output, "HTTP/1.1 200 OK"),
+              ARDUINO_PIXEL_KEEPALIVE_REQUESTS);
+  // The last response closes the connection
+  CHECK_EQUAL(count(output, "Connection: keep-alive"),
+              ARDUINO_PIXEL_KEEPALIVE_REQUESTS - 1);
+  CHECK_EQUAL(count(output, "Connection: close"), 1);
+  CHECK(not client.isOpen());
+}
+
+void testTruncated() {
+  Fixture fixture;
+  std::string request =
+      test::formatRequest("PUT", "/strip/mode", "RAINBOW", kKeepAlive);
+  test::MockClient client(request.substr(0, request.size() - 3));
+  client.hangUp();
+  fixture.server.processRequest(client);
+  CHECK(client.getOutput().find("Connection: close") != std::string::npos);
+  CHECK(not client.isOpen());
+}
+
+}  // namespace
+
+int main() {
+  testClose();
+  testPipelined();
+  testLater();
+  testLimit();
+  testTruncated();
+  return TEST_RESULT();
+}
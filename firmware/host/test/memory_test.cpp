@@ -0,0 +1,161 @@
+/*! \file memory_test.cpp
+ *  \brief Accounts for the heap that every LED takes.
+ *  \details The heap of a strip that shows a mode is measured at two lengths,
+ *  and the difference is the cost of an LED. The strips are longer than the
+ *  scratch arena, so the working memory of the modes is on the heap, as on AVR,
+ *  where the arena is 64 bytes. The costs are compared with those of the
+ *  baseline, whose animated modes kept a copy of the pixels, and with the
+ *  figures of the README.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <host.h>
+
+#include "led_strip/led_strip_neopixel.h"
+#include "modes.h"
+#include "platform/mode_factory.h"
+#include "test/test.h"
+
+using namespace arduino_pixel;
+
+namespace {
+
+const int kShortStrip = 3000;
+const int kLongStrip = 6000;
+const int kWidth = 60;  // Of a matrix of either length
+const int kDriverBytes = 3;  // The buffer of the NeoPixel driver, RGB
+
+enum Option { NONE, INTERPOLATION, POWER_LIMIT, MATRIX };
+
+Animation animation;
+Program program;
+SamplerAnalog sampler(0, 8000);
+
+mode::ModeBase *createMode(Mode type, int num_leds) {
+  switch (type) {
+    case Mode::STREAM:
+      return new mode::FrameStream(num_leds);
+    case Mode::PLAYBACK:
+      return new mode::Playback(num_leds, animation, 0);
+    case Mode::SCRIPT:
+      return new mode::Script(num_leds, program, 0);
+    case Mode::SPECTRUM:
+      return new mode::Spectrum(num_leds, sampler, 20);
+    default:
+      return host::createMode(type, num_leds, 0);
+  }
+}
+
+/**
+ * \brief Measures the heap of a strip that shows a mode.
+ * \return The number of bytes.
+ */
+size_t measureHeap(Mode type, Option option, int num_leds) {
+  size_t before = getHeapUsed();
+  led_strip::LedStripNeoPixel strip(num_leds, 6, NEO_GRB + NEO_KHZ800);
+  strip.init();
+  switch (option) {
+    case INTERPOLATION:
+      CHECK(strip.setInterpolation(20));
+      break;
+    case POWER_LIMIT:
+      CHECK(strip.setPowerLimit(4000));
+      break;
+    case MATRIX:
+      CHECK(strip.setMatrix(kWidth, num_leds / kWidth, true));
+      break;
+    default:
+      break;
+  }
+  ScratchArena::reset();
+  mode::ModeBase *mode = createMode(type, num_leds);
+  mode->init();
+  strip.setMode(mode);
+  strip.colorize(true);
+  size_t used = getHeapUsed() - before;
+  delete mode;
+  return used;
+}
+
+/**
+ * \brief Measures the heap of an LED.
+ * \return The number of bytes.
+ */
+long measureLed(Mode type, Option option = NONE) {
+  long difference = (long)measureHeap(type, option, kLongStrip) -
+                    (long)measureHeap(type, option, kShortStrip);
+  CHECK_EQUAL(difference % (kLongStrip - kShortStrip), 0);
+  return difference / (kLongStrip - kShortStrip);
+}
+
+struct ModeCost {
+  Mode mode;
+  int baseline;  // The bytes of an LED at the baseline, -1 if it was absent
+  int bytes;     // The bytes of an LED now, besides the driver
+};
+
+// The baseline kept a Color[num_leds] copy in every animated mode
+const ModeCost mode_costs[] = {
+    {Mode::SINGLE_COLOR, 0, 0},   {Mode::SCANNER, 3, 0},
+    {Mode::RAINBOW, 3, 0},        {Mode::RAINBOW_CYCLE, 3, 0},
+    {Mode::GRADIENT, -1, 0},      {Mode::GRADIENT_SCROLL, -1, 0},
+    {Mode::STREAM, -1, 0},        {Mode::PLAYBACK, -1, 0},
+    {Mode::SCRIPT, -1, 0},        {Mode::CANVAS, -1, 3},
+    {Mode::NOISE, -1, 0},         {Mode::FIRE, -1, 1},
+    {Mode::TWINKLE, -1, 0},       {Mode::SPECTRUM, -1, 0},
+};
+
+}  // namespace
+
+int main() {
+  printf("%-16s %8s %8s %8s\n", "mode", "baseline", "now", "ratio");
+  for (const ModeCost &cost : mode_costs) {
+    long bytes = measureLed(cost.mode) - kDriverBytes;
+    const char *name = reinterpret_cast<const char *>(toString(cost.mode));
+    CHECK_EQUAL(bytes, cost.bytes);
+    if (cost.baseline < 0) {
+      printf("%-16s %8s %8ld\n", name, "-", kDriverBytes + bytes);
+      continue;
+    }
+    // The LEDs that fit in the same memory grow by the ratio
+    double ratio = (double)(kDriverBytes + cost.baseline) /
+                   (kDriverBytes + bytes);
+    printf("%-16s %8d %8ld %8.2f\n", name, kDriverBytes + cost.baseline,
+           kDriverBytes + bytes, ratio);
+    if (cost.baseline) CHECK(ratio >= 1.5);
+  }
+
+  // The options of the strip cost the same with any mode
+  long interpolation = measureLed(Mode::SCANNER, INTERPOLATION) - kDriverBytes;
+  long power_limit = measureLed(Mode::SCANNER, POWER_LIMIT) - kDriverBytes;
+  long matrix = measureLed(Mode::SCANNER, MATRIX) - kDriverBytes;
+  printf("interpolation +%ld, power limit +%ld, matrix +%ld\n", interpolation,
+         power_limit, matrix);
+  CHECK_EQUAL(interpolation, 6);
+  CHECK_EQUAL(power_limit, 1);
+  CHECK_EQUAL(matrix, 2);
+  return TEST_RESULT();
+}
@@ -0,0 +1,136 @@
+/*! \file mock_client.h
+ *  \brief Client of the tests that holds a request and collects the response.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_HOST_MOCK_CLIENT_H
+#define ARDUINO_PIXEL_HOST_MOCK_CLIENT_H
+
+#include <Client.h>
+
+#include <string>
+
+namespace arduino_pixel {
+namespace test {
+
+/**
+ * \brief Formats an http request, as the command line client sends it.
+ * \param[in] method the method, e.g. "PUT".
+ * \param[in] path the path, e.g. "/strip/mode".
+ * \param[in] data the data, which are sent as the form field "arg".
+ * \param[in] headers more headers, each ending in "\r\n".
+ * \return The request.
+ */
+inline std::string formatRequest(const std::string &method,
+                                 const std::string &path,
+                                 const std::string &data = "",
+                                 const std::string &headers = "") {
+  std::string body = data.empty() ? "" : "arg=" + data;
+  return method + " " + path + " HTTP/1.1\r\nHost: localhost\r\n" + headers +
+         "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+}
+
+class MockClient : public Client {
+ public:
+  explicit MockClient(const std::string &input = "")
+      : input_(input),
+        position_(0),
+        open_(true),
+        hung_up_(false),
+        writes_(0) {}
+
+  virtual int connect(IPAddress ip, uint16_t port) override { return 1; }
+  virtual int connect(const char *host, uint16_t port) override { return 1; }
+  virtual size_t write(uint8_t c) override { return write(&c, 1); }
+  virtual size_t write(const uint8_t *buffer, size_t size) override {
+    if (not open_) return 0;
+    output_.append(reinterpret_cast<const char *>(buffer), size);
+    ++writes_;
+    return size;
+  }
+  using Print::write;
+  virtual int available() override { return input_.size() - position_; }
+  virtual int read() override {
+    return (position_ < input_.size()) ? (uint8_t)input_[position_++] : -1;
+  }
+  virtual int read(uint8_t *buffer, size_t size) override {
+    size_t count = 0;
+    while (count < size and position_ < input_.size())
+      buffer[count++] = input_[position_++];
+    return count;
+  }
+  virtual int peek() override {
+    return (position_ < input_.size()) ? (uint8_t)input_[position_] : -1;
+  }
+  virtual void flush() override {}
+  virtual void stop() override { open_ = false; }
+  // As on a socket, the input can be read after the peer has hung up
+  virtual uint8_t connected() override {
+    return open_ and (not hung_up_ or available());
+  }
+  virtual operator bool() override { return open_; }
+
+  /**
+   * \brief Adds bytes to the input, e.g. a request that arrives later.
+   */
+  void receive(const std::string &input) { input_ += input; }
+  /**
+   * \brief Closes the connection from the side of the peer.
+   */
+  void hangUp() { hung_up_ = true; }
+  /**
+   * \brief Tells whether the connection has been closed by the server.
+   */
+  bool isOpen() const { return open_; }
+  /**
+   * \brief Gets the bytes that have been written.
+   */
+  const std::string &getOutput() const { return output_; }
+  /**
+   * \brief Gets the body of the first response.
+   */
+  std::string getBody() const {
+    size_t start = output_.find("\r\n\r\n");
+    return (start == std::string::npos) ? "" : output_.substr(start + 4);
+  }
+  /**
+   * \brief Gets the number of writes.
+   */
+  int getWrites() const { return writes_; }
+
+ private:
+  std::string input_;
+  size_t position_;
+  std::string output_;
+  bool open_;
+  bool hung_up_;
+  int writes_;
+};
+
+}  // namespace test
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_HOST_MOCK_CLIENT_H
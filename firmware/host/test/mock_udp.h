@@ -0,0 +1,110 @@
+/*! \file mock_udp.h
+ *  \brief UDP of the tests that holds received packets and collects sent ones.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_HOST_MOCK_UDP_H
+#define ARDUINO_PIXEL_HOST_MOCK_UDP_H
+
+#include <Udp.h>
+
+#include <string>
+#include <vector>
+
+namespace arduino_pixel {
+namespace test {
+
+class MockUdp : public UDP {
+ public:
+  MockUdp() : next_(0), position_(0) {}
+
+  virtual uint8_t begin(uint16_t port) override { return 1; }
+  virtual void stop() override {}
+  virtual int beginPacket(IPAddress ip, uint16_t port) override {
+    sent_.push_back(std::string());
+    return 1;
+  }
+  virtual int beginPacket(const char *host, uint16_t port) override {
+    sent_.push_back(std::string());
+    return 1;
+  }
+  virtual int endPacket() override { return 1; }
+  virtual size_t write(uint8_t c) override { return write(&c, 1); }
+  virtual size_t write(const uint8_t *buffer, size_t size) override {
+    if (sent_.empty()) return 0;
+    sent_.back().append(reinterpret_cast<const char *>(buffer), size);
+    return size;
+  }
+  using Print::write;
+  virtual int parsePacket() override {
+    current_.clear();
+    position_ = 0;
+    if (next_ == received_.size()) return 0;
+    current_ = received_[next_++];
+    return current_.size();
+  }
+  virtual int available() override { return current_.size() - position_; }
+  virtual int read() override {
+    return (position_ < current_.size()) ? (uint8_t)current_[position_++]
+                                         : -1;
+  }
+  virtual int read(unsigned char *buffer, size_t size) override {
+    size_t count = 0;
+    while (count < size and position_ < current_.size())
+      buffer[count++] = current_[position_++];
+    return count;
+  }
+  virtual int read(char *buffer, size_t size) override {
+    return read(reinterpret_cast<unsigned char *>(buffer), size);
+  }
+  virtual int peek() override {
+    return (position_ < current_.size()) ? (uint8_t)current_[position_] : -1;
+  }
+  virtual void flush() override { position_ = current_.size(); }
+  virtual IPAddress remoteIP() override { return IPAddress(127, 0, 0, 1); }
+  virtual uint16_t remotePort() override { return 0; }
+
+  /**
+   * \brief Queues a packet for parsePacket.
+   */
+  void receive(const std::string &packet) { received_.push_back(packet); }
+  /**
+   * \brief Gets the packets that have been sent.
+   */
+  const std::vector<std::string> &getSent() const { return sent_; }
+
+ private:
+  std::vector<std::string> received_;
+  size_t next_;  // The index of the next packet to parse
+  std::string current_;
+  size_t position_;
+  std::vector<std::string> sent_;
+};
+
+}  // namespace test
+}  // namespace arduino_pixel
+
+#endif  // ARDUINO_PIXEL_HOST_MOCK_UDP_H
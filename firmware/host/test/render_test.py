@@ -0,0 +1,49 @@
+#!/usr/bin/python3
+
+"""Streams frames from arduino_pixel_render to arduino_pixel_devices.
+
+A number of servers on the loopback show the frames that a pool of threads
+renders for them, and every server has to show about as many frames as were
+sent to it.
+"""
+
+import re
+import signal
+import subprocess
+import sys
+
+DEVICES = 12
+
+
+def main():
+    if len(sys.argv) != 3: sys.exit('Usage: %s RENDER DEVICES' % sys.argv[0])
+    render, devices = sys.argv[1:]
+    servers = subprocess.Popen([devices, '-n', str(DEVICES), '-l', '60'],
+                               stdout=subprocess.PIPE,
+                               universal_newlines=True)
+    try:
+        ports = servers.stdout.readline().split()[1:]
+        command = [render, '-m', 'RAINBOW_CYCLE', '-n', '60', '-j', '4',
+                   '-t', '1']
+        for port in ports: command += ['-u', '127.0.0.1:' + port]
+        output = subprocess.check_output(command, universal_newlines=True,
+                                         timeout=30)
+        print(output.strip())
+    finally:
+        servers.send_signal(signal.SIGTERM)
+        shown = servers.communicate(timeout=10)[0]
+    print(shown.strip())
+    sent = int(re.search(r'(\d+) frames', output).group(1))
+    total, least = map(int, shown.split()[-2:])
+    # The rainbow changes on every frame, at 50 frames per second
+    if sent < 40 * DEVICES:
+        sys.exit('Error: Only %d frames were sent' % sent)
+    # A server may miss a frame that arrives with the next one
+    if least < 0.8 * sent / DEVICES:
+        sys.exit('Error: A server showed %d of %d frames' %
+                 (least, sent // DEVICES))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,161 @@
+/*! \file storage_test.cpp
+ *  \brief Tests the persistent state on a file.
+ *  \details A server saves its state to a StorageFile, and another server on
+ *  the same file, as after a power cycle, restores it.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+
+#include "arduino_pixel_server.h"
+#include "led_strip/led_strip_neopixel.h"
+#include "storage/storage_file.h"
+#include "test/mock_client.h"
+#include "test/test.h"
+
+using namespace arduino_pixel;
+
+namespace {
+
+const char *kPath = "storage_test.bin";
+
+class TestServer : public ArduinoPixelServer {
+ public:
+  using ArduinoPixelServer::init;
+
+  std::string request(const char *method, const char *path,
+                      const std::string &data = "") {
+    test::MockClient client(test::formatRequest(method, path, data));
+    processRequest(client);
+    CHECK(client.getOutput().find("200 OK") != std::string::npos);
+    return client.getBody();
+  }
+};
+
+long getFileSize() {
+  FILE *file = fopen(kPath, "rb");
+  if (not file) return -1;
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fclose(file);
+  return size;
+}
+
+void testStorage() {
+  storage::StorageFile storage(kPath, 64);
+  storage.init();
+  CHECK_EQUAL(storage.getSize(), 64u);
+  CHECK_EQUAL(storage.read(0), 0xFF);  // Erased, without a file
+  storage.write(3, 42);
+  CHECK_EQUAL(getFileSize(), -1);  // Nothing is written before the commit
+  storage.commit();
+  CHECK_EQUAL(getFileSize(), 64);
+
+  storage::StorageFile reopened(kPath, 128);
+  reopened.init();
+  CHECK_EQUAL(reopened.read(3), 42);
+  CHECK_EQUAL(reopened.read(100), 0xFF);  // Past the end of the file
+  remove(kPath);
+}
+
+void testPowerCycle() {
+  Clock::setTime(0);
+  {
+    led_strip::LedStripNeoPixel strip(30, 6, NEO_GRB + NEO_KHZ800);
+    storage::StorageFile storage(kPath);
+    storage.init();
+    StateStore store(storage);
+    TestServer server;
+    server.init(&strip, &store);
+    CHECK_EQUAL(server.request("GET", "/strip/status"), std::string("OFF"));
+
+    server.request("PUT", "/strip/status/on");
+    server.request("PUT", "/strip/mode", "GRADIENT_SCROLL 50");
+    server.request("PUT", "/strip/color",
+                   "{\"colors\":[{\"r\":1,\"g\":2,\"b\":3},"
+                   "{\"r\":4,\"g\":5,\"b\":6}],\"brightness\":100}");
+    server.colorize();
+    CHECK_EQUAL(getFileSize(), -1);  // The write is deferred
+    Clock::advance(5000);
+    server.colorize();
+    CHECK_EQUAL(getFileSize(), 512);
+  }
+
+  // The state is restored on init, before any request
+  led_strip::LedStripNeoPixel strip(30, 6, NEO_GRB + NEO_KHZ800);
+  storage::StorageFile storage(kPath);
+  storage.init();
+  StateStore store(storage);
+  TestServer server;
+  server.init(&strip, &store);
+  CHECK_EQUAL(server.request("GET", "/strip/status"), std::string("ON"));
+  CHECK_EQUAL(server.request("GET", "/strip/mode"),
+              std::string("GRADIENT_SCROLL"));
+  CHECK_EQUAL(server.request("GET", "/strip/color"),
+              std::string("{\"r\":1,\"g\":2,\"b\":3}"));
+  DeviceState state;
+  CHECK(store.load(state));
+  CHECK_EQUAL(state.period, 50u);
+  CHECK_EQUAL(state.brightness, 100);
+  CHECK_EQUAL(state.num_colors, 2);
+  CHECK_EQUAL(state.colors[1].blue, 6);
+  remove(kPath);
+}
+
+void testWearLeveling() {
+  storage::StorageFile storage(kPath);
+  storage.init();
+  StateStore store(storage, 0);
+  DeviceState state;
+  state.num_colors = 1;
+  for (int i = 0; i < 100; ++i) {
+    state.colors[0] = Color(i, 0, 0);
+    store.save(state);
+    store.flush();
+  }
+
+  // Every save goes to the next slot, so the records spread over the file
+  storage::StorageFile reopened(kPath);
+  reopened.init();
+  int written = 0;
+  for (size_t addr = 0; addr < reopened.getSize(); ++addr)
+    if (reopened.read(addr) != 0xFF) ++written;
+  CHECK(written > 400);
+  StateStore restored(reopened);
+  CHECK(restored.load(state));
+  CHECK_EQUAL(state.colors[0].red, 99);
+  remove(kPath);
+}
+
+}  // namespace
+
+int main() {
+  remove(kPath);
+  testStorage();
+  testPowerCycle();
+  testWearLeveling();
+  return TEST_RESULT();
+}
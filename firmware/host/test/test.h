@@ -0,0 +1,91 @@
+/*! \file test.h
+ *  \brief Checks of the tests of the host build.
+ *  \details A test is a program that runs its checks, prints the ones that
+ *  fail, and returns the number of failures, so ctest passes it when they all
+ *  hold.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#ifndef ARDUINO_PIXEL_HOST_TEST_H
+#define ARDUINO_PIXEL_HOST_TEST_H
+
+#include <stdio.h>
+
+#include <string>
+
+namespace arduino_pixel {
+namespace test {
+
+inline int &failures() {
+  static int count = 0;
+  return count;
+}
+
+inline bool check(bool condition, const char *expression, const char *file,
+                  int line) {
+  if (condition) return true;
+  fprintf(stderr, "%s:%d: Check failed: %s\n", file, line, expression);
+  ++failures();
+  return false;
+}
+
+// Describes a value of a failed check
+template <typename T>
+std::string describe(const T &value) {
+  return std::to_string((long long)value);
+}
+
+inline std::string describe(const std::string &value) {
+  return '"' + value + '"';
+}
+
+template <typename A, typename B>
+bool checkEqual(const A &actual, const B &expected, const char *expression,
+                const char *file, int line) {
+  if (actual == expected) return true;
+  fprintf(stderr, "%s:%d: Check failed: %s, %s != %s\n", file, line,
+          expression, describe(actual).c_str(), describe(expected).c_str());
+  ++failures();
+  return false;
+}
+
+}  // namespace test
+}  // namespace arduino_pixel
+
+// Checks that a condition holds
+#define CHECK(condition) \
+  ::arduino_pixel::test::check((condition), #condition, __FILE__, __LINE__)
+
+// Checks that an integer has the expected value
+#define CHECK_EQUAL(actual, expected)                                       \
+  ::arduino_pixel::test::checkEqual((actual), (expected),                   \
+                                    #actual " == " #expected, __FILE__,     \
+                                    __LINE__)
+
+// Returns the result of a test from main
+#define TEST_RESULT() (::arduino_pixel::test::failures() ? 1 : 0)
+
+#endif  // ARDUINO_PIXEL_HOST_TEST_H
@@ -0,0 +1,261 @@
+/*! \file benchmark.cpp
+ *  \brief Measures the throughput of the library on the host.
+ *  \details Every benchmark runs for a span of wall time and reports a rate,
+ *  e.g. the frames per second that a mode records on the virtual clock. The
+ *  rates of the host are far above those of a microcontroller, but their ratios
+ *  track the cost of the code.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <getopt.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <sys/wait.h>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "json_tokenizer.h"
+#include "led_strip/led_strip_apa102.h"
+#include "led_strip/led_strip_recording.h"
+#include "platform/led_strip_stream.h"
+#include "platform/mode_factory.h"
+#include "platform/render_pool.h"
+#include "platform/socket_udp.h"
+
+using namespace arduino_pixel;
+
+namespace {
+
+typedef std::chrono::steady_clock SteadyClock;
+
+/**
+ * \brief Print stream that drops the bytes.
+ */
+class NullPrint : public Print {
+ public:
+  virtual size_t write(uint8_t c) override { return 1; }
+  virtual size_t write(const uint8_t *buffer, size_t size) override {
+    return size;
+  }
+  using Print::write;
+};
+
+/**
+ * \brief Repeats a step for a span of wall time.
+ * \param[in] seconds the span.
+ * \param[in] step the step, which returns the units of work it did.
+ * \return The units of work per second.
+ */
+template <typename Step>
+double measure(double seconds, Step step) {
+  SteadyClock::time_point start = SteadyClock::now();
+  double elapsed = 0, units = 0;
+  do {
+    for (int i = 0; i < 64; ++i) units += step();
+    elapsed = std::chrono::duration<double>(SteadyClock::now() - start).count();
+  } while (elapsed < seconds);
+  return units / elapsed;
+}
+
+/**
+ * \brief Records a mode on the virtual clock.
+ * \details The clock moves by a period of the mode on every step, so every
+ * step renders and records a frame.
+ * \return The recorded frames per second.
+ */
+double recordMode(Mode type, double seconds) {
+  NullPrint output;
+  led_strip::LedStripRecording strip(30, output);
+  mode::ModeBase *mode = host::createMode(type, 30, 0);
+  Clock::setTime(0);
+  strip.init();
+  mode->init();
+  mode->setColor(Color(255, 128, 0));
+  strip.setMode(mode);
+  unsigned long period = mode->getPeriod();
+  double rate = measure(seconds, [&strip, period]() {
+    Clock::advance(period);
+    return strip.colorize() ? 1 : 0;
+  });
+  delete mode;
+  return rate;
+}
+
+/**
+ * \brief Shows RAINBOW_CYCLE on an APA102 strip, on a recording SPI bus.
+ * \details Every frame writes every LED, and sends the stream. On the
+ * device, the transfer is bound by the clock, e.g. 4 bytes per LED at 8 MHz
+ * take 4 us.
+ * \return The frames per second.
+ */
+double showApa102(int num_leds, double seconds) {
+  SPIClass bus;
+  led_strip::LedStripApa102<> strip(num_leds, 8000000, bus);
+  mode::RainbowCycle mode(num_leds, 10);
+  Clock::setTime(0);
+  mode.init();
+  strip.setMode(&mode);
+  return measure(seconds, [&strip, &bus]() {
+    Clock::advance(10);
+    bool shown = strip.colorize();
+    bus.clearSent();
+    return shown ? 1 : 0;
+  });
+}
+
+/**
+ * \brief Tokenizes a request body of PUT /strip/color.
+ * \return The bytes per second.
+ */
+double tokenize(const char *json, double seconds) {
+  uint16_t length = strlen(json);
+  JsonToken tokens[ARDUINO_PIXEL_JSON_TOKENS];
+  return measure(seconds, [json, length, &tokens]() {
+    JsonTokenizer tokenizer(json, length, tokens, ARDUINO_PIXEL_JSON_TOKENS);
+    return (tokenizer.tokenize() > 0) ? length : 0;
+  });
+}
+
+/**
+ * \brief Renders RAINBOW_CYCLE for devices on the loopback, on a pool of
+ * threads, as arduino_pixel_render does.
+ * \details The devices are UDP sockets, which a child process drains. Every
+ * frame is rendered in full and sent in a packet.
+ * \return The frames per second of all the devices.
+ */
+double renderDevices(int num_devices, int num_leds, int num_threads,
+                     double seconds) {
+  std::vector<std::unique_ptr<host::SocketUdp>> receivers;
+  std::vector<pollfd> sockets;
+  for (int i = 0; i < num_devices; ++i) {
+    receivers.emplace_back(new host::SocketUdp);
+    if (not receivers.back()->begin(0, true)) return 0;
+    sockets.push_back({receivers.back()->getSocket(), POLLIN, 0});
+  }
+  pid_t child = fork();
+  if (child < 0) return 0;
+  if (child == 0) {
+    for (;;) {
+      poll(sockets.data(), sockets.size(), -1);
+      for (size_t i = 0; i < sockets.size(); ++i)
+        if (sockets[i].revents & POLLIN) receivers[i]->parsePacket();
+    }
+  }
+
+  Clock::setTime(0);
+  std::vector<std::unique_ptr<host::SocketUdp>> senders;
+  std::vector<std::unique_ptr<host::LedStripStream>> strips;
+  std::vector<std::unique_ptr<mode::RainbowCycle>> modes;
+  host::RenderPool pool(num_threads);
+  for (int i = 0; i < num_devices; ++i) {
+    senders.emplace_back(new host::SocketUdp);
+    senders.back()->begin(0, true);
+    strips.emplace_back(new host::LedStripStream(
+        num_leds, *senders.back(), IPAddress(127, 0, 0, 1),
+        receivers[i]->getLocalPort()));
+    modes.emplace_back(new mode::RainbowCycle(num_leds, 10));
+    modes.back()->init();
+    strips.back()->setMode(modes.back().get());
+    pool.addStrip(strips.back().get());
+  }
+  double rate = measure(seconds, [&pool]() {
+    Clock::advance(10);
+    return pool.render(true);
+  });
+  kill(child, SIGKILL);
+  waitpid(child, nullptr, 0);
+  return rate;
+}
+
+struct Benchmark {
+  const char *name;
+  const char *unit;
+  double (*run)(double seconds);
+};
+
+const Benchmark benchmarks[] = {
+    {"record/SCANNER", "frames/s",
+     [](double seconds) { return recordMode(Mode::SCANNER, seconds); }},
+    {"record/RAINBOW", "frames/s",
+     [](double seconds) { return recordMode(Mode::RAINBOW, seconds); }},
+    {"record/RAINBOW_CYCLE", "frames/s",
+     [](double seconds) { return recordMode(Mode::RAINBOW_CYCLE, seconds); }},
+    {"apa102/60", "frames/s",
+     [](double seconds) { return showApa102(60, seconds); }},
+    {"apa102/300", "frames/s",
+     [](double seconds) { return showApa102(300, seconds); }},
+    {"apa102/1000", "frames/s",
+     [](double seconds) { return showApa102(1000, seconds); }},
+    {"render/48x300/1", "frames/s",
+     [](double seconds) { return renderDevices(48, 300, 1, seconds); }},
+    {"render/48x300/2", "frames/s",
+     [](double seconds) { return renderDevices(48, 300, 2, seconds); }},
+    {"render/48x300/4", "frames/s",
+     [](double seconds) { return renderDevices(48, 300, 4, seconds); }},
+    {"render/48x300/8", "frames/s",
+     [](double seconds) { return renderDevices(48, 300, 8, seconds); }},
+    {"json/color", "bytes/s",
+     [](double seconds) {
+       return tokenize("{\"r\":48,\"g\":254,\"b\":176}", seconds);
+     }},
+    {"json/colors", "bytes/s",
+     [](double seconds) {
+       return tokenize(
+           "{\"colors\":[{\"r\":255,\"g\":0,\"b\":0},"
+           "{\"r\":0,\"g\":255,\"b\":0},{\"r\":0,\"g\":0,\"b\":255},"
+           "{\"r\":255,\"g\":255,\"b\":255}],"
+           "\"period\":20,\"brightness\":128}",
+           seconds);
+     }},
+};
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  double seconds = 1.0;
+  for (int option; (option = getopt(argc, argv, "t:h")) != -1;) {
+    if (option != 't') {
+      fprintf(stderr,
+              "Usage: %s [-t SECONDS] [FILTER]\n"
+              "  -t SECONDS  the time of every benchmark (default 1)\n"
+              "  FILTER      runs the benchmarks whose name contains it\n",
+              argv[0]);
+      return 2;
+    }
+    seconds = atof(optarg);
+  }
+  const char *filter = (optind < argc) ? argv[optind] : "";
+
+  for (const Benchmark &benchmark : benchmarks) {
+    if (not strstr(benchmark.name, filter)) continue;
+    printf("%-32s %14.0f %s\n", benchmark.name, benchmark.run(seconds),
+           benchmark.unit);
+    fflush(stdout);
+  }
+  return 0;
+}
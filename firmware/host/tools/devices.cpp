@@ -0,0 +1,145 @@
+/*! \file devices.cpp
+ *  \brief Runs ArduinoPixel servers that show a stream, on the host.
+ *  \details Every server has a UDP socket on the loopback, and shows the frames
+ *  that are streamed to it, e.g. by arduino_pixel_render, so a number of
+ *  devices is simulated in a process. It prints the ports when it's ready, and
+ *  the frames that the servers have shown when it's stopped.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <getopt.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+
+#include <memory>
+#include <vector>
+
+#include "arduino_pixel_server.h"
+#include "led_strip/led_strip_neopixel.h"
+#include "platform/socket_udp.h"
+
+using namespace arduino_pixel;
+
+namespace {
+
+volatile sig_atomic_t stopped = 0;
+
+void stop(int) { stopped = 1; }
+
+class Device : public ArduinoPixelServer {
+ public:
+  explicit Device(int num_leds)
+      : strip_(num_leds, 6, NEO_GRB + NEO_KHZ800) {
+    init(&strip_);
+    DeviceState state;
+    state.power = true;
+    state.mode = Mode::STREAM;
+    setState(state);
+  }
+
+  host::SocketUdp &getUdp() { return udp_; }
+
+  unsigned long getFrames() const { return stats_.frames; }
+
+ private:
+  led_strip::LedStripNeoPixel strip_;
+  host::SocketUdp udp_;
+};
+
+void printUsage(const char *program) {
+  fprintf(stderr,
+          "Usage: %s [-n COUNT] [-l LEDS] [-p PORT]\n"
+          "  -n COUNT  the number of servers (default 8)\n"
+          "  -l LEDS   the number of LEDs of a server (default 30)\n"
+          "  -p PORT   the port of the first server, and the next ones "
+          "follow,\n"
+          "            or 0 for any free ports (default 0)\n",
+          program);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  int count = 8, num_leds = 30, port = 0;
+  for (int option; (option = getopt(argc, argv, "n:l:p:h")) != -1;) {
+    switch (option) {
+      case 'n':
+        count = atoi(optarg);
+        break;
+      case 'l':
+        num_leds = atoi(optarg);
+        break;
+      case 'p':
+        port = atoi(optarg);
+        break;
+      default:
+        printUsage(argv[0]);
+        return 2;
+    }
+  }
+  if (count <= 0 or num_leds <= 0 or port < 0) {
+    printUsage(argv[0]);
+    return 2;
+  }
+
+  std::vector<std::unique_ptr<Device>> devices;
+  std::vector<pollfd> sockets;
+  printf("ports");
+  for (int i = 0; i < count; ++i) {
+    devices.emplace_back(new Device(num_leds));
+    host::SocketUdp &udp = devices.back()->getUdp();
+    if (not udp.begin(port ? port + i : 0, true)) {
+      perror("Error: Can't open a socket");
+      return 1;
+    }
+    sockets.push_back({udp.getSocket(), POLLIN, 0});
+    printf(" %u", udp.getLocalPort());
+  }
+  printf("\n");
+  fflush(stdout);
+  signal(SIGINT, stop);
+  signal(SIGTERM, stop);
+
+  while (not stopped) {
+    poll(sockets.data(), sockets.size(), 1);
+    for (int i = 0; i < count; ++i) {
+      // processPacket takes a packet at a time, and the socket has a queue
+      if (sockets[i].revents & POLLIN)
+        for (int j = 0; j < 16; ++j)
+          devices[i]->processPacket(devices[i]->getUdp());
+      devices[i]->colorize();
+    }
+  }
+
+  unsigned long total = 0, least = devices[0]->getFrames();
+  for (const std::unique_ptr<Device> &device : devices) {
+    total += device->getFrames();
+    least = min(least, device->getFrames());
+  }
+  printf("frames %lu %lu\n", total, least);
+  return 0;
+}
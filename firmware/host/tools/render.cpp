@@ -0,0 +1,272 @@
+/*! \file render.cpp
+ *  \brief Renders a mode for many ArduinoPixel servers, and streams the frames.
+ *  \details The modes run on the host, on a pool of threads, and every frame is
+ *  sent to the STREAM mode of its server over UDP, so the servers only show the
+ *  frames. The frames of all the servers are rendered at the same time of the
+ *  clock, so they are in step.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <getopt.h>
+#include <netdb.h>
+#include <signal.h>
+#include <stdio.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "platform/led_strip_stream.h"
+#include "platform/mode_factory.h"
+#include "platform/render_pool.h"
+#include "platform/socket_udp.h"
+
+using namespace arduino_pixel;
+
+namespace {
+
+typedef std::chrono::steady_clock SteadyClock;
+
+const uint16_t kStreamPort = 7777;
+
+volatile sig_atomic_t stopped = 0;
+
+void stop(int) { stopped = 1; }
+
+struct Options {
+  Mode mode = Mode::INVALID;
+  int num_leds = 30;
+  unsigned long period = 0;
+  Color color = Color(255, 128, 0);
+  int max_leds = 480;
+};
+
+struct Device {
+  std::unique_ptr<host::SocketUdp> udp;
+  std::unique_ptr<host::LedStripStream> strip;
+  std::unique_ptr<mode::ModeBase> mode;
+};
+
+void printUsage(const char *program) {
+  fprintf(stderr,
+          "Usage: %s -m MODE (-u HOST[:PORT]... | -f FILE) [-n LEDS] "
+          "[-p PERIOD]\n"
+          "       [-c R,G,B] [-j THREADS] [-r FPS] [-t SECONDS] "
+          "[-l MAX_LEDS]\n"
+          "  -m MODE      the mode, e.g. RAINBOW_CYCLE\n"
+          "  -u HOST      a server, with the UDP port of its stream "
+          "(default %u)\n"
+          "  -f FILE      a file with a server per line, HOST[:PORT] "
+          "[MODE] [LEDS]\n"
+          "  -n LEDS      the number of LEDs (default 30)\n"
+          "  -p PERIOD    the period of the mode in ms (default of the "
+          "server)\n"
+          "  -c R,G,B     the color of the mode (default 255,128,0)\n"
+          "  -j THREADS   the number of threads (default the cores)\n"
+          "  -r FPS       the frames per second (default 50), or 0 to "
+          "render every\n"
+          "               frame in full, as fast as possible\n"
+          "  -t SECONDS   the time to run (default until interrupted)\n"
+          "  -l MAX_LEDS  the maximum number of pixels in a packet "
+          "(default 480)\n",
+          program, kStreamPort);
+}
+
+/**
+ * \brief Resolves an address, e.g. "192.168.1.10:7777" or "strip.local".
+ */
+bool parseAddress(const std::string &text, IPAddress &address,
+                  uint16_t &port) {
+  size_t colon = text.find(':');
+  port = (colon == std::string::npos) ? kStreamPort
+                                      : atoi(text.c_str() + colon + 1);
+  addrinfo hints = {};
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_DGRAM;
+  addrinfo *result;
+  if (not port or
+      getaddrinfo(text.substr(0, colon).c_str(), nullptr, &hints, &result))
+    return false;
+  uint32_t ip = ntohl(
+      reinterpret_cast<sockaddr_in *>(result->ai_addr)->sin_addr.s_addr);
+  freeaddrinfo(result);
+  address = IPAddress(ip >> 24, ip >> 16, ip >> 8, ip);
+  return true;
+}
+
+/**
+ * \brief Creates a device from a line of the form HOST[:PORT] [MODE] [LEDS],
+ * where the options give what's left out.
+ * \details The mode is created and initialized here, on the main thread.
+ */
+bool addDevice(const std::string &line, const Options &options,
+               std::vector<Device> &devices) {
+  char host[256], mode_name[32] = "";
+  int num_leds = options.num_leds;
+  if (sscanf(line.c_str(), "%255s %31s %d", host, mode_name, &num_leds) < 1)
+    return false;
+  Mode type = mode_name[0] ? host::parseMode(mode_name) : options.mode;
+  IPAddress address;
+  uint16_t port;
+  if (not parseAddress(host, address, port)) {
+    fprintf(stderr, "Error: Invalid address %s\n", host);
+    return false;
+  }
+  Device device;
+  device.udp.reset(new host::SocketUdp);
+  device.mode.reset(host::createMode(type, num_leds, options.period));
+  if (num_leds <= 0 or not device.mode or not device.udp->begin(0)) {
+    fprintf(stderr, "Error: Can't render the mode for %s\n", host);
+    return false;
+  }
+  device.strip.reset(new host::LedStripStream(num_leds, *device.udp, address,
+                                              port, options.max_leds));
+  device.mode->setColor(options.color);
+  device.mode->init();
+  device.strip->init();
+  device.strip->setMode(device.mode.get());
+  devices.push_back(std::move(device));
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  Options options;
+  std::vector<std::string> hosts;
+  const char *hosts_path = nullptr;
+  int num_threads = std::max(1u, std::thread::hardware_concurrency());
+  double fps = 50, seconds = 0;
+  unsigned int red, green, blue;
+  for (int option; (option = getopt(argc, argv, "m:u:f:n:p:c:j:r:t:l:h")) !=
+                   -1;) {
+    switch (option) {
+      case 'm':
+        options.mode = host::parseMode(optarg);
+        break;
+      case 'u':
+        hosts.push_back(optarg);
+        break;
+      case 'f':
+        hosts_path = optarg;
+        break;
+      case 'n':
+        options.num_leds = atoi(optarg);
+        break;
+      case 'p':
+        options.period = strtoul(optarg, nullptr, 10);
+        break;
+      case 'c':
+        if (sscanf(optarg, "%u,%u,%u", &red, &green, &blue) != 3 or
+            red > 255 or green > 255 or blue > 255) {
+          printUsage(argv[0]);
+          return 2;
+        }
+        options.color = Color(red, green, blue);
+        break;
+      case 'j':
+        num_threads = atoi(optarg);
+        break;
+      case 'r':
+        fps = atof(optarg);
+        break;
+      case 't':
+        seconds = atof(optarg);
+        break;
+      case 'l':
+        options.max_leds = atoi(optarg);
+        break;
+      default:
+        printUsage(argv[0]);
+        return 2;
+    }
+  }
+  if (hosts_path) {
+    FILE *file = fopen(hosts_path, "r");
+    if (not file) {
+      perror(hosts_path);
+      return 1;
+    }
+    char line[512];
+    while (fgets(line, sizeof(line), file)) {
+      std::string host(line);
+      size_t start = host.find_first_not_of(" \t\r\n");
+      if (start == std::string::npos or host[start] == '#') continue;
+      hosts.push_back(host.substr(start));
+    }
+    fclose(file);
+  }
+  if (hosts.empty() or num_threads <= 0 or fps < 0 or options.max_leds <= 0) {
+    printUsage(argv[0]);
+    return 2;
+  }
+
+  // The modes read the clock on the threads of the pool, so it's set here,
+  // between the frames
+  Clock::setTime(0);
+  std::vector<Device> devices;
+  for (const std::string &host : hosts)
+    if (not addDevice(host, options, devices)) return 1;
+  host::RenderPool pool(num_threads);
+  for (Device &device : devices) pool.addStrip(device.strip.get());
+  signal(SIGINT, stop);
+  signal(SIGTERM, stop);
+
+  // The first frame, and a frame every second, is rendered in full, so a
+  // server that has missed packets or has just started catches up
+  SteadyClock::time_point start = SteadyClock::now();
+  std::chrono::duration<double> interval(fps ? 1 / fps : 0);
+  unsigned long frames = 0, refresh_time = 0;
+  bool force = true;
+  for (unsigned long tick = 0; not stopped; ++tick) {
+    double elapsed =
+        std::chrono::duration<double>(SteadyClock::now() - start).count();
+    if (seconds and elapsed >= seconds) break;
+    if (fps) {
+      std::this_thread::sleep_until(
+          start + std::chrono::duration_cast<SteadyClock::duration>(
+                      interval * tick));
+      Clock::setTime(1000 * tick / fps);
+      force = force or Clock::millis() - refresh_time >= 1000;
+    } else {
+      Clock::advance(10);
+      force = true;
+    }
+    if (force) refresh_time = Clock::millis();
+    frames += pool.render(force);
+    force = false;
+  }
+
+  double elapsed =
+      std::chrono::duration<double>(SteadyClock::now() - start).count();
+  unsigned long packets = 0;
+  for (const Device &device : devices) packets += device.strip->getNumPackets();
+  printf("%zu devices, %d threads, %lu frames, %lu packets, %.0f frames/s\n",
+         devices.size(), pool.getNumThreads(), frames, packets,
+         frames / elapsed);
+  return 0;
+}
@@ -0,0 +1,148 @@
+/*! \file serve.cpp
+ *  \brief Runs an ArduinoPixel server on the host.
+ *  \details The server listens on a TCP port of the host, with a strip that
+ *  shows nothing, so that the clients, e.g. arduino_pixel_batch, can be tested
+ *  against it. It prints the port when it's ready, and the number of the
+ *  connections when it's stopped.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <getopt.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+
+#include "arduino_pixel_server.h"
+#include "led_strip/led_strip_neopixel.h"
+#include "platform/socket_client.h"
+
+using namespace arduino_pixel;
+
+namespace {
+
+volatile sig_atomic_t stopped = 0;
+
+void stop(int) { stopped = 1; }
+
+class HostServer : public ArduinoPixelServer {
+ public:
+  using ArduinoPixelServer::init;
+};
+
+void printUsage(const char *program) {
+  fprintf(stderr,
+          "Usage: %s [-a ADDRESS] [-p PORT] [-n LEDS]\n"
+          "  -a ADDRESS  the address to listen on (default 127.0.0.1)\n"
+          "  -p PORT     the port, or 0 for any free port (default 8080)\n"
+          "  -n LEDS     the number of LEDs (default 30)\n",
+          program);
+}
+
+/**
+ * \brief Opens a socket that listens on an address.
+ * \return The socket, or -1 on failure.
+ */
+int listenOn(const char *host, uint16_t &port) {
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  if (inet_pton(AF_INET, host, &address.sin_addr) != 1) return -1;
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) return -1;
+  int on = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+  socklen_t length = sizeof(address);
+  if (bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 or
+      listen(fd, 16) < 0 or
+      getsockname(fd, reinterpret_cast<sockaddr *>(&address), &length) < 0) {
+    close(fd);
+    return -1;
+  }
+  port = ntohs(address.sin_port);
+  return fd;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  const char *host = "127.0.0.1";
+  uint16_t port = 8080;
+  int num_leds = 30;
+  for (int option; (option = getopt(argc, argv, "a:p:n:h")) != -1;) {
+    switch (option) {
+      case 'a':
+        host = optarg;
+        break;
+      case 'p':
+        port = atoi(optarg);
+        break;
+      case 'n':
+        num_leds = atoi(optarg);
+        break;
+      default:
+        printUsage(argv[0]);
+        return 2;
+    }
+  }
+  if (num_leds <= 0) {
+    printUsage(argv[0]);
+    return 2;
+  }
+
+  int listener = listenOn(host, port);
+  if (listener < 0) {
+    perror("Error: Can't listen");
+    return 1;
+  }
+  signal(SIGINT, stop);
+  signal(SIGTERM, stop);
+
+  led_strip::LedStripNeoPixel strip(num_leds, 6, NEO_GRB + NEO_KHZ800);
+  HostServer server;
+  server.init(&strip);
+  printf("port %u\n", port);
+  fflush(stdout);
+
+  unsigned long connections = 0;
+  while (not stopped) {
+    pollfd listening = {listener, POLLIN, 0};
+    if (poll(&listening, 1, 1) > 0) {
+      int fd = accept(listener, nullptr, nullptr);
+      if (fd >= 0) {
+        ++connections;
+        host::SocketClient client(fd);
+        // As the servers of the Arduino, a client is handed over when its
+        // request has arrived
+        pollfd request = {fd, POLLIN, 0};
+        if (poll(&request, 1, 1000) > 0) server.processRequest(client);
+      }
+    }
+    server.colorize();
+  }
+  close(listener);
+  printf("connections %lu\n", connections);
+  return 0;
+}
@@ -0,0 +1,126 @@
+/*! \file simulate.cpp
+ *  \brief Records the frames of a mode on the virtual clock.
+ *  \details The mode is run on a LedStripRecording for a span of virtual time,
+ *  in steps of 1 ms, so it produces the same frames on every run and on every
+ *  machine. The recording is rendered or compared with
+ *  linux/cmd_line/arduino_pixel_replay.
+ *  \author Nick Lamprianidis
+ *  \version 2.2.0
+ *  \date 2017
+ *  \copyright The MIT License (MIT)
+ *  \par
+ *  Copyright (c) 2017 Nick Lamprianidis
+ *  \par
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  \par
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *  \par
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <getopt.h>
+#include <stdio.h>
+
+#include "led_strip/led_strip_recording.h"
+#include "platform/file_print.h"
+#include "platform/mode_factory.h"
+
+using namespace arduino_pixel;
+
+namespace {
+
+void printUsage(const char *program) {
+  fprintf(stderr,
+          "Usage: %s -m MODE -o FILE [-n LEDS] [-p PERIOD] [-c R,G,B] "
+          "[-d DURATION]\n"
+          "  -m MODE      the mode, e.g. SCANNER\n"
+          "  -o FILE      the recording\n"
+          "  -n LEDS      the number of LEDs (default 30)\n"
+          "  -p PERIOD    the period of the mode in ms (default of the "
+          "server)\n"
+          "  -c R,G,B     the color of the mode (default 255,128,0)\n"
+          "  -d DURATION  the virtual time to record in ms (default 2000)\n",
+          program);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  const char *mode_name = nullptr, *path = nullptr;
+  int num_leds = 30;
+  unsigned long period = 0, duration = 2000;
+  unsigned int red = 255, green = 128, blue = 0;
+  for (int option; (option = getopt(argc, argv, "m:o:n:p:c:d:h")) != -1;) {
+    switch (option) {
+      case 'm':
+        mode_name = optarg;
+        break;
+      case 'o':
+        path = optarg;
+        break;
+      case 'n':
+        num_leds = atoi(optarg);
+        break;
+      case 'p':
+        period = strtoul(optarg, nullptr, 10);
+        break;
+      case 'c':
+        if (sscanf(optarg, "%u,%u,%u", &red, &green, &blue) != 3 or
+            red > 255 or green > 255 or blue > 255) {
+          fprintf(stderr, "Error: Invalid color %s\n", optarg);
+          return 2;
+        }
+        break;
+      case 'd':
+        duration = strtoul(optarg, nullptr, 10);
+        break;
+      default:
+        printUsage(argv[0]);
+        return 2;
+    }
+  }
+  if (not mode_name or not path or num_leds <= 0 or num_leds > 0xFFFF) {
+    printUsage(argv[0]);
+    return 2;
+  }
+
+  mode::ModeBase *mode =
+      host::createMode(host::parseMode(mode_name), num_leds, period);
+  if (not mode) {
+    fprintf(stderr, "Error: Can't simulate mode %s\n", mode_name);
+    return 2;
+  }
+  host::FilePrint output(path);
+  if (not output.isOpen()) {
+    fprintf(stderr, "Error: Can't open %s\n", path);
+    return 1;
+  }
+
+  led_strip::LedStripRecording strip(num_leds, output);
+  Clock::setTime(0);
+  strip.init();
+  mode->init();
+  mode->setColor(Color(red, green, blue));
+  strip.setMode(mode);
+  strip.colorize(true);
+  while (Clock::millis() < duration) {
+    Clock::advance(1);
+    strip.colorize();
+  }
+  printf("%lu frames of %s in %lu ms\n", strip.getNumFrames(), mode_name,
+         duration);
+  delete mode;
+  return 0;
+}